@@ -64,6 +64,32 @@
 #define JACK_PLAYBACK_MONITOR_PORT_2 "mod-monitor:out_2"
 #endif
 
+#ifndef MAX_SPARE_PLUGIN_INSTANCES
+#define MAX_SPARE_PLUGIN_INSTANCES NUM_BLOCKS_PER_PRESET
+#endif
+
+#ifndef DEFERRED_WORK_IDLE_MS
+#define DEFERRED_WORK_IDLE_MS 100
+#endif
+
+#ifndef DEFERRED_WORK_SLICE_MS
+#define DEFERRED_WORK_SLICE_MS 5
+#endif
+
+#ifndef PRESET_SWITCH_CROSSFADE_MS
+#define PRESET_SWITCH_CROSSFADE_MS 50
+#endif
+
+#ifndef PRESET_SWITCH_SPILLOVER_MS
+#define PRESET_SWITCH_SPILLOVER_MS 0
+#endif
+
+// set to 1 for a second range of mod-host instances, used for preparing the next bank while the current one plays
+// this doubles the amount of mod-host instances that can be in use, see prepareBankFromPresetFiles
+#ifndef PREPARED_BANK_INSTANCES
+#define PREPARED_BANK_INSTANCES 0
+#endif
+
 #define UUID_SIZE 28
 
 // --------------------------------------------------------------------------------------------------------------------
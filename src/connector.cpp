@@ -9,9 +9,12 @@
 
 #include "kxstudio-lv2-extensions/kx-properties.lv2/props.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
 
 #ifdef _WIN32
 #include <shlobj.h>
@@ -28,6 +31,9 @@
 #define JSON_PRESET_VERSION_MIN_SUPPORTED 1
 #define JSON_PRESET_VERSION_MAX_SUPPORTED 1
 
+#define JSON_PRESET_LIBRARY_VERSION 1
+#define PRESET_LIBRARY_INDEX_FILENAME "preset-library.json"
+
 #ifdef BINDING_ACTUATOR_IDS
 static constexpr const char* kBindingActuatorIDs[NUM_BINDING_ACTUATORS] = { BINDING_ACTUATOR_IDS };
 #endif
@@ -84,6 +90,22 @@ static const char* getHomeDir()
 }
 #endif
 
+// connector cache directory, can be overridden with MOD_CONNECTOR_CACHE_PATH (empty value disables it)
+static std::string getCacheDir()
+{
+    if (const char* const envcache = getenv("MOD_CONNECTOR_CACHE_PATH"))
+        return envcache;
+
+  #if defined(_WIN32)
+    WCHAR wpath[MAX_PATH] = {};
+    if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, SHGFP_TYPE_CURRENT, wpath) == S_OK)
+        return format("%ls\\mod-connector", wpath);
+    return {};
+  #else
+    return format("%s/.cache/mod-connector", getHomeDir());
+  #endif
+}
+
 static std::string getDefaultPluginBundleForBlock(const HostBlock& blockdata)
 {
   #if defined(_WIN32)
@@ -347,6 +369,65 @@ static bool shouldBlockBeStereo(const HostConnector::ChainRow& chaindata, const
 
 // --------------------------------------------------------------------------------------------------------------------
 
+static bool isSameLv2PortList(const std::vector<Lv2Port>& ports1, const std::vector<Lv2Port>& ports2)
+{
+    if (ports1.size() != ports2.size())
+        return false;
+
+    for (size_t i = 0; i < ports1.size(); ++i)
+    {
+        const Lv2Port& port1(ports1[i]);
+        const Lv2Port& port2(ports2[i]);
+
+        if (port1.symbol != port2.symbol ||
+            port1.name != port2.name ||
+            port1.shortname != port2.shortname ||
+            port1.flags != port2.flags ||
+            port1.designation != port2.designation ||
+            isNotEqual(port1.def, port2.def) ||
+            isNotEqual(port1.min, port2.min) ||
+            isNotEqual(port1.max, port2.max) ||
+            port1.unit != port2.unit ||
+            port1.scalePoints.size() != port2.scalePoints.size())
+            return false;
+
+        for (size_t j = 0; j < port1.scalePoints.size(); ++j)
+        {
+            if (port1.scalePoints[j].label != port2.scalePoints[j].label ||
+                isNotEqual(port1.scalePoints[j].value, port2.scalePoints[j].value))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static void getAllMappedInstances(const HostInstanceMapper& mapper, std::vector<int16_t>& instances)
+{
+    for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
+    {
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+        {
+            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+            {
+                const HostBlockPair hbp = mapper.get(pr, row, bl);
+
+                if (hbp.id == kMaxHostInstances)
+                    continue;
+
+                instances.push_back(hbp.id);
+
+                if (hbp.pair != kMaxHostInstances)
+                    instances.push_back(hbp.pair);
+            }
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 static bool loadPresetFromFile(const char* const filename, nlohmann::json& j)
 {
     std::ifstream f(filename);
@@ -405,22 +486,252 @@ static bool loadPresetFromFile(const char* const filename, nlohmann::json& j)
 
 static bool safeJsonSave(const nlohmann::json& json, const std::string& filename)
 {
-    if (FILE* const fd = std::fopen((filename + ".tmp").c_str(), "w"))
+    return safeFileSave(filename, json.dump(2, ' ', false, nlohmann::detail::error_handler_t::replace));
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static int64_t getFileModTime(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+}
+
+static bool isPresetLibraryFile(const std::filesystem::directory_entry& entry)
+{
+    std::error_code ec;
+    if (! entry.is_regular_file(ec))
+        return false;
+
+    return entry.path().extension() == ".json";
+}
+
+static void jsonPresetToLibraryEntry(HostPresetLibraryEntry& entry, const nlohmann::json& jpreset)
+{
+    entry.name.clear();
+    entry.uuid.clear();
+    entry.uris.clear();
+
+    for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+        entry.sceneNames[s].clear();
+
+    try {
+        if (jpreset.contains("name"))
+            entry.name = jpreset["name"].get<std::string>();
+    } catch (...) {}
+
+    try {
+        if (jpreset.contains("uuid"))
+            entry.uuid = jpreset["uuid"].get<std::string>();
+    } catch (...) {}
+
+    if (jpreset.contains("chains"))
     {
-        const std::string jsonstr = json.dump(2, ' ', false, nlohmann::detail::error_handler_t::replace);
+        const auto& jchains = jpreset["chains"];
 
-        std::fwrite(jsonstr.c_str(), 1, jsonstr.length(), fd);
-        std::fflush(fd);
-       #ifndef _WIN32
-        fsync(fileno(fd));
-        // syncfs(fileno(fd));
-       #endif
-        std::fclose(fd);
-        std::rename((filename + ".tmp").c_str(), filename.c_str());
-        return true;
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+        {
+            const std::string jrowid = std::to_string(row + 1);
+            if (! jchains.contains(jrowid) || ! jchains[jrowid].contains("blocks"))
+                continue;
+
+            const auto& jblocks = jchains[jrowid]["blocks"];
+
+            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+            {
+                const std::string jblockid = std::to_string(bl + 1);
+                if (! jblocks.contains(jblockid) || ! jblocks[jblockid].contains("uri"))
+                    continue;
+
+                std::string uri;
+                try {
+                    uri = jblocks[jblockid]["uri"].get<std::string>();
+                } catch (...) {
+                    continue;
+                }
+
+                if (isNullURI(uri))
+                    continue;
+                if (std::find(entry.uris.begin(), entry.uris.end(), uri) == entry.uris.end())
+                    entry.uris.push_back(uri);
+            }
+        }
     }
 
-    return false;
+    if (jpreset.contains("sceneNames"))
+    {
+        const auto& jsceneNames = jpreset["sceneNames"];
+
+        for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+        {
+            const std::string jsceneid = std::to_string(s + 1);
+
+            try {
+                if (jsceneNames.contains(jsceneid))
+                    entry.sceneNames[s] = jsceneNames[jsceneid].get<std::string>();
+            } catch (...) {}
+        }
+    }
+}
+
+static bool jsonPresetLibraryEntryLoad(HostPresetLibraryEntry& entry, const nlohmann::json& jentry)
+{
+    try {
+        entry.mtime = jentry["mtime"].get<int64_t>();
+        entry.name = jentry["name"].get<std::string>();
+        entry.uuid = jentry["uuid"].get<std::string>();
+        entry.uris = jentry["uris"].get<std::vector<std::string>>();
+
+        const auto& jsceneNames = jentry["sceneNames"];
+        for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+            entry.sceneNames[s] = s < jsceneNames.size() ? jsceneNames[s].get<std::string>() : std::string();
+    } catch (...) {
+        return false;
+    }
+
+    return true;
+}
+
+static nlohmann::json jsonPresetLibraryEntrySave(const HostPresetLibraryEntry& entry)
+{
+    return nlohmann::json::object({
+        { "mtime", entry.mtime },
+        { "name", entry.name },
+        { "sceneNames", entry.sceneNames },
+        { "uris", entry.uris },
+        { "uuid", entry.uuid },
+    });
+}
+
+// preset library index, shared by all preset directories and keyed by absolute preset file path
+// kept in memory and only read again from disk if the index file was modified by someone else
+static struct PresetLibraryIndex {
+    std::mutex mutex;
+    std::string filename;
+    int64_t mtime = 0;
+    bool loaded = false;
+    nlohmann::json jpresets;
+} sPresetLibraryIndex;
+
+static std::string getPresetLibraryKey(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::path abspath = std::filesystem::absolute(path, ec);
+    if (ec)
+        abspath = path;
+
+    abspath = abspath.lexically_normal();
+
+    // directories given with a trailing separator
+    if (! abspath.has_filename())
+        abspath = abspath.parent_path();
+
+    return abspath.string();
+}
+
+// index mutex must be locked
+static void loadPresetLibraryIndex(PresetLibraryIndex& index)
+{
+    if (! index.loaded)
+    {
+        const std::string cachedir = getCacheDir();
+        if (! cachedir.empty())
+            index.filename = (std::filesystem::path(cachedir) / PRESET_LIBRARY_INDEX_FILENAME).string();
+    }
+    else if (index.filename.empty() || getFileModTime(index.filename) == index.mtime)
+    {
+        return;
+    }
+
+    index.loaded = true;
+    index.jpresets = nlohmann::json::object({});
+
+    if (index.filename.empty())
+        return;
+
+    index.mtime = getFileModTime(index.filename);
+
+    std::ifstream f(index.filename);
+    if (f.fail())
+        return;
+
+    try {
+        const nlohmann::json j = nlohmann::json::parse(f);
+
+        if (j["type"].get<std::string>() != "preset-index")
+            return;
+        if (j["version"].get<int>() != JSON_PRESET_LIBRARY_VERSION)
+            return;
+
+        index.jpresets = j["presets"].get<nlohmann::json>();
+    } catch (...) {
+        mod_log_warn("failed to parse preset library index \"%s\", rebuilding", index.filename.c_str());
+        index.jpresets = nlohmann::json::object({});
+    }
+}
+
+// index mutex must be locked
+static void savePresetLibraryIndex(PresetLibraryIndex& index)
+{
+    if (index.filename.empty())
+        return;
+
+    const nlohmann::json j = nlohmann::json::object({
+        { "type", "preset-index" },
+        { "version", JSON_PRESET_LIBRARY_VERSION },
+        { "presets", index.jpresets },
+    });
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(index.filename).parent_path(), ec);
+
+    if (! safeJsonSave(j, index.filename))
+        mod_log_warn("failed to save preset library index \"%s\"", index.filename.c_str());
+
+    index.mtime = getFileModTime(index.filename);
+}
+
+// fetch entry from index if mtime matches, otherwise parse the preset file and update the index
+// returns false if the file is not a valid preset, in which case it is also removed from the index
+static bool updatePresetLibraryEntry(const std::filesystem::path& path,
+                                     nlohmann::json& jpresets,
+                                     HostPresetLibraryEntry& entry,
+                                     bool& indexChanged)
+{
+    const std::string key = getPresetLibraryKey(path);
+
+    entry.filename = path.string();
+    entry.mtime = getFileModTime(path);
+
+    const auto jit = jpresets.find(key);
+    if (jit != jpresets.end())
+    {
+        HostPresetLibraryEntry cached;
+        if (jsonPresetLibraryEntryLoad(cached, *jit) && cached.mtime == entry.mtime)
+        {
+            cached.filename = entry.filename;
+            entry = std::move(cached);
+            return true;
+        }
+    }
+
+    nlohmann::json j;
+    if (! loadPresetFromFile(entry.filename.c_str(), j))
+    {
+        if (jit != jpresets.end())
+        {
+            jpresets.erase(jit);
+            indexChanged = true;
+        }
+        return false;
+    }
+
+    jsonPresetToLibraryEntry(entry, j);
+
+    jpresets[key] = jsonPresetLibraryEntrySave(entry);
+    indexChanged = true;
+    return true;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -431,11 +742,16 @@ HostConnector::HostConnector()
     {
         allocPreset(_presets[p]);
         resetPreset(_presets[p]);
+        allocPreset(_nextBank.presets[p]);
+        resetPreset(_nextBank.presets[p]);
     }
 
     allocPreset(_current);
     resetPreset(_current);
 
+    // extract plugin metadata in the background, so first use of a plugin does not stall
+    _lv2world.prewarm();
+
     ok = _host.last_error.empty();
 }
 
@@ -443,7 +759,10 @@ HostConnector::HostConnector()
 
 bool HostConnector::reconnect()
 {
-    ok = _host.reconnect();
+    if (ok && ! _host.connection_lost())
+        return true;
+
+    ok = _host.reconnect() && hostResync();
     return ok;
 }
 
@@ -519,6 +838,10 @@ void HostConnector::printStateForDebug(const bool withBlocks, const bool withPar
     fprintf(stderr, "\tFilename: %s\n", _current.filename.c_str());
     fprintf(stderr, "\tName: %s\n", _current.name.c_str());
 
+    const Host::SkippedMessages skipped = _host.skipped_messages();
+    fprintf(stderr, "\tSkipped host messages: activate %u, bypass %u, param_set %u, patch_set %u\n",
+            skipped.activate, skipped.bypass, skipped.param_set, skipped.patch_set);
+
     for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS && (withBlocks || withParams); ++row)
     {
        #if NUM_BLOCK_CHAIN_ROWS != 1
@@ -744,36 +1067,12 @@ bool HostConnector::setJackPorts(const std::array<std::string, 2>& capture, cons
             presetdata.chains[0].capture = capture;
             presetdata.chains[0].playback = playback;
         }
-        return true;
-    }
-
-    // first first and last blocks
-    uint8_t firstBlock = UINT8_MAX;
-    uint8_t lastBlock = UINT8_MAX;
-
-    // disconnect old chain endpoints
-    if (_current.numLoadedPlugins == 0)
-    {
-        hostDisconnectChainEndpoints(0);
-    }
-    else
-    {
-        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        for (Preset& presetdata : _nextBank.presets)
         {
-            if (!isNullBlock(chaindata.blocks[bl]))
-            {
-                if (firstBlock == UINT8_MAX)
-                    firstBlock = bl;
-
-                lastBlock = bl;
-            }
+            presetdata.chains[0].capture = capture;
+            presetdata.chains[0].playback = playback;
         }
-
-        assert(firstBlock != UINT8_MAX);
-        assert(lastBlock != UINT8_MAX);
-
-        hostDisconnectAllBlockInputs(0, firstBlock);
-        hostDisconnectAllBlockOutputs(0, lastBlock);
+        return true;
     }
 
 #if MONITOR_AUDIO_LEVELS
@@ -797,18 +1096,15 @@ bool HostConnector::setJackPorts(const std::array<std::string, 2>& capture, cons
         presetdata.chains[0].capture = capture;
         presetdata.chains[0].playback = playback;
     }
-
-    // reconnect endpoints again
-    if (_current.numLoadedPlugins == 0)
-    {
-        hostConnectChainEndpoints(0);
-    }
-    else
+    for (Preset& presetdata : _nextBank.presets)
     {
-        hostConnectBlockToChainInput(0, firstBlock);
-        hostConnectBlockToChainOutput(0, lastBlock);
+        presetdata.chains[0].capture = capture;
+        presetdata.chains[0].playback = playback;
     }
 
+    // replace old endpoint connections with new ones
+    hostUpdateConnections();
+
 #if MONITOR_AUDIO_LEVELS
     // monitor new ports
     _host.monitor_audio_levels(capture[0].c_str(), true);
@@ -833,9 +1129,35 @@ void HostConnector::loadBankFromPresetFiles(const std::array<std::string, NUM_PR
     assert(initialPresetToLoad < NUM_PRESETS_PER_BANK);
     mod_log_debug("loadBankFromPresetFiles(..., %u)", initialPresetToLoad);
 
+    // the first bank load always goes through the full path, which clears leftover mod-host state
+    if (_nextBank.ready && ! _firstboot)
+    {
+        bool prepared = true;
+        for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK && prepared; ++pr)
+            prepared = _nextBank.presets[pr].filename == filenames[pr];
+
+        if (prepared)
+        {
+            _bankLoadStart = std::chrono::steady_clock::now();
+            _bankLoadTimings = {};
+
+            hostSwitchToPreparedBank(initialPresetToLoad);
+
+            // all presets were preloaded already, fullyLoaded must not be 0 as that means still in progress
+            _bankLoadTimings.firstSound = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - _bankLoadStart).count();
+            _bankLoadTimings.fullyLoaded = std::max(_bankLoadTimings.firstSound, 1u);
+
+            mod_log_info("loadBankFromPresetFiles: switched to prepared bank after %u ms",
+                         _bankLoadTimings.firstSound);
+            return;
+        }
+    }
+
+    // parse into the prepared bank storage, previous bank data is still needed for reusing its instances
     for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
     {
-        Preset& presetdata = _presets[pr];
+        Preset& presetdata = _nextBank.presets[pr];
 
         nlohmann::json j;
         if (loadPresetFromFile(filenames[pr].c_str(), j))
@@ -844,46 +1166,213 @@ void HostConnector::loadBankFromPresetFiles(const std::array<std::string, NUM_PR
             resetPreset(presetdata);
 
         presetdata.filename = filenames[pr];
+        _nextBank.presetsAsLoaded[pr] = true;
     }
 
-    // create current preset data from selected initial preset
-    static_cast<Preset&>(_current) = _presets[initialPresetToLoad];
-    _current.preset = initialPresetToLoad;
-    _current.defaultScene = _current.scene;
+    _bankLoadStart = std::chrono::steady_clock::now();
+    _bankLoadTimings = {};
 
-    const Host::NonBlockingScope hnbs(_host);
-    hostClearAndLoadCurrentBank();
+    {
+        const Host::NonBlockingScope hnbs(_host);
+        hostClearAndLoadCurrentBank(initialPresetToLoad);
+    }
+
+    // leaving non-blocking scope waits for all replies, so the initial preset is audible at this point
+    _bankLoadTimings.firstSound = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _bankLoadStart).count();
+
+    mod_log_info("loadBankFromPresetFiles: initial preset audible after %u ms", _bankLoadTimings.firstSound);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-std::string HostConnector::getPresetNameFromFile(const char* const filename)
+bool HostConnector::prepareBankFromPresetFiles(const std::array<std::string, NUM_PRESETS_PER_BANK>& filenames)
 {
-    mod_log_debug("getPresetNameFromFile(\"%s\")", filename);
-
-    nlohmann::json j;
-    if (! loadPresetFromFile(filename, j))
-        return {};
-
-    try {
-        return j["name"].get<std::string>();
-    } catch (...) {}
+    mod_log_debug("prepareBankFromPresetFiles(...)");
 
-    return {};
-}
+   #if ! PREPARED_BANK_INSTANCES
+    mod_log_warn("prepareBankFromPresetFiles(...): failed, no instance range reserved for prepared banks");
+    (void)filenames;
+    return false;
+   #else
+    if (_firstboot)
+    {
+        mod_log_warn("prepareBankFromPresetFiles(...): failed, no bank loaded yet");
+        return false;
+    }
 
-// --------------------------------------------------------------------------------------------------------------------
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-bool HostConnector::loadCurrentPresetFromFile(const char* const filename, const bool replaceDefault)
-{
-    mod_log_debug("loadCurrentPresetFromFile(\"%s\")", filename);
+    const Host::NonBlockingScope hnbs(_host);
 
-    const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+    // the spare instance range must be free first
+    hostDropPreparedBank();
 
-    // unload old preset plugins
-    if (_current.numLoadedPlugins != 0)
+    for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
     {
-        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+        Preset& presetdata = _nextBank.presets[pr];
+
+        nlohmann::json j;
+        if (loadPresetFromFile(filenames[pr].c_str(), j))
+            jsonPresetLoad(presetdata, j);
+        else
+            resetPreset(presetdata);
+
+        presetdata.filename = filenames[pr];
+        _nextBank.presetsAsLoaded[pr] = true;
+    }
+
+    // preload as inactive presets, reusing the regular preset loading on top of the spare instance range
+    swapPreparedBank();
+
+    const uint8_t activePreset = _current.preset;
+    _current.preset = NUM_PRESETS_PER_BANK;
+
+    for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
+        hostLoadPreset(pr);
+
+    _current.preset = activePreset;
+
+    swapPreparedBank();
+
+    _nextBank.ready = true;
+
+    mod_log_info("prepareBankFromPresetFiles: bank preloaded after %u ms",
+                 static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start).count()));
+
+    return true;
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+std::string HostConnector::getPresetNameFromFile(const char* const filename)
+{
+    mod_log_debug("getPresetNameFromFile(\"%s\")", filename);
+
+    // use the library index if the file did not change since it was indexed
+    {
+        const std::filesystem::path path(filename);
+        const std::lock_guard<std::mutex> lock(sPresetLibraryIndex.mutex);
+        loadPresetLibraryIndex(sPresetLibraryIndex);
+
+        const auto jit = sPresetLibraryIndex.jpresets.find(getPresetLibraryKey(path));
+        if (jit != sPresetLibraryIndex.jpresets.end())
+        {
+            try {
+                if ((*jit)["mtime"].get<int64_t>() == getFileModTime(path))
+                    return (*jit)["name"].get<std::string>();
+            } catch (...) {}
+        }
+    }
+
+    nlohmann::json j;
+    if (! loadPresetFromFile(filename, j))
+        return {};
+
+    try {
+        return j["name"].get<std::string>();
+    } catch (...) {}
+
+    return {};
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+std::vector<HostConnector::PresetLibraryEntry> HostConnector::getPresetLibrary(const char* const dirpath)
+{
+    mod_log_debug("getPresetLibrary(\"%s\")", dirpath);
+
+    std::vector<PresetLibraryEntry> entries;
+
+    std::error_code ec;
+    std::filesystem::directory_iterator it(dirpath, ec);
+    if (ec)
+        return entries;
+
+    const std::lock_guard<std::mutex> lock(sPresetLibraryIndex.mutex);
+    loadPresetLibraryIndex(sPresetLibraryIndex);
+
+    nlohmann::json& jpresets = sPresetLibraryIndex.jpresets;
+    bool indexChanged = false;
+    std::set<std::string> found;
+
+    for (const std::filesystem::directory_entry& dirEntry : it)
+    {
+        if (! isPresetLibraryFile(dirEntry))
+            continue;
+
+        PresetLibraryEntry entry;
+        if (! updatePresetLibraryEntry(dirEntry.path(), jpresets, entry, indexChanged))
+            continue;
+
+        found.insert(getPresetLibraryKey(dirEntry.path()));
+        entries.push_back(std::move(entry));
+    }
+
+    // drop files from this directory that no longer exist
+    const std::filesystem::path dirkey(getPresetLibraryKey(dirpath));
+
+    for (auto jit = jpresets.begin(); jit != jpresets.end();)
+    {
+        if (std::filesystem::path(jit.key()).parent_path() == dirkey && found.find(jit.key()) == found.end())
+        {
+            jit = jpresets.erase(jit);
+            indexChanged = true;
+        }
+        else
+        {
+            ++jit;
+        }
+    }
+
+    if (indexChanged)
+        savePresetLibraryIndex(sPresetLibraryIndex);
+
+    std::sort(entries.begin(), entries.end(), [](const PresetLibraryEntry& a, const PresetLibraryEntry& b) {
+        return a.filename < b.filename;
+    });
+
+    return entries;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::getPresetLibraryEntry(const char* const filename, PresetLibraryEntry& entry)
+{
+    mod_log_debug("getPresetLibraryEntry(\"%s\")", filename);
+
+    const std::filesystem::path path(filename);
+
+    std::error_code ec;
+    if (! isPresetLibraryFile(std::filesystem::directory_entry(path, ec)))
+        return false;
+
+    const std::lock_guard<std::mutex> lock(sPresetLibraryIndex.mutex);
+    loadPresetLibraryIndex(sPresetLibraryIndex);
+
+    bool indexChanged = false;
+    const bool ok = updatePresetLibraryEntry(path, sPresetLibraryIndex.jpresets, entry, indexChanged);
+
+    if (indexChanged)
+        savePresetLibraryIndex(sPresetLibraryIndex);
+
+    return ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::loadCurrentPresetFromFile(const char* const filename, const bool replaceDefault)
+{
+    mod_log_debug("loadCurrentPresetFromFile(\"%s\")", filename);
+
+    const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+
+    // unload old preset plugins
+    if (_current.numLoadedPlugins != 0)
+    {
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
         {
             for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
             {
@@ -897,10 +1386,6 @@ bool HostConnector::loadCurrentPresetFromFile(const char* const filename, const
 
         _current.numLoadedPlugins = 0;
     }
-    else
-    {
-        hostDisconnectChainEndpoints(0);
-    }
 
     // load new preset data
     {
@@ -915,7 +1400,10 @@ bool HostConnector::loadCurrentPresetFromFile(const char* const filename, const
     _current.filename = filename;
 
     if (replaceDefault)
+    {
         _presets[_current.preset] = _current;
+        _presetsAsLoaded[_current.preset] = true;
+    }
 
     // load new preset
     hostLoadPreset(_current.preset);
@@ -946,27 +1434,31 @@ bool HostConnector::preloadPresetFromFile(const uint8_t preset, const char* cons
 
     presetdata.filename = filename;
 
-    // unload old preset
-    {
-        const Preset& oldpreset = _presets[preset];
+    // any deferred work for the old preset is now irrelevant
+    _deferredWork[preset].type = DeferredPresetWork::kNone;
+    _deferredWork[preset].prev.reset();
 
+    // unload old preset, mapped instances might not match its data if it was not restored or loaded yet
+    {
         const Host::NonBlockingScope hnbs(_host);
 
+        hostEndSpillover(preset);
+
         for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
         {
             for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
             {
-                if (isNullBlock(oldpreset.chains[row].blocks[bl]))
+                if (_mapper.get(preset, row, bl).id == kMaxHostInstances)
                     continue;
 
-                if (const HostBlockPair hbp = _mapper.remove(preset, row, bl); hbp.id != kMaxHostInstances)
-                    hostRemoveBlockPair(hbp);
+                hostRemoveBlockPair(_mapper.remove(preset, row, bl));
             }
         }
     }
 
     // assign and preload new preset
     _presets[preset] = presetdata;
+    _presetsAsLoaded[preset] = true;
 
     {
         const Host::NonBlockingScope hnbs(_host);
@@ -1074,7 +1566,9 @@ bool HostConnector::saveCurrentPresetToFile(const char* const filename)
     }
 
     // copy current data into preset data
+    // values not saved to presets are copied too, so it no longer matches its file
     _presets[_current.preset] = static_cast<Preset&>(_current);
+    _presetsAsLoaded[_current.preset] = false;
 
     jsonPresetSave(_current, j["preset"]);
 
@@ -1111,6 +1605,8 @@ bool HostConnector::reorderPresets(const uint8_t orig, const uint8_t dest)
         for (int i = orig; i > dest; --i)
         {
             std::swap(_presets[i], _presets[i - 1]);
+            std::swap(_presetsAsLoaded[i], _presetsAsLoaded[i - 1]);
+            std::swap(_deferredWork[i], _deferredWork[i - 1]);
             _mapper.swapPresets(i, i - 1);
 
             // swap filenames again for keeping the originals
@@ -1127,6 +1623,8 @@ bool HostConnector::reorderPresets(const uint8_t orig, const uint8_t dest)
         for (int i = orig; i < dest; ++i)
         {
             std::swap(_presets[i], _presets[i + 1]);
+            std::swap(_presetsAsLoaded[i], _presetsAsLoaded[i + 1]);
+            std::swap(_deferredWork[i], _deferredWork[i + 1]);
             _mapper.swapPresets(i, i + 1);
 
             // swap filenames again for keeping the originals
@@ -1169,6 +1667,8 @@ void HostConnector::swapPresets(const uint8_t presetA, const uint8_t presetB)
 
     // swap data first
     std::swap(_presets[presetA], _presets[presetB]);
+    std::swap(_presetsAsLoaded[presetA], _presetsAsLoaded[presetB]);
+    std::swap(_deferredWork[presetA], _deferredWork[presetB]);
     _mapper.swapPresets(presetA, presetB);
 
     // swap filenames again for keeping the originals
@@ -1238,7 +1738,7 @@ void HostConnector::clearCurrentPreset()
     _current.dirty = true;
 
     // direct connections
-    hostConnectChainEndpoints(0);
+    hostUpdateConnections();
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1294,6 +1794,8 @@ bool HostConnector::enableBlock(const uint8_t row, const uint8_t block, const bo
     assert(row < NUM_BLOCK_CHAIN_ROWS);
     assert(block < NUM_BLOCKS_PER_PRESET);
 
+    markUserCommand();
+
     Block& blockdata(_current.chains[row].blocks[block]);
     assert_return(!isNullBlock(blockdata), false);
 
@@ -1474,12 +1976,6 @@ bool HostConnector::reorderBlock(const uint8_t row, const uint8_t orig, const ui
 
     const Host::NonBlockingScopeWithAudioFades hnbs(_host);
 
-    if (reconnect && ! blockIsEmpty)
-    {
-        hostDisconnectAllBlockInputs(row, orig);
-        hostDisconnectAllBlockOutputs(row, orig);
-    }
-
     // moving block backwards to the left
     // a b c d e! f
     // a b c e! d f
@@ -1488,14 +1984,7 @@ bool HostConnector::reorderBlock(const uint8_t row, const uint8_t orig, const ui
     if (orig > dest)
     {
         for (int i = orig; i > dest; --i)
-        {
-            if (reconnect && !isNullBlock(chain.blocks[i - 1]))
-            {
-                hostDisconnectAllBlockInputs(row, i - 1);
-                hostDisconnectAllBlockOutputs(row, i - 1);
-            }
             std::swap(chain.blocks[i], chain.blocks[i - 1]);
-        }
     }
 
     // moving block forward to the right
@@ -1506,14 +1995,7 @@ bool HostConnector::reorderBlock(const uint8_t row, const uint8_t orig, const ui
     else
     {
         for (int i = orig; i < dest; ++i)
-        {
-            if (reconnect && !isNullBlock(chain.blocks[i + 1]))
-            {
-                hostDisconnectAllBlockInputs(row, i + 1);
-                hostDisconnectAllBlockOutputs(row, i + 1);
-            }
             std::swap(chain.blocks[i], chain.blocks[i + 1]);
-        }
     }
 
     _mapper.reorder(_current.preset, row, orig, dest);
@@ -1728,8 +2210,8 @@ bool HostConnector::replaceBlock(const uint8_t row,
         assert_return(plugin != nullptr, false);
 
         // we only do changes after verifying that the requested plugin exists and is valid
-        uint8_t numInputs, numOutputs, numSideInputs, numSideOutputs;
-        if (!getSupportedPluginIO(plugin, numInputs, numOutputs, numSideInputs, numSideOutputs))
+        const BlockPrototype& proto = getBlockPrototype(plugin);
+        if (!proto.supportedIO)
         {
             mod_log_warn("replaceBlock(%u, %u, %s): unsupported IO, rejected", row, block, uri);
             return false;
@@ -1742,9 +2224,9 @@ bool HostConnector::replaceBlock(const uint8_t row,
             hostRemoveInstanceForBlock(row, block);
         }
 
-        HostBlockPair hbp = { _mapper.add(_current.preset, row, block), kMaxHostInstances };
+        HostBlockPair hbp = { kMaxHostInstances, kMaxHostInstances };
 
-        bool added = _host.preload(uri, hbp.id);
+        bool added = hostPreloadInstanceForBlock(_current.preset, row, block, uri, hbp.id);
         if (added)
         {
             mod_log_debug("block %u loaded plugin %s", block, uri);
@@ -1769,10 +2251,10 @@ bool HostConnector::replaceBlock(const uint8_t row,
                 blockdata.uri = plugin->uri;
                 blockdata.plugin = plugin;
                 blockdata.meta.flags = plugin->flags;
-                blockdata.meta.numInputs = numInputs;
-                blockdata.meta.numOutputs = numOutputs;
-                blockdata.meta.numSideInputs = numSideInputs;
-                blockdata.meta.numSideOutputs = numSideOutputs;
+                blockdata.meta.numInputs = proto.numInputs;
+                blockdata.meta.numOutputs = proto.numOutputs;
+                blockdata.meta.numSideInputs = proto.numSideInputs;
+                blockdata.meta.numSideOutputs = proto.numSideOutputs;
 
                 if (!blockdata.enabled)
                 {
@@ -1795,7 +2277,7 @@ bool HostConnector::replaceBlock(const uint8_t row,
             }
             else
             {
-                initBlock(blockdata, plugin, numInputs, numOutputs, numSideInputs, numSideOutputs);
+                initBlock(blockdata, proto);
             }
 
             for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
@@ -1856,24 +2338,18 @@ bool HostConnector::replaceBlock(const uint8_t row,
         if (_current.numLoadedPlugins == 1)
         {
             assert(row == 0);
-            hostDisconnectChainEndpoints(0);
-            hostConnectBlockToChainInput(row, block);
-            hostConnectBlockToChainOutput(row, block);
+            hostUpdateConnections();
         }
         // otherwise we need to add ourselves more carefully
         else
         {
-            std::array<bool, NUM_BLOCKS_PER_PRESET> loaded;
-            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-                loaded[bl] = !isNullBlock(chaindata.blocks[bl]);
-
-            // find surrounding plugins
-            uint8_t before = NUM_BLOCKS_PER_PRESET;
+            // find previous plugin
+            uint8_t before = 0;
             if (block != 0)
             {
                 for (uint8_t b = block - 1; b != UINT8_MAX; --b)
                 {
-                    if (loaded[b])
+                    if (!isNullBlock(chaindata.blocks[b]))
                     {
                         before = b;
                         break;
@@ -1881,56 +2357,13 @@ bool HostConnector::replaceBlock(const uint8_t row,
                 }
             }
 
-            uint8_t after = NUM_BLOCKS_PER_PRESET;
-            if (block != NUM_BLOCKS_PER_PRESET - 1)
-            {
-                for (uint8_t bl = block + 1; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-                {
-                    if (loaded[bl])
-                    {
-                        after = bl;
-                        break;
-                    }
-                }
-            }
-
-            mod_log_debug("replaceBlock add mode before: %u, after: %u | block: %u", before, after, block);
+            mod_log_debug("replaceBlock add mode before: %u | block: %u", before, block);
 
-            if (after != NUM_BLOCKS_PER_PRESET)
-                hostDisconnectAllBlockInputs(row, after);
-
-            if (before != NUM_BLOCKS_PER_PRESET)
-                hostDisconnectAllBlockOutputs(row, before);
-            else
-                before = 0;
-
-            // disconnect end of next chain
+            // connect end of next chain
             if (blockdata.meta.numSideInputs != 0)
             {
                 assert(row + 1 < NUM_BLOCK_CHAIN_ROWS);
-
-                ChainRow& chain2data(_current.chains[row + 1]);
-                assert(!chain2data.capture[0].empty());
-
-                uint8_t last = NUM_BLOCKS_PER_PRESET;
-                for (uint8_t b = NUM_BLOCKS_PER_PRESET - 1; b != UINT8_MAX; --b)
-                {
-                    if (!isNullBlock(chain2data.blocks[b]))
-                    {
-                        last = b;
-                        hostDisconnectAllBlockOutputs(row + 1, b);
-                        break;
-                    }
-                }
-
-                if (last == NUM_BLOCKS_PER_PRESET)
-                {
-                    _host.disconnect_all(chain2data.capture[0].c_str());
-
-                    if (chain2data.capture[0] != chain2data.capture[1])
-                        _host.disconnect_all(chain2data.capture[1].c_str());
-                }
-
+                assert(!_current.chains[row + 1].capture[0].empty());
                 hostEnsureStereoChain(_current.preset, row + 1);
             }
 
@@ -1948,7 +2381,7 @@ bool HostConnector::replaceBlock(const uint8_t row,
         // use direct connections if there are no plugins
         if (_current.numLoadedPlugins == 0)
         {
-            hostConnectChainEndpoints(0);
+            hostUpdateConnections();
         }
         else
         {
@@ -2076,6 +2509,8 @@ bool HostConnector::resetBlock(const uint8_t row, const uint8_t block, const boo
                 _host.bundle_remove(defdir.c_str(), resource.c_str());
                 std::filesystem::remove_all(defdir);
             }
+
+            _blockDefaults.erase(blockdata.uri);
         } while (false);
     }
 
@@ -2206,135 +2641,401 @@ bool HostConnector::saveBlockStateAsDefault(const uint8_t row, const uint8_t blo
     j["quickpot"] = blockdata.quickPotSymbol;
     safeJsonSave(j, defdir + "/defaults.json");
 
+    _blockDefaults.erase(blockdata.uri);
+
     return true;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-#if NUM_BLOCK_CHAIN_ROWS != 1
-
-bool HostConnector::swapBlockRow(const uint8_t row,
-                                 const uint8_t block,
-                                 const uint8_t emptyRow,
-                                 const uint8_t emptyBlock)
+bool HostConnector::copyBlockToPreset(const uint8_t preset,
+                                      const uint8_t row,
+                                      const uint8_t block,
+                                      const uint8_t destPreset,
+                                      const uint8_t destRow,
+                                      const uint8_t destBlock)
 {
-    mod_log_debug("swapBlockRow(%u, %u, %u, %u)", row, block, emptyRow, emptyBlock);
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(block < NUM_BLOCKS_PER_PRESET);
-    assert(emptyRow < NUM_BLOCK_CHAIN_ROWS);
-    assert(emptyBlock < NUM_BLOCKS_PER_PRESET);
-    assert(row != emptyRow);
-    assert(!_current.chains[row].capture[0].empty());
-    assert(!_current.chains[emptyRow].capture[0].empty());
-    assert(!isNullBlock(_current.chains[row].blocks[block]));
-    assert(isNullBlock(_current.chains[emptyRow].blocks[emptyBlock]));
+    mod_log_debug("copyBlockToPreset(%u, %u, %u, %u, %u, %u)", preset, row, block, destPreset, destRow, destBlock);
 
-    // scope for fade-out, disconnect, reconnect, fade-in
+    if (preset == _current.preset || destPreset == _current.preset)
     {
         const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+        return hostTransferBlock(preset, row, block, destPreset, destRow, destBlock, false);
+    }
 
-        // step 1: disconnect all ports from moving block
-        hostDisconnectAllBlockInputs(row, block);
-        hostDisconnectAllBlockOutputs(row, block);
-
-        // step 2: disconnect sides of chain that gets new block
-        if (emptyBlock != 0)
-        {
-            for (uint8_t bl = emptyBlock - 1; bl != 0; --bl)
-            {
-                if (isNullBlock(_current.chains[emptyRow].blocks[bl]))
-                    continue;
-
-                hostDisconnectAllBlockOutputs(emptyRow, bl);
-                break;
-            }
-        }
-
-        if (emptyBlock != NUM_BLOCKS_PER_PRESET - 1)
-        {
-            for (uint8_t bl = emptyBlock + 1; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-            {
-                if (isNullBlock(_current.chains[emptyRow].blocks[bl]))
-                    continue;
-
-                hostDisconnectAllBlockInputs(emptyRow, bl);
-                break;
-            }
-        }
-
-        // step 3: swap data
-        std::swap(_current.chains[row].blocks[block], _current.chains[emptyRow].blocks[emptyBlock]);
-
-        _mapper.swapBlocks(_current.preset, row, block, emptyRow, emptyBlock);
-
-        for (Bindings& bindings : _current.bindings)
-        {
-            for (ParameterBinding& bindingdata : bindings.parameters)
-            {
-                if (bindingdata.row == row && bindingdata.block == block)
-                {
-                    bindingdata.row = emptyRow;
-                    bindingdata.block = emptyBlock;
-                }
-            }
+    const Host::NonBlockingScope hnbs(_host);
+    return hostTransferBlock(preset, row, block, destPreset, destRow, destBlock, false);
+}
 
-            for (PropertyBinding& bindingdata : bindings.properties)
-            {
-                if (bindingdata.row == row && bindingdata.block == block)
-                {
-                    bindingdata.row = emptyRow;
-                    bindingdata.block = emptyBlock;
-                }
-            }
-        }
+// --------------------------------------------------------------------------------------------------------------------
 
-        // step 4: reconnect ports
-        hostEnsureStereoChain(_current.preset, row, emptyBlock - (emptyBlock != 0 ? 1 : 0));
+bool HostConnector::moveBlockToPreset(const uint8_t preset,
+                                      const uint8_t row,
+                                      const uint8_t block,
+                                      const uint8_t destPreset,
+                                      const uint8_t destRow,
+                                      const uint8_t destBlock)
+{
+    mod_log_debug("moveBlockToPreset(%u, %u, %u, %u, %u, %u)", preset, row, block, destPreset, destRow, destBlock);
 
-        // NOTE previous call already handles sidechain connections
-        if (_current.chains[row].blocks[emptyBlock].meta.numSideOutputs == 0)
-            hostEnsureStereoChain(_current.preset, emptyRow, block - (block != 0 ? 1 : 0));
+    if (preset == _current.preset || destPreset == _current.preset)
+    {
+        const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+        return hostTransferBlock(preset, row, block, destPreset, destRow, destBlock, true);
     }
 
-    _current.dirty = true;
-    return true;
+    const Host::NonBlockingScope hnbs(_host);
+    return hostTransferBlock(preset, row, block, destPreset, destRow, destBlock, true);
 }
 
-#endif // NUM_BLOCK_CHAIN_ROWS != 1
-
 // --------------------------------------------------------------------------------------------------------------------
 
-bool HostConnector::switchPreset(const uint8_t preset)
+bool HostConnector::hostTransferBlock(const uint8_t preset,
+                                      const uint8_t row,
+                                      const uint8_t block,
+                                      const uint8_t destPreset,
+                                      const uint8_t destRow,
+                                      const uint8_t destBlock,
+                                      const bool move)
 {
-    mod_log_debug("switchPreset(%u)", preset);
+    mod_log_debug("hostTransferBlock(%u, %u, %u, %u, %u, %u, %s)",
+                  preset, row, block, destPreset, destRow, destBlock, bool2str(move));
     assert(preset < NUM_PRESETS_PER_BANK);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(destPreset < NUM_PRESETS_PER_BANK);
+    assert(destRow < NUM_BLOCK_CHAIN_ROWS);
+    assert(destBlock < NUM_BLOCKS_PER_PRESET);
 
-    if (_current.preset == preset)
+    if (preset == destPreset)
+    {
+        mod_log_warn("hostTransferBlock(...): source and destination preset are the same, rejected");
         return false;
+    }
 
-    // store old active preset in memory before doing anything
-    const Current old = _current;
+    hostEnsurePresetLoaded(preset);
+    hostEnsurePresetLoaded(destPreset);
 
-    // copy new preset to current data
-    static_cast<Preset&>(_current) = _presets[preset];
-    _current.preset = preset;
-    _current.defaultScene = _current.scene;
+    const bool active = preset == _current.preset;
+    const bool destActive = destPreset == _current.preset;
 
-    // switch old preset with new one
-    hostSwitchPreset(old);
-    return true;
-}
+    Preset& presetdata(active ? static_cast<Preset&>(_current) : _presets[preset]);
+    Preset& destpresetdata(destActive ? static_cast<Preset&>(_current) : _presets[destPreset]);
 
-// --------------------------------------------------------------------------------------------------------------------
+    // inactive preset data is modified in place
+    if (!active)
+        _presetsAsLoaded[preset] = false;
+    if (!destActive)
+        _presetsAsLoaded[destPreset] = false;
 
-void HostConnector::renamePreset(const uint8_t preset, const char* const name)
-{
-    mod_log_debug("renamePreset(%u, \"%s\")", preset, name);
-    assert(preset < NUM_PRESETS_PER_BANK);
-    assert(name != nullptr);
+    Block& blockdata(presetdata.chains[row].blocks[block]);
+    Block& destblockdata(destpresetdata.chains[destRow].blocks[destBlock]);
 
-    if (_current.preset == preset)
-        return setCurrentPresetName(name);
+    if (isNullBlock(blockdata))
+    {
+        mod_log_warn("hostTransferBlock(...): source block is empty, rejected");
+        return false;
+    }
+
+    // sidechain blocks are tied to the next row, use regular block replacement for those
+    if (blockdata.meta.numSideInputs != 0 || blockdata.meta.numSideOutputs != 0 ||
+        destblockdata.meta.numSideInputs != 0 || destblockdata.meta.numSideOutputs != 0)
+    {
+        mod_log_warn("hostTransferBlock(...): sidechain blocks are not supported, rejected");
+        return false;
+    }
+
+    const bool destLoaded = !isNullBlock(destblockdata);
+    HostBlockPair hbp;
+
+    // step 1: get an instance for the destination
+    if (!move && destLoaded && destblockdata.uri == blockdata.uri)
+    {
+        // same plugin, keep destination instance and its connections, only send what changed
+        hbp = _mapper.get(destPreset, destRow, destBlock);
+        assert_return(hbp.id != kMaxHostInstances, false);
+
+        if (destblockdata.enabled != blockdata.enabled)
+            hostBypassBlockPair(hbp, !blockdata.enabled);
+
+        std::vector<flushed_param> params;
+        params.reserve(MAX_PARAMS_PER_BLOCK);
+
+        for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+        {
+            const Parameter& paramdata(blockdata.parameters[p]);
+            if (isNullURI(paramdata.symbol))
+                break;
+            if ((paramdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+                continue;
+            if (isNotEqual(paramdata.value, destblockdata.parameters[p].value))
+                params.push_back({ paramdata.symbol.c_str(), paramdata.value });
+        }
+
+        if (!params.empty())
+        {
+            if (destActive)
+                hostParamsFlushBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_NONE, params);
+            else
+                hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_NONE, params);
+        }
+
+        for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+        {
+            const Property& propdata(blockdata.properties[p]);
+            if (isNullURI(propdata.uri))
+                break;
+            if ((propdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
+                continue;
+            if (propdata.value != destblockdata.properties[p].value)
+                hostPatchSetBlockPair(hbp, propdata);
+        }
+
+        destblockdata = blockdata;
+        removeAllBlockBindings(destpresetdata, destRow, destBlock);
+
+        if (active || destActive)
+            _current.dirty = true;
+
+        return true;
+    }
+
+    const HostBlockPair oldhbp = _mapper.detach(destPreset, destRow, destBlock);
+
+    if (move)
+    {
+        // transfer instance(s) as-is, they already contain the block state
+        hbp = _mapper.detach(preset, row, block);
+        assert_return(hbp.id != kMaxHostInstances, false);
+
+        _mapper.attach(destPreset, destRow, destBlock, hbp.id);
+        if (hbp.pair != kMaxHostInstances)
+            _mapper.attach_pair(destPreset, destRow, destBlock, hbp.pair);
+
+        if (active)
+            hostDisconnectBlockPair(hbp);
+
+        if (active != destActive)
+        {
+            if (hbp.pair != kMaxHostInstances)
+            {
+                const int16_t instances[2] = { static_cast<int16_t>(hbp.id), static_cast<int16_t>(hbp.pair) };
+                _host.multi_activate(destActive, 2, instances);
+            }
+            else
+            {
+                _host.activate(hbp.id, destActive);
+            }
+        }
+    }
+    else
+    {
+        // different plugin, take a spare instance or load a new one
+        hbp = { kMaxHostInstances, kMaxHostInstances };
+
+        if (!hostPreloadInstanceForBlock(destPreset, destRow, destBlock, blockdata.uri.c_str(), hbp.id))
+        {
+            mod_log_warn("hostTransferBlock(...): failed to load plugin %s: %s",
+                         blockdata.uri.c_str(), _host.last_error.c_str());
+
+            // restore previous state
+            _mapper.remove(destPreset, destRow, destBlock);
+
+            if (oldhbp.id != kMaxHostInstances)
+            {
+                _mapper.attach(destPreset, destRow, destBlock, oldhbp.id);
+                if (oldhbp.pair != kMaxHostInstances)
+                    _mapper.attach_pair(destPreset, destRow, destBlock, oldhbp.pair);
+            }
+
+            return false;
+        }
+
+        hostSetupInstance(blockdata, hbp.id);
+
+        if (destActive)
+            _host.activate(hbp.id, true);
+    }
+
+    // step 2: get rid of old destination instance(s)
+    if (oldhbp.id != kMaxHostInstances)
+        hostReleaseBlockPair(oldhbp, destblockdata);
+
+    // step 3: update data, bindings stay behind
+    destblockdata = blockdata;
+    removeAllBlockBindings(destpresetdata, destRow, destBlock);
+
+    if (move)
+    {
+        removeAllBlockBindings(presetdata, row, block);
+        resetBlock(blockdata);
+    }
+
+    if (move && active)
+        --_current.numLoadedPlugins;
+    if (destActive && !destLoaded)
+        ++_current.numLoadedPlugins;
+
+    // step 4: rewire source chain around the now empty block
+    if (move)
+    {
+        uint8_t start = 0;
+        for (uint8_t b = block - 1; b < block; --b)
+        {
+            if (!isNullBlock(presetdata.chains[row].blocks[b]))
+            {
+                start = b;
+                break;
+            }
+        }
+
+        hostEnsureStereoChain(preset, row, start);
+    }
+
+    // step 5: rewire destination chain around the new block
+    {
+        const ChainRow& chaindata(destpresetdata.chains[destRow]);
+
+        uint8_t before = 0;
+        for (uint8_t b = destBlock - 1; b < destBlock; --b)
+        {
+            if (!isNullBlock(chaindata.blocks[b]))
+            {
+                before = b;
+                break;
+            }
+        }
+
+        hostEnsureStereoChain(destPreset, destRow, before);
+    }
+
+    if (active || destActive)
+        _current.dirty = true;
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#if NUM_BLOCK_CHAIN_ROWS != 1
+
+bool HostConnector::swapBlockRow(const uint8_t row,
+                                 const uint8_t block,
+                                 const uint8_t emptyRow,
+                                 const uint8_t emptyBlock)
+{
+    mod_log_debug("swapBlockRow(%u, %u, %u, %u)", row, block, emptyRow, emptyBlock);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(emptyRow < NUM_BLOCK_CHAIN_ROWS);
+    assert(emptyBlock < NUM_BLOCKS_PER_PRESET);
+    assert(row != emptyRow);
+    assert(!_current.chains[row].capture[0].empty());
+    assert(!_current.chains[emptyRow].capture[0].empty());
+    assert(!isNullBlock(_current.chains[row].blocks[block]));
+    assert(isNullBlock(_current.chains[emptyRow].blocks[emptyBlock]));
+
+    // scope for fade-out, reconnect, fade-in
+    {
+        const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+
+        // step 1: swap data
+        std::swap(_current.chains[row].blocks[block], _current.chains[emptyRow].blocks[emptyBlock]);
+
+        _mapper.swapBlocks(_current.preset, row, block, emptyRow, emptyBlock);
+
+        for (Bindings& bindings : _current.bindings)
+        {
+            for (ParameterBinding& bindingdata : bindings.parameters)
+            {
+                if (bindingdata.row == row && bindingdata.block == block)
+                {
+                    bindingdata.row = emptyRow;
+                    bindingdata.block = emptyBlock;
+                }
+            }
+
+            for (PropertyBinding& bindingdata : bindings.properties)
+            {
+                if (bindingdata.row == row && bindingdata.block == block)
+                {
+                    bindingdata.row = emptyRow;
+                    bindingdata.block = emptyBlock;
+                }
+            }
+        }
+
+        // step 2: reconnect ports, only changed connections are touched
+        hostEnsureStereoChain(_current.preset, row, emptyBlock - (emptyBlock != 0 ? 1 : 0));
+
+        // NOTE previous call already handles sidechain connections
+        if (_current.chains[row].blocks[emptyBlock].meta.numSideOutputs == 0)
+            hostEnsureStereoChain(_current.preset, emptyRow, block - (block != 0 ? 1 : 0));
+    }
+
+    _current.dirty = true;
+    return true;
+}
+
+#endif // NUM_BLOCK_CHAIN_ROWS != 1
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::switchPreset(const uint8_t preset)
+{
+    mod_log_debug("switchPreset(%u)", preset);
+    assert(preset < NUM_PRESETS_PER_BANK);
+
+    // a direct switch supersedes any pending request
+    _requestedPreset = NUM_PRESETS_PER_BANK;
+
+    if (_current.preset == preset)
+        return false;
+
+    markUserCommand();
+
+    {
+        const Host::NonBlockingScope hnbs(_host);
+        hostEndCrossfade();
+        hostEnsurePresetLoaded(preset);
+    }
+
+    // store old active preset in memory before doing anything
+    Current old = _current;
+
+    // copy new preset to current data
+    static_cast<Preset&>(_current) = _presets[preset];
+    _current.preset = preset;
+    _current.defaultScene = _current.scene;
+
+    // switch old preset with new one
+    hostSwitchPreset(std::move(old));
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::requestSwitchPreset(const uint8_t preset)
+{
+    mod_log_debug("requestSwitchPreset(%u)", preset);
+    assert(preset < NUM_PRESETS_PER_BANK);
+
+    const uint8_t superseded = _requestedPreset.exchange(preset);
+
+    if (superseded != NUM_PRESETS_PER_BANK && superseded != preset)
+        mod_log_debug("requestSwitchPreset(%u) - superseding request for preset %u", preset, superseded);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::renamePreset(const uint8_t preset, const char* const name)
+{
+    mod_log_debug("renamePreset(%u, \"%s\")", preset, name);
+    assert(preset < NUM_PRESETS_PER_BANK);
+    assert(name != nullptr);
+
+    if (_current.preset == preset)
+        return setCurrentPresetName(name);
 
     _presets[preset].name = name;
 
@@ -2476,6 +3177,8 @@ bool HostConnector::switchScene(const uint8_t scene)
     mod_log_debug("switchScene(%u)", scene);
     assert(scene < NUM_SCENES_PER_PRESET);
 
+    markUserCommand();
+
     if (_current.scene == scene)
         return false;
 
@@ -3419,6 +4122,8 @@ void HostConnector::setBindingValue(const uint8_t hwid,
     mod_log_debug("setBindingValue(%u, %f, %s, %s)", hwid, value, SceneMode2Str(sceneMode), bool2str(updateBindings));
     assert(hwid < NUM_BINDING_ACTUATORS);
 
+    markUserCommand();
+
     Bindings& bindings(_current.bindings[hwid]);
     bindings.value = value;
 
@@ -3491,6 +4196,46 @@ void HostConnector::pollHostUpdates(Callback* const callback)
     _callback = callback;
     _host.poll_feedback(this);
     _callback = nullptr;
+
+    // handle the latest preset switch request, any earlier ones were superseded by it
+    if (const uint8_t preset = _requestedPreset.exchange(NUM_PRESETS_PER_BANK); preset != NUM_PRESETS_PER_BANK)
+        switchPreset(preset);
+
+    // previous preset fades out through the crossfade mixer
+    hostRunCrossfade();
+
+    // blocks left ringing after a preset switch are stopped once their time is up
+    hostEndExpiredSpillover();
+
+    // continue with non-urgent host work, like background loading of the current bank
+    hostRunDeferredWork();
+
+    // sync mod-host with bundle changes found by the LV2_PATH watcher
+    for (const Lv2BundleChange& change : _lv2world.takeBundleChanges())
+    {
+        if (change.added)
+        {
+            _host.bundle_add(change.path.c_str());
+        }
+        else
+        {
+            // spare instances might belong to the removed bundle
+            hostTrimInstancePool(0);
+            _host.bundle_remove(change.path.c_str());
+        }
+
+        // presets loaded from the same files can now have different plugins
+        forgetLoadPrograms();
+
+        if (callback == nullptr)
+            continue;
+
+        HostCallbackData cdata = {};
+        cdata.type = HostCallbackData::kPluginBundleChanged;
+        cdata.pluginBundleChanged.path = change.path.c_str();
+        cdata.pluginBundleChanged.added = change.added;
+        callback->hostConnectorCallback(cdata);
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -3538,6 +4283,8 @@ void HostConnector::setBlockParameter(const uint8_t row,
     assert(block < NUM_BLOCKS_PER_PRESET);
     assert(paramIndex < MAX_PARAMS_PER_BLOCK);
 
+    markUserCommand();
+
     Block& blockdata(_current.chains[row].blocks[block]);
     assert_return(!isNullBlock(blockdata),);
 
@@ -3702,6 +4449,8 @@ void HostConnector::setBlockParameter(const uint8_t row,
     assert(block < NUM_BLOCKS_PER_PRESET);
     assert(symbol != nullptr && *symbol != '\0');
 
+    markUserCommand();
+
     Block& blockdata(_current.chains[row].blocks[block]);
     assert_return(!isNullBlock(blockdata),);
 
@@ -3883,20 +4632,20 @@ void HostConnector::connectBlock2Tool(const uint8_t row,
     assert_return(hbp.id != kMaxHostInstances,);
 
     // collect non-sidechain audio ports from block
-    std::vector<std::string> ports;
+    std::vector<const char*> ports;
     ports.reserve(2);
 
     constexpr uint32_t testFlags = Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain;
-    for (const Lv2Port& port : blockdata.plugin->ports)
+    for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
     {
-        if ((port.flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput))
+        if ((blockdata.plugin->ports[i].flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput))
             continue;
 
-        ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, port.symbol.c_str()));
+        ports.push_back(getInstancePortName(hbp.id, blockdata.plugin, i).c_str());
 
         if (hbp.pair != kMaxHostInstances)
         {
-            ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, port.symbol.c_str()));
+            ports.push_back(getInstancePortName(hbp.pair, blockdata.plugin, i).c_str());
             break;
         }
     }
@@ -3904,43 +4653,43 @@ void HostConnector::connectBlock2Tool(const uint8_t row,
     assert_return(!ports.empty(),);
 
     // connect mono
-    _host.connect(ports[0].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                           MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                           toolInSymbolL).c_str());
+    _host.connect(ports[0], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                   MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                   toolInSymbolL).c_str());
 
     if (ports.size() == 2)
     {
         if (toolStereoIn)
             // stereo
-            _host.connect(ports[1].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                   MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                                   toolInSymbolR).c_str());
+            _host.connect(ports[1], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                           MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                           toolInSymbolR).c_str());
         else 
             // stereo to mono
-            _host.connect(ports[1].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                   MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                                   toolInSymbolL).c_str());
+            _host.connect(ports[1], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                           MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                           toolInSymbolL).c_str());
     }
     else if (ports.size() == 1 && toolStereoIn)
     {
         // mono to both stereo inputs
-        _host.connect(ports[0].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                               MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                               toolInSymbolR).c_str());
+        _host.connect(ports[0], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                       MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                       toolInSymbolR).c_str());
     }
 
     // collect sidechain audio ports from block
     ports.clear();
-    for (const Lv2Port& port : blockdata.plugin->ports)
+    for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
     {
-        if ((port.flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain))
+        if ((blockdata.plugin->ports[i].flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain))
             continue;
 
-        ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, port.symbol.c_str()));
+        ports.push_back(getInstancePortName(hbp.id, blockdata.plugin, i).c_str());
 
         if (hbp.pair != kMaxHostInstances)
         {
-            ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, port.symbol.c_str()));
+            ports.push_back(getInstancePortName(hbp.pair, blockdata.plugin, i).c_str());
             break;
         }
     }
@@ -3950,15 +4699,15 @@ void HostConnector::connectBlock2Tool(const uint8_t row,
 
     // connect mono
     if (toolInSymbolSidechainL != nullptr && *toolInSymbolSidechainL != '\0')
-        _host.connect(ports[0].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                               MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                               toolInSymbolSidechainL).c_str());
+        _host.connect(ports[0], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                       MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                       toolInSymbolSidechainL).c_str());
 
     // connect stereo, if relevant
     if (ports.size() == 2 && toolInSymbolSidechainR != nullptr && *toolInSymbolSidechainR != '\0')
-        _host.connect(ports[1].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                               MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                               toolInSymbolSidechainR).c_str());
+        _host.connect(ports[1], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                       MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                       toolInSymbolSidechainR).c_str());
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -3986,20 +4735,20 @@ void HostConnector::connectBlockAudioInput2Tool(const uint8_t row,
     assert_return(hbp.id != kMaxHostInstances,);
 
     // collect non-sidechain audio ports from block
-    std::vector<std::string> ports;
+    std::vector<const char*> ports;
     ports.reserve(2);
 
     constexpr uint32_t testFlags = Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain;
-    for (const Lv2Port& port : blockdata.plugin->ports)
+    for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
     {
-        if ((port.flags & testFlags) != Lv2PortIsAudio)
+        if ((blockdata.plugin->ports[i].flags & testFlags) != Lv2PortIsAudio)
             continue;
 
-        ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, port.symbol.c_str()));
+        ports.push_back(getInstancePortName(hbp.id, blockdata.plugin, i).c_str());
 
         if (hbp.pair != kMaxHostInstances)
         {
-            ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, port.symbol.c_str()));
+            ports.push_back(getInstancePortName(hbp.pair, blockdata.plugin, i).c_str());
             break;
         }
     }
@@ -4008,27 +4757,27 @@ void HostConnector::connectBlockAudioInput2Tool(const uint8_t row,
 
     // connect mono
     _host.connect_matching(
-        ports[0].c_str(),
+        ports[0],
         format(MOD_HOST_EFFECT_PREFIX "%d:%s", MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex, toolInSymbolL).c_str());
 
     // connect stereo, if relevant
     if (ports.size() == 2 && toolInSymbolR != nullptr && *toolInSymbolR != '\0')
-        _host.connect_matching(ports[1].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                        MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                                        toolInSymbolR).c_str());
+        _host.connect_matching(ports[1], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                                MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                                toolInSymbolR).c_str());
 
     // collect sidechain audio ports from block
     ports.clear();
-    for (const Lv2Port& port : blockdata.plugin->ports)
+    for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
     {
-        if ((port.flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsSidechain))
+        if ((blockdata.plugin->ports[i].flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsSidechain))
             continue;
 
-        ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, port.symbol.c_str()));
+        ports.push_back(getInstancePortName(hbp.id, blockdata.plugin, i).c_str());
 
         if (hbp.pair != kMaxHostInstances)
         {
-            ports.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, port.symbol.c_str()));
+            ports.push_back(getInstancePortName(hbp.pair, blockdata.plugin, i).c_str());
             break;
         }
     }
@@ -4038,15 +4787,15 @@ void HostConnector::connectBlockAudioInput2Tool(const uint8_t row,
 
     // connect mono
     if (toolInSymbolSidechainL != nullptr && *toolInSymbolSidechainL != '\0')
-        _host.connect_matching(ports[0].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                        MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                                        toolInSymbolSidechainL).c_str());
+        _host.connect_matching(ports[0], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                                MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                                toolInSymbolSidechainL).c_str());
 
     // connect stereo, if relevant
     if (ports.size() == 2 && toolInSymbolSidechainR != nullptr && *toolInSymbolSidechainR != '\0')
-        _host.connect_matching(ports[1].c_str(), format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                        MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
-                                                        toolInSymbolSidechainR).c_str());
+        _host.connect_matching(ports[1], format(MOD_HOST_EFFECT_PREFIX "%d:%s",
+                                                MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex,
+                                                toolInSymbolSidechainR).c_str());
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -4119,32 +4868,115 @@ void HostConnector::monitorToolOutputParameter(const uint8_t toolIndex, const ch
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::setBlockProperty(const uint8_t row,
-                                     const uint8_t block,
-                                     const uint8_t propIndex,
-                                     const char* const value,
-                                     const SceneMode sceneMode)
-{
-    mod_log_debug("setBlockProperty(%u, %u, %u, \"%s\", %d:%s)",
-                  row, block, propIndex, value, sceneMode, SceneMode2Str(sceneMode));
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(block < NUM_BLOCKS_PER_PRESET);
-    assert(propIndex < MAX_PARAMS_PER_BLOCK);
-    assert(value != nullptr);
+bool HostConnector::setPresetSwitchCrossfadeTool(const uint8_t toolIndex,
+                                                 const char* const mixSymbol,
+                                                 const char* const inSymbolAL,
+                                                 const char* const inSymbolAR,
+                                                 const char* const inSymbolBL,
+                                                 const char* const inSymbolBR,
+                                                 const char* const outSymbolL,
+                                                 const char* const outSymbolR)
+{
+    mod_log_debug("setPresetSwitchCrossfadeTool(%u, \"%s\", \"%s\", \"%s\", \"%s\", \"%s\", \"%s\", \"%s\")",
+                  toolIndex, mixSymbol, inSymbolAL, inSymbolAR, inSymbolBL, inSymbolBR, outSymbolL, outSymbolR);
+    assert(toolIndex < MAX_MOD_HOST_TOOL_INSTANCES);
+    assert(toolIndex != 5);
 
-    Block& blockdata(_current.chains[row].blocks[block]);
-    assert_return(!isNullBlock(blockdata),);
+    bool success = true;
 
-    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
-    assert_return(hbp.id != kMaxHostInstances,);
+    if (_crossfade.fadingPreset != NUM_PRESETS_PER_BANK)
+    {
+        const Host::NonBlockingScope hnbs(_host);
+        hostEndCrossfade();
+    }
 
-    Property& propdata(blockdata.properties[propIndex]);
-    assert_return(!isNullURI(propdata.uri),);
-    assert_return((propdata.meta.flags & Lv2PropertyNotAllowedToChange) == 0,);
+    if (isNullURI(mixSymbol))
+    {
+        _crossfade.mixSymbol.clear();
+    }
+    else
+    {
+        assert(inSymbolAL != nullptr && *inSymbolAL != '\0');
+        assert(inSymbolAR != nullptr && *inSymbolAR != '\0');
+        assert(inSymbolBL != nullptr && *inSymbolBL != '\0');
+        assert(inSymbolBR != nullptr && *inSymbolBR != '\0');
+        assert(outSymbolL != nullptr && *outSymbolL != '\0');
+        assert(outSymbolR != nullptr && *outSymbolR != '\0');
 
-    _current.dirty = true;
+        const int16_t instance = MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex;
 
-    if ((propdata.meta.flags & (Lv2ParameterExpensive|Lv2ParameterMayUpdateBlockedState)) == 0)
+        _crossfade.mixSymbol = mixSymbol;
+        _crossfade.inputs[0][0] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, inSymbolAL);
+        _crossfade.inputs[0][1] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, inSymbolAR);
+        _crossfade.inputs[1][0] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, inSymbolBL);
+        _crossfade.inputs[1][1] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, inSymbolBR);
+        _crossfade.outputs[0] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, outSymbolL);
+        _crossfade.outputs[1] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", instance, outSymbolR);
+        _crossfade.instance = instance;
+        _crossfade.active = 0;
+
+        success = _host.param_set(instance, mixSymbol, 0.f);
+    }
+
+    // nothing else to do if first preset has not been loaded yet
+    if (_firstboot)
+        return success;
+
+    // move active preset endpoints over to the mixer inputs or back to playback
+    const Host::NonBlockingScope hnbs(_host);
+    hostUpdateConnections();
+
+    return success;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::setPresetSwitchCrossfadeTime(const uint32_t timeMs)
+{
+    mod_log_debug("setPresetSwitchCrossfadeTime(%u)", timeMs);
+
+    _crossfade.timeMs = timeMs;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::setPresetSwitchSpilloverTime(const uint32_t timeMs)
+{
+    mod_log_debug("setPresetSwitchSpilloverTime(%u)", timeMs);
+
+    _spilloverTimeMs = timeMs;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::setBlockProperty(const uint8_t row,
+                                     const uint8_t block,
+                                     const uint8_t propIndex,
+                                     const char* const value,
+                                     const SceneMode sceneMode)
+{
+    mod_log_debug("setBlockProperty(%u, %u, %u, \"%s\", %d:%s)",
+                  row, block, propIndex, value, sceneMode, SceneMode2Str(sceneMode));
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(propIndex < MAX_PARAMS_PER_BLOCK);
+    assert(value != nullptr);
+
+    markUserCommand();
+
+    Block& blockdata(_current.chains[row].blocks[block]);
+    assert_return(!isNullBlock(blockdata),);
+
+    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
+    assert_return(hbp.id != kMaxHostInstances,);
+
+    Property& propdata(blockdata.properties[propIndex]);
+    assert_return(!isNullURI(propdata.uri),);
+    assert_return((propdata.meta.flags & Lv2PropertyNotAllowedToChange) == 0,);
+
+    _current.dirty = true;
+
+    if ((propdata.meta.flags & (Lv2ParameterExpensive|Lv2ParameterMayUpdateBlockedState)) == 0)
     {
         switch (sceneMode)
         {
@@ -4284,6 +5116,8 @@ void HostConnector::setBlockProperty(const uint8_t row,
     assert(uri != nullptr && *uri != '\0');
     assert(value != nullptr);
 
+    markUserCommand();
+
     Block& blockdata(_current.chains[row].blocks[block]);
     assert_return(!isNullBlock(blockdata),);
 
@@ -4306,6 +5140,8 @@ bool HostConnector::bundleAdd(const char* const path)
     assert(path != nullptr && *path != '\0');
     assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
 
+    forgetLoadPrograms();
+
     return _lv2world.bundleAdd(path) && _host.bundle_add(path);
 }
 
@@ -4317,554 +5153,1256 @@ bool HostConnector::bundleRemove(const char* path)
     assert(path != nullptr && *path != '\0');
     assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
 
+    // spare instances might belong to the removed bundle
+    hostTrimInstancePool(0);
+    forgetLoadPrograms();
+
     return _lv2world.bundleRemove(path) && _host.bundle_remove(path);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostConnectBlockToBlock(const uint8_t row, const uint8_t blockA, const uint8_t blockB)
+bool HostConnector::watchPluginBundles(const bool enable, const uint32_t debounceMs)
 {
-    mod_log_debug("hostConnectBlockToBlock(%u, %u, %u)", row, blockA, blockB);
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(blockA < NUM_BLOCKS_PER_PRESET);
-    assert(blockB < NUM_BLOCKS_PER_PRESET);
+    mod_log_debug("watchPluginBundles(%s, %u)", bool2str(enable), debounceMs);
 
-    Block& blockdataA(_current.chains[row].blocks[blockA]);
-    assert_return(blockdataA.plugin != nullptr,);
+    if (! enable)
+    {
+        _lv2world.stopBundleWatcher();
+        return true;
+    }
 
-    Block& blockdataB(_current.chains[row].blocks[blockB]);
-    assert_return(blockdataB.plugin != nullptr,);
+    return _lv2world.startBundleWatcher(debounceMs);
+}
 
-    const HostBlockPair hbpA = _mapper.get(_current.preset, row, blockA);
-    assert_return(hbpA.id != kMaxHostInstances,);
+// --------------------------------------------------------------------------------------------------------------------
 
-    const HostBlockPair hbpB = _mapper.get(_current.preset, row, blockB);
-    assert_return(hbpB.id != kMaxHostInstances,);
+void HostConnector::setInstancePoolBudget(const uint16_t maxInstances)
+{
+    mod_log_debug("setInstancePoolBudget(%u)", maxInstances);
 
-    std::string origin, target;
+    _instancePoolBudget = maxInstances;
+    hostTrimInstancePool(maxInstances);
+}
 
-    // collect audio ports from each block
-    std::vector<std::string> portsA;
-    std::vector<std::string> portsB;
-    portsA.reserve(2);
-    portsB.reserve(2);
+// --------------------------------------------------------------------------------------------------------------------
 
-    constexpr uint32_t testFlags = Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain;
-    for (const Lv2Port& port : blockdataA.plugin->ports)
+void HostConnector::getConnections(HostConnectionGraph& graph) const
+{
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
     {
-        if ((port.flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput))
-            continue;
-
-        portsA.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbpA.id, port.symbol.c_str()));
+        const ChainRow& chain(_current.chains[row]);
+        uint8_t last = NUM_BLOCKS_PER_PRESET;
 
-        if (hbpA.pair != kMaxHostInstances)
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
         {
-            portsA.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbpA.pair, port.symbol.c_str()));
-            break;
+            if (isNullBlock(chain.blocks[bl]))
+                continue;
+
+            if (last == NUM_BLOCKS_PER_PRESET)
+                addChainInputConnections(graph, row, bl);
+            else
+                addBlockToBlockConnections(graph, row, last, bl);
+
+            last = bl;
         }
+
+        if (last != NUM_BLOCKS_PER_PRESET)
+            addChainOutputConnections(graph, row, last);
+        else if (!chain.capture[0].empty())
+            addChainEndpointConnections(graph, row);
     }
 
-    for (const Lv2Port& port : blockdataB.plugin->ports)
+    // blocks of previous presets left ringing go straight to playback
+    for (const DeferredPresetWork& work : _deferredWork)
     {
-        if ((port.flags & testFlags) != Lv2PortIsAudio)
-            continue;
-
-        portsB.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbpB.id, port.symbol.c_str()));
-
-        if (hbpB.pair != kMaxHostInstances)
+        for (const DeferredPresetWork::Tail& tail : work.tails)
         {
-            portsB.push_back(format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbpB.pair, port.symbol.c_str()));
-            break;
+            const std::array<std::string, 2>& playback(getChainPlayback(tail.row));
+            if (!playback[0].empty())
+                addBlockOutputConnections(graph, tail.hbp, tail.plugin, playback);
         }
     }
 
-    assert(!portsA.empty());
-    assert(!portsB.empty());
-
-    _host.connect(portsA[0].c_str(), portsB[0].c_str());
-
-    /**/ if (portsA.size() > portsB.size())
-        _host.connect(portsA[1].c_str(), portsB[0].c_str());
-    else if (portsA.size() < portsB.size())
-        _host.connect(portsA[0].c_str(), portsB[1].c_str());
-    else if (portsA.size() == 2)
-        _host.connect(portsA[1].c_str(), portsB[1].c_str());
+    // active preset goes into the crossfade mixer, which then goes to playback
+    if (! _crossfade.mixSymbol.empty())
+    {
+        graph.insert({ _crossfade.outputs[0], _current.chains[0].playback[0] });
+        graph.insert({ _crossfade.outputs[1], _current.chains[0].playback[1] });
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostConnectBlockToChainInput(const uint8_t row, const uint8_t block)
+void HostConnector::hostUpdateConnections()
 {
-    hostConnectChainInputAction(row, block, true);
+    // connections of a preset still fading out are not part of the graph, finishing the crossfade updates them
+    if (_crossfade.fadingPreset != NUM_PRESETS_PER_BANK)
+    {
+        hostEndCrossfade();
+        return;
+    }
+
+    HostConnectionGraph graph;
+    getConnections(graph);
+
+    hostRemoveOutdatedConnections(graph);
+    hostAddMissingConnections(graph);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostConnectBlockToChainOutput(const uint8_t row, const uint8_t block)
+void HostConnector::hostRemoveOutdatedConnections(const HostConnectionGraph& graph)
 {
-    hostConnectChainOutputAction(row, block, true);
+    uint32_t numRemoved = 0;
+
+    for (HostConnectionGraph::iterator it = _connections.begin(); it != _connections.end();)
+    {
+        if (graph.find(*it) != graph.end())
+        {
+            ++it;
+            continue;
+        }
+
+        _host.disconnect(it->origin.c_str(), it->target.c_str(), it->safe);
+        it = _connections.erase(it);
+        ++numRemoved;
+    }
+
+    if (numRemoved != 0)
+        mod_log_debug("hostRemoveOutdatedConnections(...) - %u connections removed", numRemoved);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostConnectChainEndpoints(const uint8_t row)
+void HostConnector::hostAddMissingConnections(const HostConnectionGraph& graph)
 {
-    hostConnectChainEndpointsAction(row, true);
+    uint32_t numAdded = 0;
+
+    for (const HostConnection& conn : graph)
+    {
+        if (! _connections.insert(conn).second)
+            continue;
+
+        _host.connect(conn.origin.c_str(), conn.target.c_str(), conn.safe);
+        ++numAdded;
+    }
+
+    if (numAdded != 0)
+        mod_log_debug("hostAddMissingConnections(...) - %u connections added", numAdded);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostDisconnectAll(const bool disconnectSideChains)
+void HostConnector::hostDisconnectBlockPair(const HostBlockPair& hbp)
 {
-    mod_log_debug("hostDisconnectAll(%s)", bool2str(disconnectSideChains));
+    assert(hbp.id != kMaxHostInstances);
 
-    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    const std::string prefix = format(MOD_HOST_EFFECT_PREFIX "%d:", hbp.id);
+    const std::string prefix2 = hbp.pair != kMaxHostInstances ? format(MOD_HOST_EFFECT_PREFIX "%d:", hbp.pair) : prefix;
+
+    for (HostConnectionGraph::iterator it = _connections.begin(); it != _connections.end();)
     {
-        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        if (! it->uses(prefix) && ! it->uses(prefix2))
         {
-            if (isNullBlock(_current.chains[row].blocks[bl]))
-                continue;
-
-            hostDisconnectAllBlockInputs(row, bl, disconnectSideChains);
-            hostDisconnectAllBlockOutputs(row, bl, disconnectSideChains);
+            ++it;
+            continue;
         }
+
+        _host.disconnect(it->origin.c_str(), it->target.c_str(), it->safe);
+        it = _connections.erase(it);
     }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostDisconnectAllBlockInputs(const uint8_t row,
-                                                 const uint8_t block,
-                                                 const bool disconnectSideChains)
+void HostConnector::forgetConnections(const int16_t id)
 {
-    hostDisconnectBlockAction(_current.chains[row].blocks[block],
-                              _mapper.get(_current.preset, row, block),
-                              false,
-                              disconnectSideChains);
+    const std::string prefix = id < 0 ? MOD_HOST_EFFECT_PREFIX : format(MOD_HOST_EFFECT_PREFIX "%d:", id);
+
+    for (HostConnectionGraph::iterator it = _connections.begin(); it != _connections.end();)
+    {
+        if (it->uses(prefix))
+            it = _connections.erase(it);
+        else
+            ++it;
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostDisconnectAllBlockOutputs(const uint8_t row,
-                                                  const uint8_t block,
-                                                  const bool disconnectSideChains)
+void HostConnector::forgetInstance(const int16_t id)
 {
-    hostDisconnectBlockAction(_current.chains[row].blocks[block],
-                              _mapper.get(_current.preset, row, block),
-                              true,
-                              disconnectSideChains);
-}
+    forgetConnections(id);
 
-// --------------------------------------------------------------------------------------------------------------------
+    if (id < 0)
+    {
+        for (InstancePortNames& ports : _instancePortNames)
+        {
+            ports.plugin.reset();
+            ports.names.clear();
+        }
+        return;
+    }
 
-void HostConnector::hostDisconnectAllBlockInputs(const Block& blockdata,
-                                                 const HostBlockPair& hbp,
-                                                 const bool disconnectSideChains)
-{
-    hostDisconnectBlockAction(blockdata, hbp, true, disconnectSideChains);
+    assert_return(id < kMaxHostInstances,);
+
+    _instancePortNames[id].plugin.reset();
+    _instancePortNames[id].names.clear();
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostDisconnectAllBlockOutputs(const Block& blockdata,
-                                                  const HostBlockPair& hbp,
-                                                  const bool disconnectSideChains)
+const HostConnector::InstancePortNames&
+HostConnector::cacheInstancePortNames(const uint16_t id, const std::shared_ptr<const Lv2Plugin>& plugin) const
 {
-    hostDisconnectBlockAction(blockdata, hbp, false, disconnectSideChains);
-}
+    assert(id < kMaxHostInstances);
+    assert(plugin != nullptr);
 
-// --------------------------------------------------------------------------------------------------------------------
+    InstancePortNames& ports = _instancePortNames[id];
+
+    // spare instances get reused for the same plugin, so names usually survive
+    if (ports.plugin == plugin)
+        return ports;
 
-void HostConnector::hostDisconnectChainEndpoints(const uint8_t row)
+    ports.plugin = plugin;
+    ports.names.clear();
+    ports.names.resize(plugin->ports.size());
+
+    for (size_t i = 0; i < plugin->ports.size(); ++i)
+    {
+        if ((plugin->ports[i].flags & Lv2PortIsAudio) != 0)
+            ports.names[i] = format(MOD_HOST_EFFECT_PREFIX "%d:%s", id, plugin->ports[i].symbol.c_str());
+    }
+
+    return ports;
+}
+
+const std::string& HostConnector::getInstancePortName(const uint16_t id,
+                                                      const std::shared_ptr<const Lv2Plugin>& plugin,
+                                                      const size_t port) const
 {
-    hostConnectChainEndpointsAction(row, false);
+    const InstancePortNames& ports = cacheInstancePortNames(id, plugin);
+    assert(port < ports.names.size());
+    assert(!ports.names[port].empty());
+
+    return ports.names[port];
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostClearAndLoadCurrentBank()
+void HostConnector::hostClearAndLoadCurrentBank(const uint8_t preset)
 {
-    mod_log_debug("hostClearAndLoadCurrentBank()");
+    mod_log_debug("hostClearAndLoadCurrentBank(%u)", preset);
+    assert(preset < NUM_PRESETS_PER_BANK);
 
     if (_firstboot)
     {
         _firstboot = false;
         _host.feature_enable(Host::kFeatureProcessing, Host::kProcessingOffWithoutFadeOut);
+        hostDisconnectLeftoverEndpoints();
+        _host.remove(-1);
+        forgetAllInstances();
     }
     else
     {
         _host.feature_enable(Host::kFeatureProcessing, Host::kProcessingOffWithFadeOut);
+        hostEndCrossfade();
 
-        std::vector<int16_t> instances;
-        instances.reserve(kMaxHostInstances);
+        // the prepared bank storage holds the new bank, its instances are not of use anymore
+        hostDropPreparedBank();
+        hostReleaseBankInstances(_nextBank.presets);
+    }
 
-        for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
-        {
-            for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
-            {
-                for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-                {
-                    const HostBlockPair hbp = _mapper.get(pr, row, bl);
+    std::swap(_presets, _nextBank.presets);
+    std::swap(_presetsAsLoaded, _nextBank.presetsAsLoaded);
 
-                    if (hbp.id == kMaxHostInstances)
-                        continue;
+    // create current preset data from selected initial preset
+    static_cast<Preset&>(_current) = _presets[preset];
+    _current.preset = preset;
+    _current.defaultScene = _current.scene;
+    _current.numLoadedPlugins = 0;
 
-                    instances.push_back(hbp.id);
+    // preset switch requests refer to the previous bank
+    _requestedPreset = NUM_PRESETS_PER_BANK;
 
-                    if (hbp.pair != kMaxHostInstances)
-                        instances.push_back(hbp.pair);
-                }
-            }
-        }
+    _current.dirty = false;
 
-        switch (instances.size())
+    hostReloadAllPresets();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostReleaseBankInstances(const std::array<Preset, NUM_PRESETS_PER_BANK>& presets)
+{
+    mod_log_debug("hostReleaseBankInstances(...)");
+
+    // how many instances of each plugin can be of use, counting mono blocks as possible dual-mono pairs
+    std::unordered_map<std::string, uint16_t> wanted;
+
+    for (const Preset& presetdata : presets)
+    {
+        for (const ChainRow& chaindata : presetdata.chains)
         {
-        case 0:
-            break;
-        case 1:
-            _host.remove(instances.front());
-            break;
-        default:
-            _host.multi_remove(instances.size(), instances.data());
-            break;
+            for (const Block& blockdata : chaindata.blocks)
+            {
+                if (isNullBlock(blockdata) || blockdata.plugin == nullptr)
+                    continue;
+
+                wanted[blockdata.uri] += blockdata.meta.numInputs == 1 && blockdata.meta.numSideInputs == 0 ? 2 : 1;
+            }
         }
     }
 
-    _host.remove(-1);
-    _mapper.reset();
-    _current.numLoadedPlugins = 0;
-    _current.dirty = false;
+    std::vector<int16_t> instances;
+    instances.reserve(kMaxHostInstancesPerBank);
 
-    for (uint8_t row = 1; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    // spare instances from before are already in a clean state, use them first
+    for (auto it = _instancePool.begin(); it != _instancePool.end();)
     {
-        _current.chains[row].capture.fill({});
-        _current.chains[row].playback.fill({});
-        _current.chains[row].captureId.fill(kMaxHostInstances);
-        _current.chains[row].playbackId.fill(kMaxHostInstances);
+        std::vector<uint16_t>& spares = it->second;
+        const auto wit = wanted.find(it->first);
+        const uint16_t count = wit != wanted.end() ? wit->second : 0;
+
+        while (spares.size() > count)
+        {
+            instances.push_back(spares.back());
+            _mapper.release(spares.back());
+            spares.pop_back();
+            --_instancePoolSize;
+        }
+
+        if (spares.empty())
+        {
+            it = _instancePool.erase(it);
+            continue;
+        }
+
+        wit->second -= spares.size();
+        ++it;
     }
 
     for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
-        hostLoadPreset(pr);
+    {
+        const bool active = pr == _current.preset;
+        const Preset& presetdata(active ? static_cast<const Preset&>(_current) : _presets[pr]);
 
-    _host.feature_enable(Host::kFeatureProcessing, Host::kProcessingOnWithFadeIn);
-}
+        // instances still waiting for their defaults to be restored do not match the preset data, do not reuse
+        const bool reusable = _deferredWork[pr].type != DeferredPresetWork::kRestoreDefaults;
 
-// --------------------------------------------------------------------------------------------------------------------
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+        {
+            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+            {
+                const HostBlockPair hbp = _mapper.detach(pr, row, bl);
+                if (hbp.id == kMaxHostInstances)
+                    continue;
 
-void HostConnector::hostConnectChainEndpointsAction(const uint8_t row, const bool connect)
-{
-    mod_log_debug("hostConnectChainInputAction(%u, %s)", row, bool2str(connect));
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
+                const Block& blockdata(presetdata.chains[row].blocks[bl]);
+                const uint16_t numInstances = hbp.pair != kMaxHostInstances ? 2 : 1;
 
-    const ChainRow& chain(_current.chains[row]);
-    assert(!chain.capture[0].empty());
-    assert(!chain.capture[1].empty());
+                if (reusable && ! isNullBlock(blockdata) && blockdata.plugin != nullptr)
+                {
+                    if (const auto it = wanted.find(blockdata.uri); it != wanted.end() && it->second >= numInstances)
+                    {
+                        it->second -= numInstances;
+                        hostKeepBlockPairAsSpare(hbp, blockdata);
+                        continue;
+                    }
+                }
 
-    if (row == 0)
-    {
-        // playback side cannot be empty
-        assert(!chain.playback[0].empty());
+                _mapper.release(hbp.id);
+                instances.push_back(hbp.id);
+
+                if (hbp.pair != kMaxHostInstances)
+                {
+                    _mapper.release(hbp.pair);
+                    instances.push_back(hbp.pair);
+                }
+            }
+        }
     }
-    else
+
+    mod_log_debug("hostReleaseBankInstances(...) - %u instances kept, %zu removed",
+                  _instancePoolSize, instances.size());
+
+    switch (instances.size())
     {
-        // playback side is allowed to be empty
-        if (chain.playback[0].empty())
-            return;
+    case 0:
+        break;
+    case 1:
+        _host.remove(instances.front());
+        break;
+    default:
+        _host.multi_remove(instances.size(), instances.data());
+        break;
     }
 
-    assert(!chain.playback[1].empty());
-
-    bool (Host::*const call)(const char*, const char*, bool) = connect ? &Host::connect : &Host::disconnect;
-    (_host.*call)(chain.capture[0].c_str(), chain.playback[0].c_str(), true);
-    (_host.*call)(chain.capture[1].c_str(), chain.playback[1].c_str(), true);
+    for (const int16_t id : instances)
+        forgetInstance(id);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostConnectChainInputAction(const uint8_t row, const uint8_t block, const bool connect)
+bool HostConnector::hostResync()
 {
-    mod_log_debug("hostConnectChainInputAction(%u, %u, %s)", row, block, bool2str(connect));
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(block < NUM_BLOCKS_PER_PRESET);
-    assert(!isNullBlock(_current.chains[row].blocks[block]));
+    mod_log_debug("hostResync()");
 
-    Block& blockdata(_current.chains[row].blocks[block]);
-    assert_return(blockdata.plugin != nullptr,);
+    // nothing was loaded yet
+    if (_firstboot)
+        return true;
 
-    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
-    assert_return(hbp.id != kMaxHostInstances,);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-    bool (Host::*const call)(const char*, const char*, bool) = connect ? &Host::connect : &Host::disconnect;
-    std::string origin, target;
+    // ask mod-host about every instance we have, starting with the active preset
+    // a single missing instance means mod-host was restarted (or lost some state), so we load everything again
+    // preloading into an instance id mod-host still has is rejected, so nothing is changed when all are there
+    bool hasInstances = false;
+    bool keptInstances = true;
 
-    for (size_t i = 0, j = 0; i < blockdata.plugin->ports.size() && j < 2; ++i)
+    for (uint8_t i = 0; i < NUM_PRESETS_PER_BANK && keptInstances; ++i)
     {
-        if ((blockdata.plugin->ports[i].flags & (Lv2PortIsAudio|Lv2PortIsOutput)) != Lv2PortIsAudio)
-            continue;
-        if ((blockdata.plugin->ports[i].flags & Lv2PortIsSidechain) != 0)
-            continue;
-
-        origin = _current.chains[row].capture[j++];
-        target = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, blockdata.plugin->ports[i].symbol.c_str());
-        assert_continue(!origin.empty());
-        (_host.*call)(origin.c_str(), target.c_str(), false);
+        const uint8_t preset = (_current.preset + i) % NUM_PRESETS_PER_BANK;
+        const Preset& presetdata(preset == _current.preset ? static_cast<const Preset&>(_current) : _presets[preset]);
 
-        if (hbp.pair != kMaxHostInstances)
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS && keptInstances; ++row)
         {
-            origin = _current.chains[row].capture[j++];
-            target = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, blockdata.plugin->ports[i].symbol.c_str());
-            assert_continue(!origin.empty());
-            (_host.*call)(origin.c_str(), target.c_str(), false);
-            return;
+            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET && keptInstances; ++bl)
+            {
+                const Block& blockdata(presetdata.chains[row].blocks[bl]);
+                if (isNullBlock(blockdata))
+                    continue;
+
+                const HostBlockPair hbp = _mapper.get(preset, row, bl);
+                if (hbp.id == kMaxHostInstances)
+                    continue;
+
+                hasInstances = true;
+
+                for (const uint16_t id : { hbp.id, hbp.pair })
+                {
+                    if (id == kMaxHostInstances)
+                        continue;
+
+                    if (_host.preload_probe(blockdata.uri.c_str(), id) != 1)
+                    {
+                        if (_host.connection_lost())
+                            return false;
+
+                        keptInstances = false;
+                        break;
+                    }
+                }
+            }
         }
     }
-}
 
-// --------------------------------------------------------------------------------------------------------------------
+    // only the values and connections of the active preset might be out of date, from messages lost in between
+    if (hasInstances && keptInstances)
+    {
+        mod_log_info("hostResync(): mod-host kept its instances, refreshing active preset");
 
-void HostConnector::hostConnectChainOutputAction(const uint8_t row, const uint8_t block, const bool connect)
-{
-    mod_log_debug("hostConnectChainOutputAction(%u, %u, %s)", row, block, bool2str(connect));
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(block < NUM_BLOCKS_PER_PRESET);
+        const Host::NonBlockingScope hnbs(_host);
 
-    const ChainRow& chain(_current.chains[row]);
-    assert(!isNullBlock(chain.blocks[block]));
+        std::vector<flushed_param> params;
+        params.reserve(MAX_PARAMS_PER_BLOCK);
 
-    // playback side is allowed to be empty
-    if (chain.playback[0].empty())
-        return;
+        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+        {
+            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+            {
+                const Block& blockdata(_current.chains[row].blocks[bl]);
+                if (isNullBlock(blockdata))
+                    continue;
 
-    assert(!chain.playback[1].empty());
+                const HostBlockPair hbp = _mapper.get(_current.preset, row, bl);
+                if (hbp.id == kMaxHostInstances)
+                    continue;
 
-    const Block& blockdata(chain.blocks[block]);
-    assert_return(blockdata.plugin != nullptr,);
+                params.clear();
 
-    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
-    assert_return(hbp.id != kMaxHostInstances,);
+                for (const Parameter& paramdata : blockdata.parameters)
+                {
+                    if (isNullURI(paramdata.symbol))
+                        break;
+                    if ((paramdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+                        continue;
+                    params.push_back({ paramdata.symbol.c_str(), paramdata.value });
+                }
 
-    bool (Host::*const call)(const char*, const char*, bool) = connect ? &Host::connect : &Host::disconnect;
-    std::string origin, target;
-    int dsti = 0;
+                hostBypassBlockPair(hbp, !blockdata.enabled);
+                hostParamsFlushBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_NONE, params);
+            }
+        }
 
-    for (size_t i = 0; i < blockdata.plugin->ports.size() && dsti < 2; ++i)
-    {
-        if ((blockdata.plugin->ports[i].flags & (Lv2PortIsAudio|Lv2PortIsOutput)) != (Lv2PortIsAudio|Lv2PortIsOutput))
-            continue;
-        if ((blockdata.plugin->ports[i].flags & Lv2PortIsSidechain) != 0)
-            continue;
+        // connections that already exist are harmlessly rejected by mod-host
+        forgetConnections(-1);
+        hostUpdateConnections();
+        return ! _host.connection_lost();
+    }
 
-        origin = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, blockdata.plugin->ports[i].symbol.c_str());
-        target = chain.playback[dsti++];
-        (_host.*call)(origin.c_str(), target.c_str(), false);
+    // mod-host was restarted, load everything again from memory
+    mod_log_info("hostResync(): mod-host was restarted, reloading all presets");
 
-        if (hbp.pair != kMaxHostInstances)
-        {
-            origin = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, blockdata.plugin->ports[i].symbol.c_str());
-            target = chain.playback[dsti++];
-            (_host.*call)(origin.c_str(), target.c_str(), false);
-            return;
-        }
+    // the crossfade mixer tool is gone too, play the active preset directly until it is set again
+    _crossfade.mixSymbol.clear();
+    _crossfade.fadingPreset = NUM_PRESETS_PER_BANK;
+
+    {
+        const Host::NonBlockingScope hnbs(_host);
+
+        _host.feature_enable(Host::kFeatureProcessing, Host::kProcessingOffWithoutFadeOut);
+        hostDisconnectLeftoverEndpoints();
+        _host.remove(-1);
+        forgetAllInstances();
+        hostReloadAllPresets();
     }
 
-    if (dsti == 1)
-        (_host.*call)(origin.c_str(), chain.playback[1].c_str(), false);
+    // audio level monitors are gone together with the old mod-host
+    hostReady();
+
+    mod_log_info("hostResync(): active preset audible after %u ms",
+                 static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start).count()));
+
+    return ! _host.connection_lost();
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostDisconnectBlockAction(const Block& blockdata,
-                                              const HostBlockPair& hbp,
-                                              const bool outputs,
-                                              const bool disconnectSideChains)
+void HostConnector::hostDisconnectLeftoverEndpoints()
 {
-    mod_log_debug("hostDisconnectBlockAction(..., {%u, %u}, %s, %s)",
-                  hbp.id, hbp.pair, bool2str(outputs), bool2str(disconnectSideChains));
-    assert(!isNullBlock(blockdata));
-    assert(hbp.id != kMaxHostInstances);
+    // direct endpoint connections might be left over from a previous run
+    HostConnectionGraph graph;
+    addChainEndpointConnections(graph, 0);
 
-    assert_return(blockdata.plugin != nullptr,);
+    for (const HostConnection& conn : graph)
+        _host.disconnect(conn.origin.c_str(), conn.target.c_str(), true);
+}
 
-    const unsigned int ioflags = Lv2PortIsAudio | (outputs ? Lv2PortIsOutput : 0);
-    unsigned int flagsToCheck = Lv2PortIsAudio | Lv2PortIsOutput;
-    if (!disconnectSideChains)
-        flagsToCheck |= Lv2PortIsSidechain;
-    std::string origin;
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::forgetAllInstances()
+{
+    forgetInstance(-1);
+    _mapper.reset();
+    _instancePool.clear();
+    _instancePoolSize = 0;
+    _current.numLoadedPlugins = 0;
+
+    // a prepared bank and leftovers of previous banks were removed too
+    _nextBank.mapper.reset();
+    _nextBank.ready = false;
+    _leftoverInstances.clear();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostReloadAllPresets()
+{
+    mod_log_debug("hostReloadAllPresets()");
+
+    // everything is loaded again, the previous preset of a running crossfade is gone too
+    _crossfade.fadingPreset = NUM_PRESETS_PER_BANK;
 
-    for (const Lv2Port& port : blockdata.plugin->ports)
+    for (DeferredPresetWork& work : _deferredWork)
     {
-        if ((port.flags & flagsToCheck) != ioflags)
-            continue;
+        work.type = DeferredPresetWork::kNone;
+        work.prev.reset();
+        work.tails.clear();
+    }
 
-        origin = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.id, port.symbol.c_str());
-        _host.disconnect_all(origin.c_str());
+    // side rows are setup again together with their sidechain blocks
+    for (uint8_t row = 1; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        _current.chains[row].capture.fill({});
+        _current.chains[row].playback.fill({});
+        _current.chains[row].captureId.fill(kMaxHostInstances);
+        _current.chains[row].playbackId.fill(kMaxHostInstances);
 
-        if (hbp.pair != kMaxHostInstances)
+        for (Preset& presetdata : _presets)
         {
-            origin = format(MOD_HOST_EFFECT_PREFIX "%d:%s", hbp.pair, port.symbol.c_str());
-            _host.disconnect_all(origin.c_str());
+            presetdata.chains[row].capture.fill({});
+            presetdata.chains[row].playback.fill({});
+            presetdata.chains[row].captureId.fill(kMaxHostInstances);
+            presetdata.chains[row].playbackId.fill(kMaxHostInstances);
         }
     }
+
+    // load the active preset first and make it audible right away
+    hostLoadPreset(_current.preset);
+
+    _host.feature_enable(Host::kFeatureProcessing, Host::kProcessingOnWithFadeIn);
+
+    // other presets are loaded later, in between user actions, in order
+    for (int pr = NUM_PRESETS_PER_BANK - 1; pr >= 0; --pr)
+    {
+        if (pr == _current.preset)
+            continue;
+
+        _deferredWork[pr].type = DeferredPresetWork::kLoad;
+        _deferredWork[pr].order = ++_deferredWorkCounter;
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostEnsureStereoChain(const uint8_t preset,
-                                          const uint8_t row,
-                                          const uint8_t blockStart,
-                                          const bool recursive)
+bool HostConnector::hostRunDeferredWork()
 {
-    mod_log_debug("hostEnsureStereoChain(%u, %u, %u, %s)", preset, row, blockStart, bool2str(recursive));
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(blockStart < NUM_BLOCKS_PER_PRESET);
-
-    const bool active = preset == _current.preset;
-    ChainRow& chain = active ? _current.chains[row] : _presets[preset].chains[row];
-    assert(!chain.capture[0].empty());
-    assert(!chain.capture[1].empty());
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
-    // bool changed = false;
-    bool previousPluginStereoOut = shouldBlockBeStereo(chain, blockStart);
+    // user-facing commands always take priority, wait until things are idle
+    if (now - _lastUserCommand < std::chrono::milliseconds(DEFERRED_WORK_IDLE_MS))
+        return false;
 
-    // ----------------------------------------------------------------------------------------------------------------
-    // part 1: deal with dual-mono and disconnect blocks where needed
+    const std::chrono::steady_clock::time_point deadline = now + std::chrono::milliseconds(DEFERRED_WORK_SLICE_MS);
+    bool worked = false;
 
-    bool sideChainToBeUpdated = false;
+    do {
+        // a requested preset switch is more important, leave the rest of the work for later
+        if (_requestedPreset.load() != NUM_PRESETS_PER_BANK)
+            break;
 
-    for (uint8_t bl = blockStart; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-    {
-        const Block& blockdata(chain.blocks[bl]);
-        if (isNullBlock(blockdata))
-            continue;
+        // restoring presets comes before loading new ones, most recently queued first
+        uint8_t preset = NUM_PRESETS_PER_BANK;
 
-        const bool oldDualmono = _mapper.get(preset, row, bl).pair != kMaxHostInstances;
-        // activate dual mono if previous plugin is stereo or also dualmono
-        bool newDualmono = false;
-        if (blockdata.meta.numInputs == 1) 
+        for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
         {
-            newDualmono = previousPluginStereoOut;
-            if ((blockdata.meta.numSideInputs != 0) && 
-                !newDualmono && 
-                (row + 1 < NUM_BLOCK_CHAIN_ROWS))
-            {
-                // if dual mono wasn't enforced by current row, it might be enforced by next row
-                ChainRow& chain2data(active ? _current.chains[row + 1] : _presets[preset].chains[row + 1]);
-                newDualmono = shouldBlockBeStereo(chain2data, NUM_BLOCKS_PER_PRESET);
-            }
-        }
+            const DeferredPresetWork& work = _deferredWork[pr];
 
-        previousPluginStereoOut = blockdata.meta.numOutputs == 2 || newDualmono;
+            if (work.type == DeferredPresetWork::kNone)
+                continue;
 
-        if (oldDualmono != newDualmono)
-        {
-            if (newDualmono)
+            // restoring defaults would cut blocks still ringing, wait for them to end
+            if (! work.tails.empty())
+                continue;
+
+            // same for a preset still heard through the crossfade mixer
+            if (pr == _crossfade.fadingPreset)
+                continue;
+
+            if (preset != NUM_PRESETS_PER_BANK)
             {
-                const uint16_t pair = _mapper.add_pair(preset, row, bl);
+                const DeferredPresetWork& next = _deferredWork[preset];
 
-                if (!hostLoadInstance(blockdata, pair, active))
-                {
-                    // adding pair failed
-                    // -> stereo chain will be summed to mono from here on
-                    _host.remove(_mapper.remove_pair(preset, row, bl));
-                    newDualmono = false;
+                if (work.type > next.type)
+                    continue;
+                if (work.type == next.type && work.order < next.order)
                     continue;
-                }
-
-                // reset original block instance so the pair of blocks are in sync
-                const HostBlockPair hbp = _mapper.get(preset, row, bl);
-                _host.pre_run(hbp.id, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, 0, nullptr);
             }
-            else
+
+            preset = pr;
+        }
+
+        if (preset == NUM_PRESETS_PER_BANK)
+        {
+            // instances of a previous bank go last, nothing uses them anymore
+            // same for spare instances kept from a previous bank that went over budget
+            if (! _leftoverInstances.empty() || _instancePoolSize > _instancePoolBudget)
             {
-                _host.remove(_mapper.remove_pair(preset, row, bl));
+                const Host::NonBlockingScope hnbs(_host);
+                hostRemoveLeftoverInstances();
+                hostTrimInstancePool(_instancePoolBudget);
+                worked = true;
             }
+            break;
         }
 
-        // disconnect also sidechain outputs in case of outdated connection
-        // (will be reconnected hostEnsureStereoChain(..., row + 1, ...))
-        if (active)
-            hostDisconnectAllBlockOutputs(row, bl, true);
+        DeferredPresetWork& work = _deferredWork[preset];
 
-        // redo sideIO (if applicable) due to add/remove
-        const HostBlockPair hbp = _mapper.get(preset, row, bl);
-        hostSetupSideIO(preset, row, bl, hbp);
+        const Host::NonBlockingScope hnbs(_host);
 
-        // NOTE: sidechain update not needed if mono -> dual mono update of sidechain playback target block
-        // was triggered from sidechain (recursive == true)
-        if ((blockdata.meta.numSideOutputs != 0) ||
-            (blockdata.meta.numSideInputs != 0 && !recursive))
+        // restore one block at a time, finishing up once all blocks are done
+        if (work.type == DeferredPresetWork::kRestoreDefaults &&
+            work.nextBlock < NUM_BLOCK_CHAIN_ROWS * NUM_BLOCKS_PER_PRESET)
         {
-            assert_continue(row + 1 < NUM_BLOCK_CHAIN_ROWS);
-            sideChainToBeUpdated = true;
+            hostRestorePresetBlock(preset,
+                                   *work.prev,
+                                   work.nextBlock / NUM_BLOCKS_PER_PRESET,
+                                   work.nextBlock % NUM_BLOCKS_PER_PRESET);
+            ++work.nextBlock;
+        }
+        else
+        {
+            hostEnsurePresetLoaded(preset);
         }
-    }
 
-    // after all required dual mono blocks have been created above, update "sidechain" mono/stereo setup
-    if (sideChainToBeUpdated)
-        hostEnsureStereoChain(preset, row + 1, 0, true);
+        worked = true;
+    } while (std::chrono::steady_clock::now() < deadline);
 
-    // ensure stereo / dual mono for possible other rows serving as playback targets
-    if (row > 0 && chain.playbackId[0] != kMaxHostInstances)
-    {
-        HostInstanceMapper::BlockAndRow blockRow = _mapper.get_block_with_id(preset, chain.playbackId[0]);
-        hostEnsureStereoChain(preset, blockRow.row, blockRow.block, true);
-    }
+    return worked;
+}
 
-    // ----------------------------------------------------------------------------------------------------------------
-    // part 2: handle connections (if active preset)
+// --------------------------------------------------------------------------------------------------------------------
 
-    if (! active)
-        return;
+void HostConnector::hostEnsurePresetLoaded(const uint8_t preset)
+{
+    assert(preset < NUM_PRESETS_PER_BANK);
+
+    DeferredPresetWork& work = _deferredWork[preset];
 
-    std::array<bool, NUM_BLOCKS_PER_PRESET> loaded;
-    uint8_t firstBlock = UINT8_MAX;
-    uint8_t lastBlock = UINT8_MAX;
-    uint8_t numLoadedPlugins = 0;
-    for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+    switch (work.type)
     {
-        if ((loaded[bl] = !isNullBlock(chain.blocks[bl])))
-        {
-            ++numLoadedPlugins;
+    case DeferredPresetWork::kNone:
+        return;
 
-            if (firstBlock == UINT8_MAX)
-                firstBlock = bl;
+    case DeferredPresetWork::kRestoreDefaults:
+        mod_log_debug("hostEnsurePresetLoaded(%u) - restoring defaults", preset);
 
-            lastBlock = bl;
+        hostEndSpillover(preset);
+
+        for (; work.nextBlock < NUM_BLOCK_CHAIN_ROWS * NUM_BLOCKS_PER_PRESET; ++work.nextBlock)
+        {
+            hostRestorePresetBlock(preset,
+                                   *work.prev,
+                                   work.nextBlock / NUM_BLOCKS_PER_PRESET,
+                                   work.nextBlock % NUM_BLOCKS_PER_PRESET);
         }
+
+        work.type = DeferredPresetWork::kNone;
+        work.prev.reset();
+
+        // ensure necessary dual mono blocks are added
+        // NOTE connections are only made for the active preset, so this does not connect anything here
+        hostEnsureStereoChain(preset, 0);
+        return;
+
+    case DeferredPresetWork::kLoad:
+        mod_log_debug("hostEnsurePresetLoaded(%u) - loading", preset);
+
+        work.type = DeferredPresetWork::kNone;
+        hostLoadPreset(preset);
+        break;
     }
 
-    if (numLoadedPlugins == 0)
+    for (const DeferredPresetWork& other : _deferredWork)
     {
-        // direct connections
-        hostConnectChainEndpoints(row);
-        return;
+        if (other.type == DeferredPresetWork::kLoad)
+            return;
     }
 
-    assert(firstBlock != UINT8_MAX);
-    assert(lastBlock != UINT8_MAX);
+    _bankLoadTimings.fullyLoaded = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _bankLoadStart).count();
 
-    // direct connections
-    hostDisconnectChainEndpoints(row);
+    mod_log_info("bank fully loaded after %u ms", _bankLoadTimings.fullyLoaded);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::swapPreparedBank()
+{
+    std::swap(_presets, _nextBank.presets);
+    std::swap(_presetsAsLoaded, _nextBank.presetsAsLoaded);
+    std::swap(_mapper, _nextBank.mapper);
+    std::swap(_instancePool, _nextBank.instancePool);
+    std::swap(_instancePoolSize, _nextBank.instancePoolSize);
+}
 
-    // first and last blocks
-    hostConnectBlockToChainInput(row, firstBlock);
-    hostConnectBlockToChainOutput(row, lastBlock);
+void HostConnector::hostSwitchToPreparedBank(const uint8_t preset)
+{
+    mod_log_debug("hostSwitchToPreparedBank(%u)", preset);
+    assert(preset < NUM_PRESETS_PER_BANK);
+    assert(_nextBank.ready);
 
-    // in between blocks
-    for (uint8_t bl1 = firstBlock; bl1 <= lastBlock && bl1 < NUM_BLOCKS_PER_PRESET; ++bl1)
+    if (_crossfade.fadingPreset != NUM_PRESETS_PER_BANK)
     {
-        if (! loaded[bl1])
-            continue;
+        const Host::NonBlockingScope hnbs(_host);
+        hostEndCrossfade();
+    }
 
-        for (uint8_t bl2 = bl1 + 1; bl2 < NUM_BLOCKS_PER_PRESET; ++bl2)
+    // instances of the previous active preset, deactivated during the switch
+    std::vector<int16_t> prevInstances;
+    prevInstances.reserve(kMaxHostInstancesPerBank);
+
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
         {
-            if (! loaded[bl2])
+            const HostBlockPair hbp = _mapper.get(_current.preset, row, bl);
+
+            if (hbp.id == kMaxHostInstances)
                 continue;
 
-            hostConnectBlockToBlock(row, bl1, bl2);
-            break;
+            prevInstances.push_back(hbp.id);
+
+            if (hbp.pair != kMaxHostInstances)
+                prevInstances.push_back(hbp.pair);
         }
     }
+
+    // everything from the previous bank is removed later, spare instances included
+    getAllMappedInstances(_mapper, _leftoverInstances);
+
+    for (const auto& spares : _instancePool)
+        _leftoverInstances.insert(_leftoverInstances.end(), spares.second.begin(), spares.second.end());
+
+    _instancePool.clear();
+    _instancePoolSize = 0;
+
+    swapPreparedBank();
+    _nextBank.ready = false;
+
+    // pending work and switch requests refer to the previous bank
+    for (DeferredPresetWork& work : _deferredWork)
+    {
+        work.type = DeferredPresetWork::kNone;
+        work.prev.reset();
+        work.tails.clear();
+    }
+
+    _requestedPreset = NUM_PRESETS_PER_BANK;
+
+    static_cast<Preset&>(_current) = _presets[preset];
+    _current.preset = preset;
+    _current.defaultScene = _current.scene;
+    _current.dirty = false;
+    _current.numLoadedPlugins = 0;
+
+    std::vector<int16_t> instances;
+    instances.reserve(kMaxHostInstancesPerBank);
+
+    // side IO of the new preset must be known before figuring out its connections
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        {
+            if (isNullBlock(_current.chains[row].blocks[bl]))
+                continue;
+
+            const HostBlockPair hbp = _mapper.get(preset, row, bl);
+            assert_continue(hbp.id != kMaxHostInstances);
+
+            hostSetupSideIO(preset, row, bl, hbp);
+            ++_current.numLoadedPlugins;
+
+            instances.push_back(hbp.id);
+
+            if (hbp.pair != kMaxHostInstances)
+                instances.push_back(hbp.pair);
+        }
+    }
+
+    HostConnectionGraph graph;
+    getConnections(graph);
+
+    // same as a regular preset switch, only across instance ranges
+    // audio fades keep the swap of active instances and connections from being heard as clicks
+    const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+
+    hostRemoveOutdatedConnections(graph);
+
+    switch (prevInstances.size())
+    {
+    case 0:
+        break;
+    case 1:
+        _host.activate(prevInstances.front(), false);
+        break;
+    default:
+        _host.multi_activate(false, prevInstances.size(), prevInstances.data());
+        break;
+    }
+
+    switch (instances.size())
+    {
+    case 0:
+        break;
+    case 1:
+        _host.activate(instances.front(), true);
+        break;
+    default:
+        _host.multi_activate(true, instances.size(), instances.data());
+        break;
+    }
+
+    hostAddMissingConnections(graph);
+}
+
+void HostConnector::hostDropPreparedBank()
+{
+    if (_nextBank.ready)
+    {
+        mod_log_debug("hostDropPreparedBank()");
+
+        getAllMappedInstances(_nextBank.mapper, _leftoverInstances);
+        _nextBank.ready = false;
+    }
+
+    hostRemoveLeftoverInstances();
+
+    _nextBank.mapper.reset();
+}
+
+void HostConnector::hostRemoveLeftoverInstances()
+{
+    if (_leftoverInstances.empty())
+        return;
+
+    mod_log_debug("hostRemoveLeftoverInstances() - %zu instances", _leftoverInstances.size());
+
+    switch (_leftoverInstances.size())
+    {
+    case 1:
+        _host.remove(_leftoverInstances.front());
+        break;
+    default:
+        _host.multi_remove(_leftoverInstances.size(), _leftoverInstances.data());
+        break;
+    }
+
+    for (const int16_t id : _leftoverInstances)
+        forgetInstance(id);
+
+    _leftoverInstances.clear();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+const std::array<std::string, 2>& HostConnector::getChainPlayback(const uint8_t row) const
+{
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+
+    if (row == 0 && ! _crossfade.mixSymbol.empty())
+        return _crossfade.inputs[_crossfade.active];
+
+    return _current.chains[row].playback;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::addChainEndpointConnections(HostConnectionGraph& graph, const uint8_t row) const
+{
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+
+    const ChainRow& chain(_current.chains[row]);
+    const std::array<std::string, 2>& playback(getChainPlayback(row));
+    assert(!chain.capture[0].empty());
+    assert(!chain.capture[1].empty());
+
+    if (row == 0)
+    {
+        // playback side cannot be empty
+        assert(!playback[0].empty());
+    }
+    else
+    {
+        // playback side is allowed to be empty
+        if (playback[0].empty())
+            return;
+    }
+
+    assert(!playback[1].empty());
+
+    graph.insert({ chain.capture[0], playback[0], true });
+    graph.insert({ chain.capture[1], playback[1], true });
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::addChainInputConnections(HostConnectionGraph& graph, const uint8_t row, const uint8_t block) const
+{
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(!isNullBlock(_current.chains[row].blocks[block]));
+
+    const Block& blockdata(_current.chains[row].blocks[block]);
+    assert_return(blockdata.plugin != nullptr,);
+
+    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
+    assert_return(hbp.id != kMaxHostInstances,);
+
+    for (size_t i = 0, j = 0; i < blockdata.plugin->ports.size() && j < 2; ++i)
+    {
+        if ((blockdata.plugin->ports[i].flags & (Lv2PortIsAudio|Lv2PortIsOutput)) != Lv2PortIsAudio)
+            continue;
+        if ((blockdata.plugin->ports[i].flags & Lv2PortIsSidechain) != 0)
+            continue;
+
+        const std::string& origin = _current.chains[row].capture[j++];
+        assert_continue(!origin.empty());
+        graph.insert({ origin, getInstancePortName(hbp.id, blockdata.plugin, i) });
+
+        if (hbp.pair != kMaxHostInstances)
+        {
+            const std::string& origin2 = _current.chains[row].capture[j++];
+            assert_continue(!origin2.empty());
+            graph.insert({ origin2, getInstancePortName(hbp.pair, blockdata.plugin, i) });
+            return;
+        }
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::addChainOutputConnections(HostConnectionGraph& graph, const uint8_t row, const uint8_t block) const
+{
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+
+    const ChainRow& chain(_current.chains[row]);
+    const std::array<std::string, 2>& playback(getChainPlayback(row));
+    assert(!isNullBlock(chain.blocks[block]));
+
+    // playback side is allowed to be empty
+    if (playback[0].empty())
+        return;
+
+    assert(!playback[1].empty());
+
+    const Block& blockdata(chain.blocks[block]);
+    assert_return(blockdata.plugin != nullptr,);
+
+    const HostBlockPair hbp = _mapper.get(_current.preset, row, block);
+    assert_return(hbp.id != kMaxHostInstances,);
+
+    addBlockOutputConnections(graph, hbp, blockdata.plugin, playback);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::addBlockOutputConnections(HostConnectionGraph& graph,
+                                              const HostBlockPair& hbp,
+                                              const std::shared_ptr<const Lv2Plugin>& plugin,
+                                              const std::array<std::string, 2>& playback) const
+{
+    assert(hbp.id != kMaxHostInstances);
+    assert(plugin != nullptr);
+
+    const std::string* origin = nullptr;
+    int dsti = 0;
+
+    for (size_t i = 0; i < plugin->ports.size() && dsti < 2; ++i)
+    {
+        if ((plugin->ports[i].flags & (Lv2PortIsAudio|Lv2PortIsOutput)) != (Lv2PortIsAudio|Lv2PortIsOutput))
+            continue;
+        if ((plugin->ports[i].flags & Lv2PortIsSidechain) != 0)
+            continue;
+
+        origin = &getInstancePortName(hbp.id, plugin, i);
+        graph.insert({ *origin, playback[dsti++] });
+
+        if (hbp.pair != kMaxHostInstances)
+        {
+            origin = &getInstancePortName(hbp.pair, plugin, i);
+            graph.insert({ *origin, playback[dsti++] });
+            return;
+        }
+    }
+
+    if (dsti == 1)
+        graph.insert({ *origin, playback[1] });
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::addBlockToBlockConnections(HostConnectionGraph& graph,
+                                               const uint8_t row,
+                                               const uint8_t blockA,
+                                               const uint8_t blockB) const
+{
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(blockA < NUM_BLOCKS_PER_PRESET);
+    assert(blockB < NUM_BLOCKS_PER_PRESET);
+
+    const Block& blockdataA(_current.chains[row].blocks[blockA]);
+    assert_return(blockdataA.plugin != nullptr,);
+
+    const Block& blockdataB(_current.chains[row].blocks[blockB]);
+    assert_return(blockdataB.plugin != nullptr,);
+
+    const HostBlockPair hbpA = _mapper.get(_current.preset, row, blockA);
+    assert_return(hbpA.id != kMaxHostInstances,);
+
+    const HostBlockPair hbpB = _mapper.get(_current.preset, row, blockB);
+    assert_return(hbpB.id != kMaxHostInstances,);
+
+    // collect audio ports from each block
+    std::vector<const char*> portsA;
+    std::vector<const char*> portsB;
+    portsA.reserve(2);
+    portsB.reserve(2);
+
+    constexpr uint32_t testFlags = Lv2PortIsAudio|Lv2PortIsOutput|Lv2PortIsSidechain;
+    for (size_t i = 0; i < blockdataA.plugin->ports.size(); ++i)
+    {
+        if ((blockdataA.plugin->ports[i].flags & testFlags) != (Lv2PortIsAudio|Lv2PortIsOutput))
+            continue;
+
+        portsA.push_back(getInstancePortName(hbpA.id, blockdataA.plugin, i).c_str());
+
+        if (hbpA.pair != kMaxHostInstances)
+        {
+            portsA.push_back(getInstancePortName(hbpA.pair, blockdataA.plugin, i).c_str());
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < blockdataB.plugin->ports.size(); ++i)
+    {
+        if ((blockdataB.plugin->ports[i].flags & testFlags) != Lv2PortIsAudio)
+            continue;
+
+        portsB.push_back(getInstancePortName(hbpB.id, blockdataB.plugin, i).c_str());
+
+        if (hbpB.pair != kMaxHostInstances)
+        {
+            portsB.push_back(getInstancePortName(hbpB.pair, blockdataB.plugin, i).c_str());
+            break;
+        }
+    }
+
+    assert_return(!portsA.empty(),);
+    assert_return(!portsB.empty(),);
+
+    graph.insert({ portsA[0], portsB[0] });
+
+    /**/ if (portsA.size() > portsB.size())
+        graph.insert({ portsA[1], portsB[0] });
+    else if (portsA.size() < portsB.size())
+        graph.insert({ portsA[0], portsB[1] });
+    else if (portsA.size() == 2)
+        graph.insert({ portsA[1], portsB[1] });
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostDisconnectBlockAction(const Block& blockdata,
+                                              const HostBlockPair& hbp,
+                                              const bool outputs,
+                                              const bool disconnectSideChains)
+{
+    mod_log_debug("hostDisconnectBlockAction(..., {%u, %u}, %s, %s)",
+                  hbp.id, hbp.pair, bool2str(outputs), bool2str(disconnectSideChains));
+    assert(!isNullBlock(blockdata));
+    assert(hbp.id != kMaxHostInstances);
+
+    assert_return(blockdata.plugin != nullptr,);
+
+    const unsigned int ioflags = Lv2PortIsAudio | (outputs ? Lv2PortIsOutput : 0);
+    unsigned int flagsToCheck = Lv2PortIsAudio | Lv2PortIsOutput;
+    if (!disconnectSideChains)
+        flagsToCheck |= Lv2PortIsSidechain;
+
+    for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
+    {
+        if ((blockdata.plugin->ports[i].flags & flagsToCheck) != ioflags)
+            continue;
+
+        _host.disconnect_all(getInstancePortName(hbp.id, blockdata.plugin, i).c_str());
+
+        if (hbp.pair != kMaxHostInstances)
+            _host.disconnect_all(getInstancePortName(hbp.pair, blockdata.plugin, i).c_str());
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostEnsureStereoChain(const uint8_t preset,
+                                          const uint8_t row,
+                                          const uint8_t blockStart,
+                                          const bool recursive)
+{
+    mod_log_debug("hostEnsureStereoChain(%u, %u, %u, %s)", preset, row, blockStart, bool2str(recursive));
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(blockStart < NUM_BLOCKS_PER_PRESET);
+
+    const bool active = preset == _current.preset;
+    ChainRow& chain = active ? _current.chains[row] : _presets[preset].chains[row];
+    assert(!chain.capture[0].empty());
+    assert(!chain.capture[1].empty());
+
+    // bool changed = false;
+    bool previousPluginStereoOut = shouldBlockBeStereo(chain, blockStart);
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // part 1: deal with dual-mono where needed
+
+    bool sideChainToBeUpdated = false;
+
+    for (uint8_t bl = blockStart; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+    {
+        const Block& blockdata(chain.blocks[bl]);
+        if (isNullBlock(blockdata))
+            continue;
+
+        const bool oldDualmono = _mapper.get(preset, row, bl).pair != kMaxHostInstances;
+        // activate dual mono if previous plugin is stereo or also dualmono
+        bool newDualmono = false;
+        if (blockdata.meta.numInputs == 1) 
+        {
+            newDualmono = previousPluginStereoOut;
+            if ((blockdata.meta.numSideInputs != 0) && 
+                !newDualmono && 
+                (row + 1 < NUM_BLOCK_CHAIN_ROWS))
+            {
+                // if dual mono wasn't enforced by current row, it might be enforced by next row
+                ChainRow& chain2data(active ? _current.chains[row + 1] : _presets[preset].chains[row + 1]);
+                newDualmono = shouldBlockBeStereo(chain2data, NUM_BLOCKS_PER_PRESET);
+            }
+        }
+
+        previousPluginStereoOut = blockdata.meta.numOutputs == 2 || newDualmono;
+
+        if (oldDualmono != newDualmono)
+        {
+            if (newDualmono)
+            {
+                const uint16_t pair = _mapper.add_pair(preset, row, bl);
+
+                if (!hostLoadInstance(blockdata, pair, active))
+                {
+                    // adding pair failed
+                    // -> stereo chain will be summed to mono from here on
+                    _host.remove(_mapper.remove_pair(preset, row, bl));
+                    forgetInstance(pair);
+                    newDualmono = false;
+                    continue;
+                }
+
+                // reset original block instance so the pair of blocks are in sync
+                const HostBlockPair hbp = _mapper.get(preset, row, bl);
+                _host.pre_run(hbp.id, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, 0, nullptr);
+            }
+            else
+            {
+                const uint16_t pair = _mapper.remove_pair(preset, row, bl);
+                _host.remove(pair);
+                forgetInstance(pair);
+            }
+        }
+
+        // redo sideIO (if applicable) due to add/remove
+        const HostBlockPair hbp = _mapper.get(preset, row, bl);
+        hostSetupSideIO(preset, row, bl, hbp);
+
+        // NOTE: sidechain update not needed if mono -> dual mono update of sidechain playback target block
+        // was triggered from sidechain (recursive == true)
+        if ((blockdata.meta.numSideOutputs != 0) ||
+            (blockdata.meta.numSideInputs != 0 && !recursive))
+        {
+            assert_continue(row + 1 < NUM_BLOCK_CHAIN_ROWS);
+            sideChainToBeUpdated = true;
+        }
+    }
+
+    // after all required dual mono blocks have been created above, update "sidechain" mono/stereo setup
+    if (sideChainToBeUpdated)
+        hostEnsureStereoChain(preset, row + 1, 0, true);
+
+    // ensure stereo / dual mono for possible other rows serving as playback targets
+    if (row > 0 && chain.playbackId[0] != kMaxHostInstances)
+    {
+        HostInstanceMapper::BlockAndRow blockRow = _mapper.get_block_with_id(preset, chain.playbackId[0]);
+        hostEnsureStereoChain(preset, blockRow.row, blockRow.block, true);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // part 2: handle connections (if active preset), once all recursive changes are done
+
+    if (! active || recursive)
+        return;
+
+    hostUpdateConnections();
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -4902,21 +6440,17 @@ void HostConnector::hostSetupSideIO(const uint8_t preset,
         constexpr uint32_t flagsToCheck = Lv2PortIsAudio|Lv2PortIsSidechain|Lv2PortIsOutput;
         constexpr uint32_t flagsWanted = Lv2PortIsAudio|Lv2PortIsSidechain;
 
-        for (const Lv2Port& port : blockdata.plugin->ports)
+        for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
         {
-            if ((port.flags & flagsToCheck) != flagsWanted)
+            if ((blockdata.plugin->ports[i].flags & flagsToCheck) != flagsWanted)
                 continue;
 
-            nextChainRow.playback[0] = format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                          hbp.id,
-                                                          port.symbol.c_str());
+            nextChainRow.playback[0] = getInstancePortName(hbp.id, blockdata.plugin, i);
             nextChainRow.playbackId[0] = hbp.id;
 
             if (hbp.pair != kMaxHostInstances)
             {
-                nextChainRow.playback[1] = format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                              hbp.pair,
-                                                              port.symbol.c_str());
+                nextChainRow.playback[1] = getInstancePortName(hbp.pair, blockdata.plugin, i);
                 nextChainRow.playbackId[1] = hbp.pair;
             }
             else
@@ -4932,21 +6466,17 @@ void HostConnector::hostSetupSideIO(const uint8_t preset,
     {
         constexpr uint32_t flags = Lv2PortIsAudio|Lv2PortIsSidechain|Lv2PortIsOutput;
 
-        for (const Lv2Port& port : blockdata.plugin->ports)
+        for (size_t i = 0; i < blockdata.plugin->ports.size(); ++i)
         {
-            if ((port.flags & flags) != flags)
+            if ((blockdata.plugin->ports[i].flags & flags) != flags)
                 continue;
 
-            nextChainRow.capture[0] = format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                         hbp.id,
-                                                         port.symbol.c_str());
+            nextChainRow.capture[0] = getInstancePortName(hbp.id, blockdata.plugin, i);
             nextChainRow.captureId[0] = hbp.id;
 
             if (hbp.pair != kMaxHostInstances)
             {
-                nextChainRow.capture[1] = format(MOD_HOST_EFFECT_PREFIX "%d:%s",
-                                                             hbp.pair,
-                                                             port.symbol.c_str());
+                nextChainRow.capture[1] = getInstancePortName(hbp.pair, blockdata.plugin, i);
                 nextChainRow.captureId[1] = hbp.pair;
             }
             else
@@ -4967,9 +6497,19 @@ void HostConnector::hostRemoveAllBlockBindings(const uint8_t row, const uint8_t
     assert(row < NUM_BLOCK_CHAIN_ROWS);
     assert(block < NUM_BLOCKS_PER_PRESET);
 
-    Block& blockdata(_current.chains[row].blocks[block]);
+    if (removeAllBlockBindings(_current, row, block))
+        _current.dirty = true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::removeAllBlockBindings(Preset& presetdata, const uint8_t row, const uint8_t block) const
+{
+    Block& blockdata(presetdata.chains[row].blocks[block]);
     assert(!isNullBlock(blockdata));
 
+    bool removed = false;
+
     blockdata.meta.enable.hwbinding = UINT8_MAX;
 
     for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
@@ -4992,9 +6532,9 @@ void HostConnector::hostRemoveAllBlockBindings(const uint8_t row, const uint8_t
 
     for (uint8_t hwid = 0; hwid < NUM_BINDING_ACTUATORS; ++hwid)
     {
-        _current.bindings[hwid].value = 0.0;
+        presetdata.bindings[hwid].value = 0.0;
 
-        std::list<ParameterBinding>& bindings(_current.bindings[hwid].parameters);
+        std::list<ParameterBinding>& bindings(presetdata.bindings[hwid].parameters);
 
     restartParameter:
         for (ParameterBindingIteratorConst it = bindings.cbegin(), end = bindings.cend(); it != end; ++it)
@@ -5005,16 +6545,16 @@ void HostConnector::hostRemoveAllBlockBindings(const uint8_t row, const uint8_t
                 continue;
 
             bindings.erase(it);
-            _current.dirty = true;
+            removed = true;
             goto restartParameter;
         }
     }
 
     for (uint8_t hwid = 0; hwid < NUM_BINDING_ACTUATORS; ++hwid)
     {
-        _current.bindings[hwid].value = 0.0;
+        presetdata.bindings[hwid].value = 0.0;
 
-        std::list<PropertyBinding>& bindings(_current.bindings[hwid].properties);
+        std::list<PropertyBinding>& bindings(presetdata.bindings[hwid].properties);
 
     restartProperty:
         for (PropertyBindingIteratorConst it = bindings.cbegin(), end = bindings.cend(); it != end; ++it)
@@ -5024,43 +6564,230 @@ void HostConnector::hostRemoveAllBlockBindings(const uint8_t row, const uint8_t
             if (it->block != block)
                 continue;
 
-            bindings.erase(it);
-            _current.dirty = true;
-            goto restartProperty;
-        }
+            bindings.erase(it);
+            removed = true;
+            goto restartProperty;
+        }
+    }
+
+    return removed;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostRemoveInstanceForBlock(const uint8_t row, const uint8_t block)
+{
+    mod_log_debug("hostRemoveInstanceForBlock(%u, %u)", row, block);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+
+    hostReleaseInstanceForBlock(_current.preset, row, block, _current.chains[row].blocks[block]);
+
+   #if NUM_BLOCK_CHAIN_ROWS != 1
+    if (row == 0)
+    {
+        const Block& blockdata(_current.chains[row].blocks[block]);
+        assert(!isNullBlock(blockdata));
+
+        if (blockdata.meta.numSideInputs != 0)
+        {
+            _current.chains[row + 1].playback.fill({});
+            _current.chains[row + 1].playbackId.fill(kMaxHostInstances);
+        }
+
+        if (blockdata.meta.numSideOutputs != 0)
+        {
+            _current.chains[row + 1].capture.fill({});
+            _current.chains[row + 1].captureId.fill(kMaxHostInstances);
+        }
+    }
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::hostPreloadInstanceForBlock(const uint8_t preset,
+                                                const uint8_t row,
+                                                const uint8_t block,
+                                                const char* const uri,
+                                                uint16_t& id)
+{
+    mod_log_debug("hostPreloadInstanceForBlock(%u, %u, %u, \"%s\", ...)", preset, row, block, uri);
+
+    if (takeSpareInstance(uri, id))
+    {
+        _mapper.attach(preset, row, block, id);
+        mod_log_debug("block %u reusing spare instance %u for plugin %s", block, id, uri);
+        return true;
+    }
+
+    id = _mapper.add(preset, row, block);
+    return _host.preload(uri, id);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+bool HostConnector::takeSpareInstance(const char* const uri, uint16_t& id)
+{
+    const auto it = _instancePool.find(uri);
+    if (it == _instancePool.end())
+        return false;
+
+    id = it->second.back();
+    it->second.pop_back();
+    --_instancePoolSize;
+
+    if (it->second.empty())
+        _instancePool.erase(it);
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostReleaseInstanceForBlock(const uint8_t preset,
+                                                const uint8_t row,
+                                                const uint8_t block,
+                                                const Block& blockdata)
+{
+    mod_log_debug("hostReleaseInstanceForBlock(%u, %u, %u, ...)", preset, row, block);
+
+    if (const HostBlockPair hbp = _mapper.detach(preset, row, block); hbp.id != kMaxHostInstances)
+        hostReleaseBlockPair(hbp, blockdata);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostReleaseBlockPair(const HostBlockPair& hbp, const Block& blockdata)
+{
+    assert(hbp.id != kMaxHostInstances);
+
+    const uint16_t numInstances = hbp.pair != kMaxHostInstances ? 2 : 1;
+
+    // remove right away if there is no space left for spare instances
+    if (isNullBlock(blockdata) || blockdata.plugin == nullptr || _instancePoolSize + numInstances > _instancePoolBudget)
+    {
+        _mapper.release(hbp.id);
+        if (hbp.pair != kMaxHostInstances)
+            _mapper.release(hbp.pair);
+
+        hostRemoveBlockPair(hbp);
+        return;
+    }
+
+    hostKeepBlockPairAsSpare(hbp, blockdata);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostKeepBlockPairAsSpare(const HostBlockPair& hbp, const Block& blockdata)
+{
+    assert(hbp.id != kMaxHostInstances);
+    assert(!isNullBlock(blockdata));
+
+    // bring instance(s) back to the same state as a freshly preloaded plugin
+    if (hbp.pair != kMaxHostInstances)
+    {
+        const int16_t instances[2] = { static_cast<int16_t>(hbp.id), static_cast<int16_t>(hbp.pair) };
+        _host.multi_activate(false, 2, instances);
+    }
+    else
+    {
+        _host.activate(hbp.id, false);
+    }
+
+    // drop everything, including connections not part of the chain (e.g. to tools)
+    hostDisconnectBlockAction(blockdata, hbp, false, true);
+    hostDisconnectBlockAction(blockdata, hbp, true, true);
+    forgetConnections(hbp.id);
+    if (hbp.pair != kMaxHostInstances)
+        forgetConnections(hbp.pair);
+
+    if (!blockdata.enabled)
+        hostBypassBlockPair(hbp, false);
+
+    std::vector<flushed_param> params;
+    params.reserve(MAX_PARAMS_PER_BLOCK);
+
+    for (const Parameter& paramdata : blockdata.parameters)
+    {
+        if (isNullURI(paramdata.symbol))
+            break;
+        if ((paramdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+            continue;
+        if (isNotEqual(paramdata.value, paramdata.meta.defttl))
+            params.push_back({ paramdata.symbol.c_str(), paramdata.meta.defttl });
+    }
+
+    for (const Property& propdata : blockdata.properties)
+    {
+        if (isNullURI(propdata.uri))
+            break;
+        if ((propdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
+            continue;
+        if (propdata.value == propdata.meta.defpath)
+            continue;
+
+        _host.patch_set(hbp.id, propdata.uri.c_str(), propdata.meta.defpath.c_str());
+
+        if (hbp.pair != kMaxHostInstances)
+            _host.patch_set(hbp.pair, propdata.uri.c_str(), propdata.meta.defpath.c_str());
     }
+
+    hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, params);
+
+    std::vector<uint16_t>& spares = _instancePool[blockdata.uri];
+    spares.push_back(hbp.id);
+    if (hbp.pair != kMaxHostInstances)
+        spares.push_back(hbp.pair);
+
+    _instancePoolSize += hbp.pair != kMaxHostInstances ? 2 : 1;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostRemoveInstanceForBlock(const uint8_t row, const uint8_t block)
+void HostConnector::hostTrimInstancePool(const uint16_t size)
 {
-    mod_log_debug("hostRemoveInstanceForBlock(%u, %u)", row, block);
-    assert(row < NUM_BLOCK_CHAIN_ROWS);
-    assert(block < NUM_BLOCKS_PER_PRESET);
+    if (_instancePoolSize <= size)
+        return;
 
-    if (const HostBlockPair hbp = _mapper.remove(_current.preset, row, block); hbp.id != kMaxHostInstances)
-        hostRemoveBlockPair(hbp);
+    mod_log_debug("hostTrimInstancePool(%u)", size);
 
-   #if NUM_BLOCK_CHAIN_ROWS != 1
-    if (row == 0)
+    std::vector<int16_t> instances;
+    instances.reserve(_instancePoolSize - size);
+
+    for (auto it = _instancePool.begin(); it != _instancePool.end() && _instancePoolSize > size;)
     {
-        const Block& blockdata(_current.chains[row].blocks[block]);
-        assert(!isNullBlock(blockdata));
+        std::vector<uint16_t>& spares = it->second;
 
-        if (blockdata.meta.numSideInputs != 0)
+        while (!spares.empty() && _instancePoolSize > size)
         {
-            _current.chains[row + 1].playback.fill({});
-            _current.chains[row + 1].playbackId.fill(kMaxHostInstances);
+            instances.push_back(spares.back());
+            _mapper.release(spares.back());
+            spares.pop_back();
+            --_instancePoolSize;
         }
 
-        if (blockdata.meta.numSideOutputs != 0)
-        {
-            _current.chains[row + 1].capture.fill({});
-            _current.chains[row + 1].captureId.fill(kMaxHostInstances);
-        }
+        if (spares.empty())
+            it = _instancePool.erase(it);
+        else
+            ++it;
     }
-   #endif
+
+    switch (instances.size())
+    {
+    case 0:
+        break;
+    case 1:
+        _host.remove(instances.front());
+        break;
+    default:
+        _host.multi_remove(instances.size(), instances.data());
+        break;
+    }
+
+    for (const int16_t id : instances)
+        forgetInstance(id);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -5176,15 +6903,15 @@ void HostConnector::jsonPresetLoad(Preset& presetdata, const nlohmann::json& jpr
                     continue;
                 }
 
-                uint8_t numInputs, numOutputs, numSideInputs, numSideOutputs;
-                if (!getSupportedPluginIO(plugin, numInputs, numOutputs, numSideInputs, numSideOutputs))
+                const BlockPrototype& proto = getBlockPrototype(plugin);
+                if (!proto.supportedIO)
                 {
                     mod_log_info("jsonPresetLoad(): plugin with uri '%s' has invalid IO, using empty block", uri.c_str());
                     resetBlock(blockdata);
                     continue;
                 }
 
-                initBlock(blockdata, plugin, numInputs, numOutputs, numSideInputs, numSideOutputs);
+                initBlock(blockdata, proto);
 
                 // ----------------------------------------------------------------------------------------------------
                 // enabled
@@ -6105,490 +7832,920 @@ void HostConnector::jsonPresetSave(const Preset& presetdata, nlohmann::json& jpr
                     }
                 }
 
-                {
-                    auto& jprops = jblock["properties"];
+                {
+                    auto& jprops = jblock["properties"];
+
+                    for (uint8_t p = 0, jp = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+                    {
+                        const Property& propdata = blockdata.properties[p];
+
+                        if (isNullURI(propdata.uri))
+                            break;
+                        if (! shouldSavePropertyToPreset(propdata.meta.flags))
+                            continue;
+
+                        const std::string jpropid = std::to_string(++jp);
+                        jprops[jpropid] = nlohmann::json::object({
+                            { "uri", propdata.uri },
+                            { "name", propdata.meta.name },
+                            { "value", propdata.value },
+                        });
+                    }
+                }
+
+                if (blockdata.meta.numParametersInScenes + blockdata.meta.numPropertiesInScenes != 0)
+                {
+                    auto& jscenes = jblock["scenes"];
+
+                    for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+                    {
+                        const std::string jsceneid = std::to_string(s + 1);
+                        auto& jscene = jscenes[jsceneid] = nlohmann::json::object({
+                            { "parameters", nlohmann::json::array() },
+                            { "properties", nlohmann::json::array() },
+                        });
+
+                        if (blockdata.meta.enable.hasScenes)
+                            jscene["enabled"] = blockdata.sceneValues[s].enabled;
+
+                        {
+                            auto& jsceneparams = jscene["parameters"];
+
+                            for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+                            {
+                                const Parameter& paramdata = blockdata.parameters[p];
+
+                                if (isNullURI(paramdata.symbol))
+                                    break;
+                                if (! shouldSaveParameterToPreset(paramdata.meta.flags))
+                                    continue;
+                                if ((paramdata.meta.flags & Lv2ParameterInScene) == 0)
+                                    continue;
+
+                                jsceneparams.push_back(nlohmann::json::object({
+                                    { "symbol", paramdata.symbol },
+                                    { "value", blockdata.sceneValues[s].parameters[p] },
+                                }));
+                            }
+                        }
+
+                        {
+                            auto& jsceneprops = jscene["properties"];
+
+                            for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+                            {
+                                const Property& propdata = blockdata.properties[p];
+
+                                if (isNullURI(propdata.uri))
+                                    break;
+                                if (! shouldSavePropertyToPreset(propdata.meta.flags))
+                                    continue;
+                                if ((propdata.meta.flags & Lv2ParameterInScene) == 0)
+                                    continue;
+
+                                jsceneprops.push_back(nlohmann::json::object({
+                                    { "uri", propdata.uri },
+                                    { "value", blockdata.sceneValues[s].properties[p] },
+                                }));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // sceneNames
+
+    for (const std::string& sceneName : presetdata.sceneNames)
+    {
+        if (sceneName.empty())
+            continue;
+
+        auto& jsceneNames = jpreset["sceneNames"] = nlohmann::json::object({});
+        for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+        {
+            const std::string jsceneid = std::to_string(s + 1);
+            jsceneNames[jsceneid] = presetdata.sceneNames[s];
+        }
+        break;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostLoadPreset(const uint8_t preset)
+{
+    mod_log_debug("hostLoadPreset(%u)", preset);
+
+    if (_current.preset == preset) {
+        assert(_current.numLoadedPlugins == 0);
+    }
+
+    const bool active = _current.preset == preset;
+    const Preset& presetdata(active ? static_cast<const Preset&>(_current) : _presets[preset]);
+
+    // the active preset data can only use a cached program while unmodified since its switch or load
+    // NOTE values not saved to presets are reset by this, same as when switching presets
+    const bool cacheable = _presetsAsLoaded[preset]
+                        && (! active || (_current.dirty == 0 && _current.uuid == _presets[preset].uuid));
+
+    HostLoadProgram uncached;
+    HostLoadProgram* program = cacheable ? getCachedLoadProgram(presetdata) : nullptr;
+
+    if (program != nullptr)
+    {
+        mod_log_debug("hostLoadPreset(%u): using cached load program", preset);
+        mapLoadProgram(*program, preset);
+    }
+    else
+    {
+        if (cacheable)
+        {
+            // replace an unused program, or the least recently used one
+            program = &_loadPrograms.front();
+            for (HostLoadProgram& other : _loadPrograms)
+            {
+                if (! other.valid)
+                {
+                    program = &other;
+                    break;
+                }
+                if (other.lastUsed < program->lastUsed)
+                    program = &other;
+            }
+
+            program->uuid = presetdata.uuid;
+            program->mtime = getFileModTime(presetdata.filename);
+        }
+        else
+        {
+            program = &uncached;
+        }
+
+        compileLoadProgram(*program, preset, presetdata);
+        program->valid = cacheable;
+    }
+
+    program->lastUsed = ++_loadProgramCounter;
+
+    for (const HostLoadProgram::Slot& slot : program->slots)
+    {
+        const Block& blockdata(presetdata.chains[slot.row].blocks[slot.block]);
+        if (blockdata.plugin == nullptr)
+            continue;
+
+        cacheInstancePortNames(slot.hbp.id, blockdata.plugin);
+        if (slot.dualmono)
+            cacheInstancePortNames(slot.hbp.pair, blockdata.plugin);
+    }
+
+    // spare instances already exist in a freshly preloaded state, skip them
+    std::vector<int16_t> preloadInstances;
+    std::vector<const char*> preloadURIs;
+
+    if (! program->spares.empty())
+    {
+        mod_log_debug("hostLoadPreset(%u): reusing %zu spare instances", preset, program->spares.size());
+
+        preloadInstances.reserve(program->instances.size());
+        preloadURIs.reserve(program->instances.size());
+
+        for (size_t i = 0; i < program->instances.size(); ++i)
+        {
+            if (std::find(program->spares.begin(), program->spares.end(), program->instances[i])
+                != program->spares.end())
+                continue;
+
+            preloadInstances.push_back(program->instances[i]);
+            preloadURIs.push_back(program->uris[i]);
+        }
+    }
+
+    const std::vector<int16_t>& instances(program->spares.empty() ? program->instances : preloadInstances);
+    const std::vector<const char*>& uris(program->spares.empty() ? program->uris : preloadURIs);
+
+    // replay the program, sent to mod-host in a single write
+    {
+        const Host::BatchScope hbs(_host);
+
+        // load blocks in parallel
+        // NOTE batched messages are replied only when the non-blocking scope ends, so errors cannot be handled here
+        switch (instances.size())
+        {
+        case 0:
+            break;
+        case 1:
+            if (! _host.preload(uris.front(), instances.front()))
+                mod_log_warn("hostLoadPreset(%u): failed to load plugin %s: %s",
+                             preset, uris.front(), _host.last_error.c_str());
+            break;
+        default:
+            if (! _host.multi_preload(instances.size(), instances.data(), uris.data()))
+                mod_log_warn("hostLoadPreset(%u): failed to load plugins: %s", preset, _host.last_error.c_str());
+            break;
+        }
+
+        for (const HostLoadProgram::Slot& slot : program->slots)
+            hostSetupSideIO(preset, slot.row, slot.block, slot.hbp);
+
+        switch (program->bypassed.size())
+        {
+        case 0:
+            break;
+        case 1:
+            _host.bypass(program->bypassed.front(), true);
+            break;
+        default:
+            _host.multi_bypass(true, program->bypassed.size(), program->bypassed.data());
+            break;
+        }
+
+        for (const HostLoadProgram::PrerunGroup& group : program->prerunGroups)
+        {
+            if (group.instances.size() != 1 &&
+                _host.multi_pre_run(LV2_KXSTUDIO_PROPERTIES_RESET_FULL,
+                                    group.params.size(),
+                                    group.params.data(),
+                                    group.instances.size(),
+                                    group.instances.data()))
+                continue;
+
+            for (const int16_t instance : group.instances)
+                _host.pre_run(instance, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, group.params.size(), group.params.data());
+        }
+
+        for (const HostLoadProgram::PatchSet& patch : program->patchSets)
+            _host.patch_set(patch.instance, patch.uri, patch.value);
+
+        if (active)
+        {
+            switch (program->instances.size())
+            {
+            case 0:
+                break;
+            case 1:
+                _host.activate(program->instances.front(), true);
+                break;
+            default:
+                _host.multi_activate(true, program->instances.size(), program->instances.data());
+                break;
+            }
+
+            _current.numLoadedPlugins += program->slots.size();
+        }
+    }
+
+    // add necessary dual mono pairs and make connections if active preset
+    hostEnsureStereoChain(preset, 0);
+}
+
+void HostConnector::compileLoadProgram(HostLoadProgram& program, const uint8_t preset, const Preset& presetdata)
+{
+    program.slots.clear();
+    program.instances.clear();
+    program.uris.clear();
+    program.bypassed.clear();
+    program.prerunGroups.clear();
+    program.patchSets.clear();
+    program.spares.clear();
+    program.strings.clear();
+
+    // first pass for gathering all blocks to load
+    // dual-mono pairs are included when they can be known in advance, hostEnsureStereoChain takes care of the rest
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        const ChainRow& chaindata(presetdata.chains[row]);
+
+        // capture ports of side rows are only known after their sidechain block is setup
+        const bool knownCapture = !chaindata.capture[0].empty() && !chaindata.capture[1].empty();
+        bool previousPluginStereoOut = knownCapture && shouldBlockBeStereo(chaindata, 0);
+
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        {
+            const Block& blockdata(chaindata.blocks[bl]);
+            if (isNullBlock(blockdata))
+                continue;
+
+            const bool dualmono = knownCapture
+                               && previousPluginStereoOut
+                               && blockdata.meta.numInputs == 1
+                               && blockdata.meta.numSideInputs == 0;
+
+            previousPluginStereoOut = blockdata.meta.numOutputs == 2 || dualmono;
+
+            const char* const uri = program.strings.emplace_back(blockdata.uri).c_str();
+
+            HostLoadProgram::Slot slot = { row, bl, dualmono, {}, uri };
+            slot.hbp.id = mapLoadProgramInstance(program, preset, row, bl, uri, false);
+            slot.hbp.pair = dualmono ? mapLoadProgramInstance(program, preset, row, bl, uri, true) : kMaxHostInstances;
+            program.slots.push_back(slot);
+
+            program.instances.push_back(slot.hbp.id);
+            program.uris.push_back(uri);
+
+            if (dualmono)
+            {
+                program.instances.push_back(slot.hbp.pair);
+                program.uris.push_back(uri);
+            }
+        }
+    }
+
+    // group instances with the same initial parameter values, so each group needs a single pre_run
+    std::vector<flushed_param> params;
+    params.reserve(MAX_PARAMS_PER_BLOCK);
 
-                    for (uint8_t p = 0, jp = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                    {
-                        const Property& propdata = blockdata.properties[p];
+    for (const HostLoadProgram::Slot& slot : program.slots)
+    {
+        const Block& blockdata(presetdata.chains[slot.row].blocks[slot.block]);
 
-                        if (isNullURI(propdata.uri))
-                            break;
-                        if (! shouldSavePropertyToPreset(propdata.meta.flags))
-                            continue;
+        if (!blockdata.enabled)
+        {
+            program.bypassed.push_back(slot.hbp.id);
+            if (slot.dualmono)
+                program.bypassed.push_back(slot.hbp.pair);
+        }
 
-                        const std::string jpropid = std::to_string(++jp);
-                        jprops[jpropid] = nlohmann::json::object({
-                            { "uri", propdata.uri },
-                            { "name", propdata.meta.name },
-                            { "value", propdata.value },
-                        });
-                    }
-                }
+        params.clear();
 
-                if (blockdata.meta.numParametersInScenes + blockdata.meta.numPropertiesInScenes != 0)
-                {
-                    auto& jscenes = jblock["scenes"];
+        for (const Parameter& paramdata : blockdata.parameters)
+        {
+            if (isNullURI(paramdata.symbol))
+                break;
+            if ((paramdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+                continue;
+            if (isNotEqual(paramdata.value, paramdata.meta.defttl))
+                params.push_back({ paramdata.symbol.c_str(), paramdata.value });
+        }
 
-                    for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
-                    {
-                        const std::string jsceneid = std::to_string(s + 1);
-                        auto& jscene = jscenes[jsceneid] = nlohmann::json::object({
-                            { "parameters", nlohmann::json::array() },
-                            { "properties", nlohmann::json::array() },
-                        });
+        const auto sameParams = [&params](const HostLoadProgram::PrerunGroup& group)
+        {
+            if (group.params.size() != params.size())
+                return false;
 
-                        if (blockdata.meta.enable.hasScenes)
-                            jscene["enabled"] = blockdata.sceneValues[s].enabled;
+            for (size_t i = 0; i < params.size(); ++i)
+            {
+                if (std::strcmp(group.params[i].symbol, params[i].symbol) != 0)
+                    return false;
+                if (isNotEqual(group.params[i].value, params[i].value))
+                    return false;
+            }
 
-                        {
-                            auto& jsceneparams = jscene["parameters"];
+            return true;
+        };
 
-                            for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                            {
-                                const Parameter& paramdata = blockdata.parameters[p];
+        auto group = std::find_if(program.prerunGroups.begin(), program.prerunGroups.end(), sameParams);
+        if (group == program.prerunGroups.end())
+        {
+            group = program.prerunGroups.emplace(program.prerunGroups.end());
+            group->params.reserve(params.size());
 
-                                if (isNullURI(paramdata.symbol))
-                                    break;
-                                if (! shouldSaveParameterToPreset(paramdata.meta.flags))
-                                    continue;
-                                if ((paramdata.meta.flags & Lv2ParameterInScene) == 0)
-                                    continue;
+            for (const flushed_param& param : params)
+                group->params.push_back({ program.strings.emplace_back(param.symbol).c_str(), param.value });
+        }
 
-                                jsceneparams.push_back(nlohmann::json::object({
-                                    { "symbol", paramdata.symbol },
-                                    { "value", blockdata.sceneValues[s].parameters[p] },
-                                }));
-                            }
-                        }
+        group->instances.push_back(slot.hbp.id);
+        if (slot.dualmono)
+            group->instances.push_back(slot.hbp.pair);
+    }
 
-                        {
-                            auto& jsceneprops = jscene["properties"];
+    // properties are sent individually, as their values are usually unique per block
+    for (const HostLoadProgram::Slot& slot : program.slots)
+    {
+        const Block& blockdata(presetdata.chains[slot.row].blocks[slot.block]);
 
-                            for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                            {
-                                const Property& propdata = blockdata.properties[p];
+        for (const Property& propdata : blockdata.properties)
+        {
+            if (isNullURI(propdata.uri))
+                break;
+            if ((propdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
+                continue;
+            if (propdata.value == propdata.meta.defpath)
+                continue;
 
-                                if (isNullURI(propdata.uri))
-                                    break;
-                                if (! shouldSavePropertyToPreset(propdata.meta.flags))
-                                    continue;
-                                if ((propdata.meta.flags & Lv2ParameterInScene) == 0)
-                                    continue;
+            const char* const uri = program.strings.emplace_back(propdata.uri).c_str();
+            const char* const value = program.strings.emplace_back(propdata.value).c_str();
 
-                                jsceneprops.push_back(nlohmann::json::object({
-                                    { "uri", propdata.uri },
-                                    { "value", blockdata.sceneValues[s].properties[p] },
-                                }));
-                            }
-                        }
-                    }
-                }
-            }
+            program.patchSets.push_back({ static_cast<int16_t>(slot.hbp.id), uri, value });
+            if (slot.dualmono)
+                program.patchSets.push_back({ static_cast<int16_t>(slot.hbp.pair), uri, value });
         }
     }
+}
 
-    // ----------------------------------------------------------------------------------------------------------------
-    // sceneNames
+void HostConnector::mapLoadProgram(HostLoadProgram& program, const uint8_t preset)
+{
+    // old to new instance ids, only filled in if any of them changed
+    std::array<int16_t, kMaxHostInstances> retarget;
+    bool changed = false;
 
-    for (const std::string& sceneName : presetdata.sceneNames)
+    program.spares.clear();
+
+    for (HostLoadProgram::Slot& slot : program.slots)
     {
-        if (sceneName.empty())
+        HostBlockPair hbp;
+        hbp.id = mapLoadProgramInstance(program, preset, slot.row, slot.block, slot.uri, false);
+        hbp.pair = slot.dualmono ? mapLoadProgramInstance(program, preset, slot.row, slot.block, slot.uri, true)
+                                 : kMaxHostInstances;
+
+        if (hbp.id == slot.hbp.id && hbp.pair == slot.hbp.pair)
             continue;
 
-        auto& jsceneNames = jpreset["sceneNames"] = nlohmann::json::object({});
-        for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
+        if (! changed)
         {
-            const std::string jsceneid = std::to_string(s + 1);
-            jsceneNames[jsceneid] = presetdata.sceneNames[s];
+            changed = true;
+            for (uint16_t id = 0; id < kMaxHostInstances; ++id)
+                retarget[id] = id;
         }
-        break;
+
+        retarget[slot.hbp.id] = hbp.id;
+        if (slot.dualmono)
+            retarget[slot.hbp.pair] = hbp.pair;
+
+        slot.hbp = hbp;
     }
+
+    if (! changed)
+        return;
+
+    mod_log_debug("mapLoadProgram(..., %u): instances changed, retargeting", preset);
+
+    for (int16_t& id : program.instances)
+        id = retarget[id];
+    for (int16_t& id : program.bypassed)
+        id = retarget[id];
+    for (HostLoadProgram::PrerunGroup& group : program.prerunGroups)
+        for (int16_t& id : group.instances)
+            id = retarget[id];
+    for (HostLoadProgram::PatchSet& patch : program.patchSets)
+        patch.instance = retarget[patch.instance];
 }
 
-// --------------------------------------------------------------------------------------------------------------------
+uint16_t HostConnector::mapLoadProgramInstance(HostLoadProgram& program,
+                                               const uint8_t preset,
+                                               const uint8_t row,
+                                               const uint8_t block,
+                                               const char* const uri,
+                                               const bool pair)
+{
+    uint16_t id;
+    if (! takeSpareInstance(uri, id))
+        return pair ? _mapper.add_pair(preset, row, block) : _mapper.add(preset, row, block);
 
-void HostConnector::hostLoadPreset(const uint8_t preset)
+    if (pair)
+        _mapper.attach_pair(preset, row, block, id);
+    else
+        _mapper.attach(preset, row, block, id);
+
+    program.spares.push_back(id);
+    return id;
+}
+
+HostConnector::HostLoadProgram* HostConnector::getCachedLoadProgram(const Preset& presetdata)
 {
-    mod_log_debug("hostLoadPreset(%u)", preset);
+    // preset files can be edited outside of this process without getting a new uuid
+    const int64_t mtime = getFileModTime(presetdata.filename);
 
-    if (_current.preset == preset) {
-        assert(_current.numLoadedPlugins == 0);
+    for (HostLoadProgram& program : _loadPrograms)
+    {
+        if (program.valid && program.uuid == presetdata.uuid && program.mtime == mtime)
+            return &program;
     }
 
-    const bool active = _current.preset == preset;
+    return nullptr;
+}
 
-    // for active preset, before making connections below,
-    // disconnect possible endpoint direct connection left from previous empty preset
-    if (active && _current.numLoadedPlugins == 0) 
-    {
-        hostDisconnectChainEndpoints(0);
+void HostConnector::forgetLoadPrograms()
+{
+    for (HostLoadProgram& program : _loadPrograms)
+        program.valid = false;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::hostSwitchPreset(Current&& prev)
+{
+    mod_log_debug("hostSwitchPreset(...)");
+
+    if (_current.preset == prev.preset) {
+        assert(_current.numLoadedPlugins == 0);
     }
 
-    // first pass for gathering all blocks to load
-    std::vector<int16_t> instances;
-    std::vector<const char*> uris;
-    instances.reserve(kMaxHostInstances);
-    uris.reserve(kMaxHostInstances);
+    _current.dirty = false;
+    _current.numLoadedPlugins = 0;
 
+    // side IO of the new preset must be known before figuring out its connections
     for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
     {
-        const ChainRow& chaindata(active ? _current.chains[row] : _presets[preset].chains[row]);
-
         for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
         {
-            const Block& blockdata(chaindata.blocks[bl]);
-            if (isNullBlock(blockdata))
+            if (isNullBlock(_current.chains[row].blocks[bl]))
                 continue;
 
-            instances.push_back(_mapper.add(preset, row, bl));
-            uris.push_back(blockdata.uri.c_str());
+            const HostBlockPair hbp = _mapper.get(_current.preset, row, bl);
+            assert_continue(hbp.id != kMaxHostInstances);
+
+            hostSetupSideIO(_current.preset, row, bl, hbp);
+            ++_current.numLoadedPlugins;
         }
     }
 
-    // load blocks in parallel
-    switch (instances.size())
+    // crossfade has the new preset going into the other mixer inputs, while the old one keeps playing
+    const bool crossfade = _crossfade.timeMs != 0 && ! _crossfade.mixSymbol.empty() && _current.preset != prev.preset;
+
+    if (crossfade)
+        _crossfade.active = 1 - _crossfade.active;
+
+    // delay and reverb blocks of prev preset keep ringing for a while, restoring defaults waits for them
+    if (_current.preset != prev.preset && _spilloverTimeMs != 0)
     {
-    case 0:
-        break;
-    case 1:
-        _host.preload(uris.front(), instances.front());
-        break;
-    default:
-        _host.multi_preload(instances.size(), instances.data(), uris.data());
-        break;
+        DeferredPresetWork& work = _deferredWork[prev.preset];
+        assert(work.tails.empty());
+
+        getSpilloverTails(prev, prev.preset, work.tails);
+        work.tailsEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(_spilloverTimeMs);
     }
 
-    // setup for the loaded blocks
-    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    HostConnectionGraph graph;
+    getConnections(graph);
+
+    if (crossfade)
     {
-        const ChainRow& chaindata(active ? _current.chains[row] : _presets[preset].chains[row]);
+        // activate and connect all new plugins, going into the mixer inputs not heard yet
+        // the mixer then moves over to them during host updates, prev preset is disconnected once done
+        const Host::NonBlockingScope hnbs(_host);
 
-        // related to active preset only
-        uint8_t numLoadedPlugins = 0;
+        hostActivatePreset(_current, _current.preset, true);
+        hostAddMissingConnections(graph);
 
-        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-        {
-            const Block& blockdata(chaindata.blocks[bl]);
-            if (isNullBlock(blockdata))
-                continue;
+        _crossfade.fadingPreset = prev.preset;
+        _crossfade.start = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        // scope for fade-out, prev deactivate, new activate, fade-in
+        const Host::NonBlockingScopeWithAudioFades hnbs(_host);
 
-            if (active)
-                ++numLoadedPlugins;
+        // step 1: disconnect and deactivate all plugins in prev preset
+        // NOTE not removing plugins, done after processing is reenabled
+        hostRemoveOutdatedConnections(graph);
+        hostActivatePreset(prev, prev.preset, false);
 
-            const HostBlockPair hbp = _mapper.get(preset, row, bl);
+        // step 2: activate all new plugins
+        hostActivatePreset(_current, _current.preset, true);
 
-            hostSetupInstance(blockdata, hbp.id);
-            if (active)
-                _host.activate(hbp.id, true);
+        // step 3: connect all new plugins, connections shared with prev preset are kept as-is
+        hostAddMissingConnections(graph);
+    }
 
-            hostSetupSideIO(preset, row, bl, hbp);
-        }
+    // audio is now processing new preset, or crossfading into it
 
-        if (active)
-            _current.numLoadedPlugins += numLoadedPlugins;
-    }
+    if (_current.preset == prev.preset)
+        return;
 
-    // add necessary dual mono pairs and make connections if active preset
-    hostEnsureStereoChain(preset, 0);
+    // preloading default preset state is not urgent, leave it for later
+    DeferredPresetWork& work = _deferredWork[prev.preset];
+    assert(work.type == DeferredPresetWork::kNone);
+
+    work.type = DeferredPresetWork::kRestoreDefaults;
+    work.prev = std::make_unique<Preset>(std::move(static_cast<Preset&>(prev)));
+    work.nextBlock = 0;
+    work.order = ++_deferredWorkCounter;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::hostSwitchPreset(const Current& prev)
+void HostConnector::hostActivatePreset(const Preset& presetdata, const uint8_t preset, const bool activate)
 {
-    mod_log_debug("hostSwitchPreset(...)");
+    const std::vector<DeferredPresetWork::Tail>& tails(_deferredWork[preset].tails);
 
-    if (_current.preset == prev.preset) {
-        assert(_current.numLoadedPlugins == 0);
-    }
+    std::vector<int16_t> instances;
+    instances.reserve(NUM_BLOCK_CHAIN_ROWS * NUM_BLOCKS_PER_PRESET * 2);
+
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        {
+            if (isNullBlock(presetdata.chains[row].blocks[bl]))
+                continue;
 
-    bool oldloaded[NUM_BLOCK_CHAIN_ROWS][NUM_BLOCKS_PER_PRESET];
+            // ringing blocks stay active
+            if (std::any_of(tails.begin(), tails.end(), [row, bl](const DeferredPresetWork::Tail& tail) {
+                    return tail.row == row && tail.block == bl;
+                }))
+                continue;
 
-    // preallocating some data
-    std::vector<int16_t> instances;
-    std::vector<flushed_param> params;
-    instances.reserve(kMaxHostInstances);
-    params.reserve(MAX_PARAMS_PER_BLOCK);
+            const HostBlockPair hbp = _mapper.get(preset, row, bl);
 
-    _current.dirty = false;
-    _current.numLoadedPlugins = 0;
+            assert(hbp.id != kMaxHostInstances);
 
-    // scope for fade-out, prev deactivate, new activate, fade-in
-    {
-        const Host::NonBlockingScopeWithAudioFades hnbs(_host);
+            if (hbp.id != kMaxHostInstances)
+                instances.push_back(hbp.id);
 
-        // step 1: disconnect and deactivate all plugins in prev preset
-        // NOTE not removing plugins, done after processing is reenabled
-        if (prev.numLoadedPlugins == 0)
-        {
-            std::memset(oldloaded, 0, sizeof(oldloaded));
-            hostDisconnectChainEndpoints(0);
+            if (hbp.pair != kMaxHostInstances)
+                instances.push_back(hbp.pair);
         }
-        else
-        {
-            for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
-            {
-                uint8_t numLoadedPlugins = 0;
+    }
 
-                for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-                {
-                    const Block& blockdata(prev.chains[row].blocks[bl]);
+    switch (instances.size())
+    {
+    case 0:
+        break;
+    case 1:
+        _host.activate(instances.front(), activate);
+        break;
+    default:
+        _host.multi_activate(activate, instances.size(), instances.data());
+        break;
+    }
+}
 
-                    if (! (oldloaded[row][bl] = !isNullBlock(blockdata)))
-                        continue;
+void HostConnector::hostRunCrossfade()
+{
+    if (_crossfade.fadingPreset == NUM_PRESETS_PER_BANK)
+        return;
 
-                    const HostBlockPair hbp = _mapper.get(prev.preset, row, bl);
-                    hostDisconnectAllBlockInputs(blockdata, hbp);
-                    hostDisconnectAllBlockOutputs(blockdata, hbp);
+    const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now()
+                                                                   - _crossfade.start).count();
 
-                    assert(hbp.id != kMaxHostInstances);
+    if (elapsed >= static_cast<float>(_crossfade.timeMs))
+    {
+        const Host::NonBlockingScope hnbs(_host);
+        hostEndCrossfade();
+        return;
+    }
 
-                    if (hbp.id != kMaxHostInstances)
-                        instances.push_back(hbp.id);
+    const float progress = elapsed / static_cast<float>(_crossfade.timeMs);
+    _host.param_set(_crossfade.instance,
+                    _crossfade.mixSymbol.c_str(),
+                    _crossfade.active != 0 ? progress : 1.f - progress);
+}
 
-                    if (hbp.pair != kMaxHostInstances)
-                        instances.push_back(hbp.pair);
+void HostConnector::hostEndCrossfade()
+{
+    const uint8_t preset = _crossfade.fadingPreset;
+    if (preset == NUM_PRESETS_PER_BANK)
+        return;
 
-                    ++numLoadedPlugins;
-                }
+    mod_log_debug("hostEndCrossfade() - towards mixer inputs %c, preset %u faded out",
+                  _crossfade.active != 0 ? 'B' : 'A', preset);
 
-                if (numLoadedPlugins == 0 && !prev.chains[row].capture[0].empty())
-                    hostDisconnectChainEndpoints(row);
-            }
-        }
+    _crossfade.fadingPreset = NUM_PRESETS_PER_BANK;
 
-        switch (instances.size())
-        {
-        case 0:
-            break;
-        case 1:
-            _host.activate(instances.front(), false);
-            break;
-        default:
-            _host.multi_activate(false, instances.size(), instances.data());
-            break;
-        }
+    _host.param_set(_crossfade.instance, _crossfade.mixSymbol.c_str(), _crossfade.active != 0 ? 1.f : 0.f);
+
+    // prev preset is no longer heard, its connections are outdated now
+    hostUpdateConnections();
+
+    // prev preset data was moved into the deferred work queue during the switch
+    const DeferredPresetWork& work = _deferredWork[preset];
+    assert_return(work.prev != nullptr,);
+
+    hostActivatePreset(*work.prev, preset, false);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
 
-        instances.clear();
+void HostConnector::getSpilloverTails(const Preset& prev,
+                                      const uint8_t preset,
+                                      std::vector<DeferredPresetWork::Tail>& tails) const
+{
+    // ringing blocks are extra active instances, same as spare ones
+    uint16_t numInstances = _instancePoolSize;
 
-        // step 2: activate all new plugins
-        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
-        {
-            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-            {
-                if (isNullBlock(_current.chains[row].blocks[bl]))
-                    continue;
+    for (const DeferredPresetWork& work : _deferredWork)
+        for (const DeferredPresetWork::Tail& tail : work.tails)
+            numInstances += tail.hbp.pair != kMaxHostInstances ? 2 : 1;
 
-                const HostBlockPair hbp = _mapper.get(_current.preset, row, bl);
+    for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
+    {
+        // side rows might not go to playback
+        if (prev.chains[row].playback[0].empty())
+            continue;
 
-                assert(hbp.id != kMaxHostInstances);
+        for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
+        {
+            const Block& blockdata(prev.chains[row].blocks[bl]);
+            if (isNullBlock(blockdata) || blockdata.plugin == nullptr || !blockdata.enabled)
+                continue;
+            if (blockdata.meta.numSideInputs != 0 || blockdata.meta.numSideOutputs != 0)
+                continue;
+            if (blockdata.plugin->category != kLv2CategoryDelay && blockdata.plugin->category != kLv2CategoryReverb)
+                continue;
 
-                if (hbp.id != kMaxHostInstances)
-                    instances.push_back(hbp.id);
+            const HostBlockPair hbp = _mapper.get(preset, row, bl);
+            assert_continue(hbp.id != kMaxHostInstances);
 
-                if (hbp.pair != kMaxHostInstances)
-                    instances.push_back(hbp.pair);
+            const uint16_t numBlockInstances = hbp.pair != kMaxHostInstances ? 2 : 1;
+            if (numInstances + numBlockInstances > _instancePoolBudget)
+            {
+                mod_log_debug("getSpilloverTails(..., %u) - over budget, cutting the remaining tails", preset);
+                return;
             }
-        }
 
-        switch (instances.size())
-        {
-        case 0:
-            break;
-        case 1:
-            _host.activate(instances.front(), true);
-            break;
-        default:
-            _host.multi_activate(true, instances.size(), instances.data());
-            break;
+            numInstances += numBlockInstances;
+            tails.push_back({ hbp, blockdata.plugin, row, bl });
         }
+    }
+}
 
-        // step 3: connect all new plugins
-        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
-        {
-            uint8_t last = 0;
-            uint8_t numLoadedPlugins = 0;
-
-            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-            {
-                if (isNullBlock(_current.chains[row].blocks[bl]))
-                    continue;
+// --------------------------------------------------------------------------------------------------------------------
 
-                const HostBlockPair hbp = _mapper.get(_current.preset, row, bl);
+void HostConnector::hostEndSpillover(const uint8_t preset)
+{
+    std::vector<DeferredPresetWork::Tail>& tails(_deferredWork[preset].tails);
+    if (tails.empty())
+        return;
 
-                assert(hbp.id != kMaxHostInstances);
+    mod_log_debug("hostEndSpillover(%u) - %zu blocks", preset, tails.size());
 
-                if (numLoadedPlugins == 0)
-                    hostConnectBlockToChainInput(row, bl);
-                else
-                    hostConnectBlockToBlock(row, last, bl);
+    std::vector<int16_t> instances;
+    instances.reserve(tails.size() * 2);
 
-                hostSetupSideIO(_current.preset, row, bl, hbp);
+    for (const DeferredPresetWork::Tail& tail : tails)
+    {
+        instances.push_back(tail.hbp.id);
+        if (tail.hbp.pair != kMaxHostInstances)
+            instances.push_back(tail.hbp.pair);
+    }
 
-                last = bl;
-                ++numLoadedPlugins;
-            }
+    tails.clear();
 
-            if (numLoadedPlugins != 0)
-                hostConnectBlockToChainOutput(row, last);
-            else if (!_current.chains[row].capture[0].empty())
-                hostConnectChainEndpoints(row);
+    // ringing blocks are no longer part of the connections
+    hostUpdateConnections();
 
-            _current.numLoadedPlugins += numLoadedPlugins;
-        }
+    switch (instances.size())
+    {
+    case 1:
+        _host.activate(instances.front(), false);
+        break;
+    default:
+        _host.multi_activate(false, instances.size(), instances.data());
+        break;
     }
+}
 
-    // audio is now processing new preset
+void HostConnector::hostEndExpiredSpillover()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
-    // scope for preloading default preset state and copying current port state cache
+    for (uint8_t pr = 0; pr < NUM_PRESETS_PER_BANK; ++pr)
     {
-        const Preset& defaults = _presets[prev.preset];
-        Preset& inactivatedPreset = _presets[prev.preset];
-        // bool defloaded[NUM_BLOCKS_PER_PRESET];
+        const DeferredPresetWork& work = _deferredWork[pr];
+
+        if (work.tails.empty() || now < work.tailsEnd)
+            continue;
 
         const Host::NonBlockingScope hnbs(_host);
+        hostEndSpillover(pr);
+    }
+}
 
-        for (uint8_t row = 0; row < NUM_BLOCK_CHAIN_ROWS; ++row)
-        {
-            for (uint8_t bl = 0; bl < NUM_BLOCKS_PER_PRESET; ++bl)
-            {
-                const Block& defblockdata = defaults.chains[row].blocks[bl];
-                const Block& prevblockdata = prev.chains[row].blocks[bl];
-                Block& inactblockdata = inactivatedPreset.chains[row].blocks[bl];
+// --------------------------------------------------------------------------------------------------------------------
 
-                // using same plugin (or both empty)
-                // already loaded plugin instance(s) will be kept
-                if (defblockdata.uri == prevblockdata.uri)
-                {
-                    if (isNullBlock(defblockdata))
-                        continue;
+void HostConnector::hostRestorePresetBlock(const uint8_t preset,
+                                           const Preset& prev,
+                                           const uint8_t row,
+                                           const uint8_t bl)
+{
+    const Block& defblockdata = _presets[preset].chains[row].blocks[bl];
+    const Block& prevblockdata = prev.chains[row].blocks[bl];
+    Block& inactblockdata = _presets[preset].chains[row].blocks[bl];
 
-                    const HostBlockPair hbp = _mapper.get(prev.preset, row, bl);
-                    assert_continue(hbp.id != kMaxHostInstances);
+    std::vector<flushed_param> params;
+    params.reserve(MAX_PARAMS_PER_BLOCK);
 
-                    if (defblockdata.meta.enable.changesNotSavedToPreset)
-                    {
-                        // enabled value in _presets[] may have changed but not part of preset
-                        // default enabled state is always true
-                        inactblockdata.enabled = true;
-                    }
+    // using same plugin (or both empty)
+    // already loaded plugin instance(s) will be kept
+    if (defblockdata.uri == prevblockdata.uri)
+    {
+        if (isNullBlock(defblockdata))
+            return;
 
-                    if (defblockdata.enabled != prevblockdata.enabled)
-                    {
-                        hostBypassBlockPair(hbp, !defblockdata.enabled);
-                    }
+        const HostBlockPair hbp = _mapper.get(preset, row, bl);
+        assert_return(hbp.id != kMaxHostInstances,);
 
-                    params.clear();
+        if (defblockdata.meta.enable.changesNotSavedToPreset)
+        {
+            // enabled value in _presets[] may have changed but not part of preset
+            // default enabled state is always true
+            inactblockdata.enabled = true;
+        }
 
-                    for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                    {
-                        const Parameter& defparamdata(defblockdata.parameters[p]);
-                        const Parameter& oldparamdata(prevblockdata.parameters[p]);
-                        Parameter& inactparamdata(inactblockdata.parameters[p]);
+        if (defblockdata.enabled != prevblockdata.enabled)
+        {
+            hostBypassBlockPair(hbp, !defblockdata.enabled);
+        }
 
-                        if (isNullURI(defparamdata.symbol))
-                            break;
+        for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+        {
+            const Parameter& defparamdata(defblockdata.parameters[p]);
+            const Parameter& oldparamdata(prevblockdata.parameters[p]);
+            Parameter& inactparamdata(inactblockdata.parameters[p]);
 
-                        // copy param state to _presets because it's not part of saved preset data
-                        // but should be kept for next activation
-                        inactparamdata.meta.state = oldparamdata.meta.state;
+            if (isNullURI(defparamdata.symbol))
+                break;
 
-                        if ((defparamdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
-                            continue;
-                        if (inactparamdata.meta.state == Lv2ParameterStateBlocked)
-                            continue;
+            // copy param state to _presets because it's not part of saved preset data
+            // but should be kept for next activation
+            inactparamdata.meta.state = oldparamdata.meta.state;
 
-                        if ((defparamdata.meta.flags & Lv2ParameteChangesNotSavedToPreset) != 0)
-                        {
-                            // parameter value in _presets[] may have changed but not part of preset
-                            inactparamdata.value = defparamdata.meta.def;
-                        }
+            if ((defparamdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+                continue;
+            if (inactparamdata.meta.state == Lv2ParameterStateBlocked)
+                continue;
 
-                        if (isEqual(defparamdata.value, oldparamdata.value))
-                            continue;
+            if ((defparamdata.meta.flags & Lv2ParameteChangesNotSavedToPreset) != 0)
+            {
+                // parameter value in _presets[] may have changed but not part of preset
+                inactparamdata.value = defparamdata.meta.def;
+            }
 
-                        params.push_back({ defparamdata.symbol.c_str(), defparamdata.value });
-                    }
+            if (isEqual(defparamdata.value, oldparamdata.value))
+                continue;
 
-                    for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                    {
-                        const Property& defpropdata(defblockdata.properties[p]);
-                        const Property& prevpropdata(prevblockdata.properties[p]);
+            params.push_back({ defparamdata.symbol.c_str(), defparamdata.value });
+        }
 
-                        if (isNullURI(defpropdata.uri))
-                            break;
-                        if ((defpropdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
-                            continue;
-                        if (defpropdata.value == prevpropdata.value)
-                            continue;
+        for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+        {
+            const Property& defpropdata(defblockdata.properties[p]);
+            const Property& prevpropdata(prevblockdata.properties[p]);
 
-                        hostPatchSetBlockPair(hbp, defpropdata);
-                    }
+            if (isNullURI(defpropdata.uri))
+                break;
+            if ((defpropdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
+                continue;
+            if (defpropdata.value == prevpropdata.value)
+                continue;
 
-                    // Already "pre-running" now so the preset is all ready for switching back to
-                    hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, params);
-                    
-                    continue;
-                }
+            hostPatchSetBlockPair(hbp, defpropdata);
+        }
 
-                // different plugin, unload old one if there is any
-                if (oldloaded[row][bl])
-                {
-                    if (const HostBlockPair hbp = _mapper.remove(prev.preset, row, bl); hbp.id != kMaxHostInstances)
-                        hostRemoveBlockPair(hbp);
-                }
+        // Already "pre-running" now so the preset is all ready for switching back to
+        hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, params);
+        return;
+    }
 
-                // nothing else to do if block is empty
-                if (isNullBlock(defblockdata))
-                    continue;
+    // different plugin, unload old one if there is any
+    if (!isNullBlock(prevblockdata))
+        hostReleaseInstanceForBlock(preset, row, bl, prevblockdata);
 
-                // otherwise load default plugin
-                HostBlockPair hbp = { _mapper.add(prev.preset, row, bl), kMaxHostInstances };
-                _host.preload(defblockdata.uri.c_str(), hbp.id);
+    // nothing else to do if block is empty
+    if (isNullBlock(defblockdata))
+        return;
 
-                if (!defblockdata.enabled)
-                {
-                    hostBypassBlockPair(hbp, true);
-                }
+    // otherwise load default plugin
+    HostBlockPair hbp = { kMaxHostInstances, kMaxHostInstances };
 
-                params.clear();
+    if (!hostPreloadInstanceForBlock(preset, row, bl, defblockdata.uri.c_str(), hbp.id))
+    {
+        mod_log_warn("hostRestorePresetBlock(%u, ...): failed to load plugin %s: %s",
+                     preset, defblockdata.uri.c_str(), _host.last_error.c_str());
 
-                for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                {
-                    const Parameter& defparamdata(defblockdata.parameters[p]);
-                    if (isNullURI(defparamdata.symbol))
-                        break;
-                    if ((defparamdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
-                        continue;
-                    if (isEqual(defparamdata.value, defparamdata.meta.defttl))
-                        continue;
+        // leave block empty, so preset data matches what is in the host
+        _mapper.remove(preset, row, bl);
+        removeAllBlockBindings(_presets[preset], row, bl);
+        resetBlock(inactblockdata);
+        _presetsAsLoaded[preset] = false;
+        return;
+    }
 
-                    params.push_back({ defparamdata.symbol.c_str(), defparamdata.value });
-                }
+    if (!defblockdata.enabled)
+    {
+        hostBypassBlockPair(hbp, true);
+    }
 
-                for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
-                {
-                    const Property& defpropdata(defblockdata.properties[p]);
-                    if (isNullURI(defpropdata.uri))
-                        break;
-                    if ((defpropdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
-                        continue;
-                    if (defpropdata.value == defpropdata.meta.defpath)
-                        continue;
+    for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+    {
+        const Parameter& defparamdata(defblockdata.parameters[p]);
+        if (isNullURI(defparamdata.symbol))
+            break;
+        if ((defparamdata.meta.flags & Lv2ParameterNotAllowedToChange) != 0)
+            continue;
+        if (isEqual(defparamdata.value, defparamdata.meta.defttl))
+            continue;
 
-                    hostPatchSetBlockPair(hbp, defpropdata);
-                }
+        params.push_back({ defparamdata.symbol.c_str(), defparamdata.value });
+    }
 
-                // Already "pre-running" now so the preset is all ready for switching back to
-                hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, params);
-            }
-        }
+    for (uint8_t p = 0; p < MAX_PARAMS_PER_BLOCK; ++p)
+    {
+        const Property& defpropdata(defblockdata.properties[p]);
+        if (isNullURI(defpropdata.uri))
+            break;
+        if ((defpropdata.meta.flags & Lv2PropertyNotAllowedToChange) != 0)
+            continue;
+        if (defpropdata.value == defpropdata.meta.defpath)
+            continue;
 
-        // ensure necessary dual mono blocks are added
-        // FIXME? this makes unnecessary connections for the non-acive preset?
-        hostEnsureStereoChain(prev.preset, 0);
+        hostPatchSetBlockPair(hbp, defpropdata);
     }
+
+    // Already "pre-running" now so the preset is all ready for switching back to
+    hostPrerunBlockPair(hbp, LV2_KXSTUDIO_PROPERTIES_RESET_FULL, params);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -6599,6 +8756,9 @@ bool HostConnector::hostLoadInstance(const Block& blockdata, const uint16_t inst
 
     if (_host.preload(blockdata.uri.c_str(), instance_number))
     {
+        if (blockdata.plugin != nullptr)
+            cacheInstancePortNames(instance_number, blockdata.plugin);
+
         hostSetupInstance(blockdata, instance_number);
         if (active) 
             _host.activate(instance_number, true);
@@ -6670,11 +8830,15 @@ void HostConnector::hostRemoveBlockPair(const HostBlockPair& hbp)
         const int16_t instances[2] = { static_cast<int16_t>(hbp.id), static_cast<int16_t>(hbp.pair) };
 
         _host.multi_remove(2, instances);
+        forgetInstance(hbp.pair);
     }
     else
     {
         _host.remove(hbp.id);
     }
+
+    // connections are gone together with the instances
+    forgetInstance(hbp.id);
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -7042,15 +9206,46 @@ void HostConnector::setDirty(const bool dirty)
 
 // --------------------------------------------------------------------------------------------------------------------
 
-void HostConnector::initBlock(HostConnector::Block& blockdata,
-                              const std::shared_ptr<const Lv2Plugin>& plugin,
-                              const uint8_t numInputs,
-                              const uint8_t numOutputs,
-                              const uint8_t numSideInputs,
-                              const uint8_t numSideOutputs) const
+const HostConnector::BlockPrototype&
+HostConnector::getBlockPrototype(const std::shared_ptr<const Lv2Plugin>& plugin) const
 {
     assert(plugin != nullptr);
 
+    BlockPrototype& proto = _blockPrototypes[plugin->uri];
+
+    static const std::vector<Lv2Port> kNoVirtualParameters;
+    const auto itvp = virtualParameters.find(plugin->uri);
+    const std::vector<Lv2Port>& vports = itvp != virtualParameters.end() ? itvp->second : kNoVirtualParameters;
+
+    // plugin info is never modified in place, a new pointer means the bundle was reloaded
+    if (proto.plugin == plugin && isSameLv2PortList(proto.virtualParameters, vports))
+        return proto;
+
+    proto.plugin = plugin;
+    proto.virtualParameters = vports;
+    proto.numParams = proto.numProps = 0;
+    proto.supportedIO = getSupportedPluginIO(plugin,
+                                             proto.numInputs,
+                                             proto.numOutputs,
+                                             proto.numSideInputs,
+                                             proto.numSideOutputs);
+
+    if (!proto.supportedIO)
+    {
+        proto.block = {};
+        return proto;
+    }
+
+    Block& blockdata = proto.block;
+
+    if (blockdata.parameters.empty())
+        allocBlock(blockdata);
+
+    const uint8_t numInputs = proto.numInputs;
+    const uint8_t numOutputs = proto.numOutputs;
+    const uint8_t numSideInputs = proto.numSideInputs;
+    const uint8_t numSideOutputs = proto.numSideOutputs;
+
     blockdata.enabled = true;
     blockdata.uri = plugin->uri;
     blockdata.quickPotSymbol.clear();
@@ -7120,11 +9315,9 @@ void HostConnector::initBlock(HostConnector::Block& blockdata,
         };
     };
 
-    try {
-        const std::vector<Lv2Port>& ports = virtualParameters.at(blockdata.uri);
-        assert(! ports.empty());
-
-        for (const Lv2Port& port : ports)
+    if (! vports.empty())
+    {
+        for (const Lv2Port& port : vports)
         {
             assert(!port.symbol.empty());
             assert(port.symbol[0] == ':');
@@ -7137,7 +9330,7 @@ void HostConnector::initBlock(HostConnector::Block& blockdata,
 
         assert(numParams != 0);
         assert(blockdata.parameters[0].symbol[0] == ':');
-    } catch (...) {}
+    }
 
     for (const Lv2Port& port : plugin->ports)
     {
@@ -7211,17 +9404,40 @@ void HostConnector::initBlock(HostConnector::Block& blockdata,
     {
         blockdata.sceneValues[s].enabled = true;
         blockdata.lastSavedSceneValues[s].enabled = true;
+
+        for (uint8_t p = 0; p < numParams; ++p)
+        {
+            blockdata.sceneValues[s].parameters[p] = blockdata.parameters[p].value;
+            blockdata.lastSavedSceneValues[s].parameters[p] = blockdata.parameters[p].value;
+        }
+        for (uint8_t p = 0; p < numProps; ++p)
+        {
+            blockdata.sceneValues[s].properties[p] = blockdata.properties[p].value;
+            blockdata.lastSavedSceneValues[s].properties[p] = blockdata.properties[p].value;
+        }
     }
 
-    // override defaults from user
-    const std::string defdir = getDefaultPluginBundleForBlock(blockdata);
+    proto.numParams = numParams;
+    proto.numProps = numProps;
+    return proto;
+}
 
-    if (std::filesystem::exists(defdir))
-    {
-        const std::unordered_map<std::string, float> statemap
-            = lv2world.loadPluginState((defdir + "/default.ttl").c_str());
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostConnector::initBlock(HostConnector::Block& blockdata, const BlockPrototype& proto) const
+{
+    assert(proto.supportedIO);
 
-        for (const auto& state : statemap)
+    // copy over everything from the prototype, reusing already allocated storage
+    blockdata = proto.block;
+
+    const uint8_t numParams = proto.numParams;
+    const uint8_t numProps = proto.numProps;
+
+    // override defaults from user
+    if (const BlockDefaults* const defaults = getBlockDefaults(blockdata))
+    {
+        for (const auto& state : defaults->params)
         {
             const std::string symbol = state.first;
             const float value = state.second;
@@ -7255,46 +9471,82 @@ void HostConnector::initBlock(HostConnector::Block& blockdata,
 
         // TODO handle properties
 
-        std::ifstream f(defdir + "/defaults.json");
-        nlohmann::json j;
-        std::string jquickpot;
-
-        try {
-            j = nlohmann::json::parse(f);
-            jquickpot = j["quickpot"].get<std::string>();
-        } catch (const std::exception& e) {
-            mod_log_warn("failed to parse block defaults: %s", e.what());
-        } catch (...) {
-            mod_log_warn("failed to parse block defaults: unknown exception");
-        }
+        const std::string& quickpot = defaults->quickPotSymbol;
 
-        if (! jquickpot.empty())
+        if (! quickpot.empty())
         {
             for (uint8_t p = 0; p < numParams; ++p)
             {
-                if (blockdata.parameters[p].symbol == jquickpot)
+                if (blockdata.parameters[p].symbol == quickpot)
                 {
-                    blockdata.quickPotSymbol = jquickpot;
+                    blockdata.quickPotSymbol = quickpot;
                     blockdata.meta.quickPotIndex = p;
                     break;
                 }
             }
         }
-    }
 
-    for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
-    {
-        for (uint8_t p = 0; p < numParams; ++p)
+        for (uint8_t s = 0; s < NUM_SCENES_PER_PRESET; ++s)
         {
-            blockdata.sceneValues[s].parameters[p] = blockdata.parameters[p].value;
-            blockdata.lastSavedSceneValues[s].parameters[p] = blockdata.parameters[p].value;
+            for (uint8_t p = 0; p < numParams; ++p)
+            {
+                blockdata.sceneValues[s].parameters[p] = blockdata.parameters[p].value;
+                blockdata.lastSavedSceneValues[s].parameters[p] = blockdata.parameters[p].value;
+            }
+            for (uint8_t p = 0; p < numProps; ++p)
+            {
+                blockdata.sceneValues[s].properties[p] = blockdata.properties[p].value;
+                blockdata.lastSavedSceneValues[s].properties[p] = blockdata.properties[p].value;
+            }
         }
-        for (uint8_t p = 0; p < numProps; ++p)
-        {
-            blockdata.sceneValues[s].properties[p] = blockdata.properties[p].value;
-            blockdata.lastSavedSceneValues[s].properties[p] = blockdata.properties[p].value;
+    }
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+const HostConnector::BlockDefaults* HostConnector::getBlockDefaults(const Block& blockdata) const
+{
+    const std::string defdir = getDefaultPluginBundleForBlock(blockdata);
+    const int64_t stateMTime = getFileModTime(defdir + "/default.ttl");
+    const int64_t extraMTime = getFileModTime(defdir + "/defaults.json");
+
+    if (stateMTime == 0 && extraMTime == 0)
+    {
+        _blockDefaults.erase(blockdata.uri);
+        return nullptr;
+    }
+
+    BlockDefaults& defaults = _blockDefaults[blockdata.uri];
+
+    // use cached data if files did not change since last time
+    if (defaults.valid && defaults.stateMTime == stateMTime && defaults.extraMTime == extraMTime)
+        return &defaults;
+
+    defaults.valid = true;
+    defaults.stateMTime = stateMTime;
+    defaults.extraMTime = extraMTime;
+    defaults.params.clear();
+    defaults.quickPotSymbol.clear();
+
+    if (stateMTime != 0)
+        defaults.params = lv2world.loadPluginState((defdir + "/default.ttl").c_str());
+
+    if (extraMTime != 0)
+    {
+        std::ifstream f(defdir + "/defaults.json");
+        nlohmann::json j;
+
+        try {
+            j = nlohmann::json::parse(f);
+            defaults.quickPotSymbol = j["quickpot"].get<std::string>();
+        } catch (const std::exception& e) {
+            mod_log_warn("failed to parse block defaults: %s", e.what());
+        } catch (...) {
+            mod_log_warn("failed to parse block defaults: unknown exception");
         }
     }
+
+    return &defaults;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -11,7 +11,12 @@
 #include <cassert>
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <list>
+#include <memory>
+#include <set>
 #include <unordered_map>
 
 enum ExtraLv2Flags {
@@ -44,6 +49,7 @@ struct HostConnector : Host::FeedbackCallback {
                 // TODO rename Patch to Property
                 kMidiControlChange,
                 kMidiProgramChange,
+                kPluginBundleChanged,
             } type;
             union {
                 // kAudioMonitor
@@ -110,6 +116,11 @@ struct HostConnector : Host::FeedbackCallback {
                     uint8_t channel;
                     uint8_t program;
                 } midiProgramChange;
+                // kPluginBundleChanged
+                struct {
+                    const char* path;
+                    bool added;
+                } pluginBundleChanged;
             };
         };
 
@@ -316,6 +327,24 @@ struct HostConnector : Host::FeedbackCallback {
        #endif
     };
 
+    // lightweight preset details as stored in a preset library index, does not require loading the full preset
+    struct PresetLibraryEntry {
+        std::string filename; // full path
+        std::string name;
+        std::string uuid;
+        int64_t mtime = 0;
+        std::vector<std::string> uris; // unique block plugin URIs, in chain order
+        std::array<std::string, NUM_SCENES_PER_PRESET> sceneNames;
+    };
+
+    // timings of the last bank load, in milliseconds
+    struct BankLoadTimings {
+        // from start of bank load until the active preset is audible
+        uint32_t firstSound = 0;
+        // from start of bank load until all other presets are preloaded, 0 while still in progress
+        uint32_t fullyLoaded = 0;
+    };
+
     // connection to mod-host, handled internally
     Host _host;
 
@@ -326,12 +355,199 @@ protected:
     // internal host instance mapper
     HostInstanceMapper _mapper;
 
+    // user defaults for a plugin, as saved by saveBlockStateAsDefault
+    struct BlockDefaults {
+        bool valid = false;
+        int64_t stateMTime = 0;
+        int64_t extraMTime = 0;
+        std::unordered_map<std::string, float> params;
+        std::string quickPotSymbol;
+    };
+
+    // cached user defaults per plugin URI, checked against file modification times on use
+    mutable std::unordered_map<std::string, BlockDefaults> _blockDefaults;
+
+    // fully initialized block for a plugin using its ttl defaults, plus its IO classification
+    struct BlockPrototype {
+        std::shared_ptr<const Lv2Plugin> plugin;
+        bool supportedIO = false;
+        uint8_t numInputs = 0;
+        uint8_t numOutputs = 0;
+        uint8_t numSideInputs = 0;
+        uint8_t numSideOutputs = 0;
+        uint8_t numParams = 0;
+        uint8_t numProps = 0;
+        Block block;
+        // copy of the virtual parameters used to build this prototype
+        std::vector<Lv2Port> virtualParameters;
+    };
+
+    // cached block prototypes per plugin URI, rebuilt when the plugin info or virtual parameters change
+    mutable std::unordered_map<std::string, BlockPrototype> _blockPrototypes;
+
+    // spare deactivated plugin instances ready for reuse, per plugin URI
+    std::unordered_map<std::string, std::vector<uint16_t>> _instancePool;
+    uint16_t _instancePoolSize = 0;
+    uint16_t _instancePoolBudget = MAX_SPARE_PLUGIN_INSTANCES;
+
+    // full jack port names of an instance, indexed like its plugin ports, empty for non-audio ports
+    struct InstancePortNames {
+        std::shared_ptr<const Lv2Plugin> plugin;
+        std::vector<std::string> names;
+    };
+
+    // cached port names per instance id, built when an instance is created and cleared when it is removed
+    mutable std::array<InstancePortNames, kMaxHostInstances> _instancePortNames;
+
+    // flat list of host commands for loading a preset, compiled from its data and instance assignment
+    struct HostLoadProgram {
+        // loaded blocks in load order, with the instances assigned to them
+        struct Slot {
+            uint8_t row;
+            uint8_t block;
+            bool dualmono;
+            HostBlockPair hbp;
+            const char* uri;
+        };
+        struct PrerunGroup {
+            std::vector<flushed_param> params;
+            std::vector<int16_t> instances;
+        };
+        struct PatchSet {
+            int16_t instance;
+            const char* uri;
+            const char* value;
+        };
+        std::vector<Slot> slots;
+        std::vector<int16_t> instances;
+        std::vector<const char*> uris;
+        std::vector<int16_t> bypassed;
+        std::vector<PrerunGroup> prerunGroups;
+        std::vector<PatchSet> patchSets;
+        // instances taken from spare ones during the last instance assignment, these are not preloaded
+        std::vector<int16_t> spares;
+        // storage for the strings referenced above, elements never move once added
+        std::deque<std::string> strings;
+        // uuid and file modification time of the compiled preset data, and when last used (higher is more recent)
+        std::array<unsigned char, UUID_SIZE> uuid = {};
+        int64_t mtime = 0;
+        uint32_t lastUsed = 0;
+        bool valid = false;
+
+        HostLoadProgram() = default;
+        HostLoadProgram(const HostLoadProgram&) = delete;
+        HostLoadProgram& operator=(const HostLoadProgram&) = delete;
+    };
+
+    // load programs of preset data that still matches its file, shared by uuid so they survive bank changes
+    std::array<HostLoadProgram, NUM_PRESETS_PER_BANK * 2> _loadPrograms;
+    uint32_t _loadProgramCounter = 0;
+
+    // whether each preset data still matches the file it was loaded from, only then load programs are cached
+    std::array<bool, NUM_PRESETS_PER_BANK> _presetsAsLoaded = {};
+
     // internal current preset state
     Current _current;
 
     // default state for each preset
     std::array<Preset, NUM_PRESETS_PER_BANK> _presets;
 
+    // non-urgent host work for inactive presets, done in between user commands, see hostRunDeferredWork
+    struct DeferredPresetWork {
+        enum Type : uint8_t {
+            kNone = 0,
+            // preset was switched away from, its instances still hold the state from when it was active
+            kRestoreDefaults,
+            // preset was not preloaded yet after a bank load
+            kLoad,
+        } type = kNone;
+        // for kRestoreDefaults: state held by the preset instances, and the next block to restore
+        std::unique_ptr<Preset> prev;
+        uint16_t nextBlock = 0;
+        // for kRestoreDefaults: delay and reverb blocks left ringing after the switch, and until when
+        // restoring defaults waits for these to end, see hostEndSpillover
+        struct Tail {
+            HostBlockPair hbp;
+            std::shared_ptr<const Lv2Plugin> plugin;
+            uint8_t row;
+            uint8_t block;
+        };
+        std::vector<Tail> tails;
+        std::chrono::steady_clock::time_point tailsEnd;
+        // higher means more recently queued, which gets done first
+        uint32_t order = 0;
+    };
+    std::array<DeferredPresetWork, NUM_PRESETS_PER_BANK> _deferredWork;
+    uint32_t _deferredWorkCounter = 0;
+
+    // next bank preloaded into the other instance range, see prepareBankFromPresetFiles
+    // presets are also used for parsing regular bank loads, the mapper is only used with PREPARED_BANK_INSTANCES
+    struct PreparedBank {
+        std::array<Preset, NUM_PRESETS_PER_BANK> presets;
+        std::array<bool, NUM_PRESETS_PER_BANK> presetsAsLoaded = {};
+        HostInstanceMapper mapper { kNumHostInstanceRanges - 1 };
+        // spare instances are only kept for the active bank, so this stays empty while not swapped in
+        std::unordered_map<std::string, std::vector<uint16_t>> instancePool;
+        uint16_t instancePoolSize = 0;
+        bool ready = false;
+    };
+    PreparedBank _nextBank;
+
+    // instances of a previous bank that are still to be removed, done as deferred work
+    std::vector<int16_t> _leftoverInstances;
+
+    // latest preset switch requested via requestSwitchPreset, NUM_PRESETS_PER_BANK if none
+    std::atomic<uint8_t> _requestedPreset { NUM_PRESETS_PER_BANK };
+
+    // last time a user-facing command was received, deferred work waits for some idle time after it
+    std::chrono::steady_clock::time_point _lastUserCommand;
+
+    // how long delay and reverb tails keep ringing after a preset switch, 0 for no spillover
+    uint32_t _spilloverTimeMs = PRESET_SWITCH_SPILLOVER_MS;
+
+    // timings of the last bank load, and when it started
+    BankLoadTimings _bankLoadTimings;
+    std::chrono::steady_clock::time_point _bankLoadStart;
+
+    // a single audio connection between 2 jack ports
+    struct HostConnection {
+        std::string origin;
+        std::string target;
+        // direct connections between chain endpoints use the "safe" variants, ports might not exist
+        bool safe = false;
+
+        bool operator<(const HostConnection& other) const noexcept
+        {
+            return origin != other.origin ? origin < other.origin : target < other.target;
+        }
+
+        // whether either side of the connection starts with a port prefix, like "effect_1:"
+        bool uses(const std::string& prefix) const noexcept
+        {
+            return origin.compare(0, prefix.size(), prefix) == 0 || target.compare(0, prefix.size(), prefix) == 0;
+        }
+    };
+    using HostConnectionGraph = std::set<HostConnection>;
+
+    // preset switch crossfade through a mixer tool, see setPresetSwitchCrossfadeTool
+    struct PresetSwitchCrossfade {
+        // full jack port names of the tool, empty mixSymbol means not in use
+        std::string mixSymbol;
+        std::array<std::array<std::string, 2>, 2> inputs;
+        std::array<std::string, 2> outputs;
+        int16_t instance = 0;
+        uint32_t timeMs = PRESET_SWITCH_CROSSFADE_MS;
+        // mixer inputs where the active preset goes into, 0 for A and 1 for B
+        uint8_t active = 0;
+        // preset still heard through the other mixer inputs, NUM_PRESETS_PER_BANK if no crossfade is running
+        uint8_t fadingPreset = NUM_PRESETS_PER_BANK;
+        std::chrono::steady_clock::time_point start;
+    } _crossfade;
+
+    // audio connections of the active preset chains as currently made in mod-host
+    // only the active preset is ever connected, inactive presets have no connections
+    HostConnectionGraph _connections;
+
     // current connector callback
     Callback* _callback = nullptr;
 
@@ -354,7 +570,9 @@ public:
     // whether the host connection is working
     bool ok = false;
 
-    // try to reconnect host if it previously failed
+    // try to reconnect host if it previously failed or the connection was lost (e.g. mod-host restart)
+    // mod-host state is brought back in sync with the current bank, the active preset becomes audible first
+    // NOTE tools, audio level monitors and output monitors need to be setup again if mod-host was restarted
     bool reconnect();
 
     // get last error from host in case something failed
@@ -391,6 +609,9 @@ public:
     // print current state for debugging
     void printStateForDebug(bool withBlocks, bool withParams, bool withBindings) const;
 
+    // get how many host messages were skipped so far because mod-host already had the requested state
+    [[nodiscard]] Host::SkippedMessages getSkippedHostMessages() const { return _host.skipped_messages(); }
+
     // ----------------------------------------------------------------------------------------------------------------
     // cpu load handling
 
@@ -440,15 +661,38 @@ public:
     // bank handling
 
     // load bank from a set of preset files and activate the first
+    // the initial preset is made audible first, other presets are preloaded during `pollHostUpdates()`
+    // if the same files were given to `prepareBankFromPresetFiles()` before, this is just a quick switch with audio fades
     void loadBankFromPresetFiles(const std::array<std::string, NUM_PRESETS_PER_BANK>& filenames,
                                  uint8_t initialPresetToLoad = 0);
 
+    // preload a bank from a set of preset files into spare instances, while the current bank keeps playing
+    // only one bank can be prepared at a time, preparing another one replaces it
+    // returns false if no bank was loaded yet, as the first bank load needs to clear mod-host state
+    // also returns false unless built with PREPARED_BANK_INSTANCES, which reserves the instance range for this
+    // NOTE blocks while all presets of the bank get loaded
+    bool prepareBankFromPresetFiles(const std::array<std::string, NUM_PRESETS_PER_BANK>& filenames);
+
+    // get timings of the last bank load
+    const BankLoadTimings& getLastBankLoadTimings() const noexcept { return _bankLoadTimings; }
+
     // ----------------------------------------------------------------------------------------------------------------
     // preset handling
 
     // get the name of an arbitrary preset file
+    // uses the preset library index if the file did not change since it was indexed
     static std::string getPresetNameFromFile(const char* filename);
 
+    // get the details of all preset files inside a directory, sorted by filename
+    // details are kept in a persistent index inside the connector cache directory (MOD_CONNECTOR_CACHE_PATH),
+    // only new or modified preset files (based on their mtime) are parsed again
+    static std::vector<PresetLibraryEntry> getPresetLibrary(const char* dirpath);
+
+    // get the details of a single preset file, using the preset library index
+    // a changed entry rewrites the whole index, prefer getPresetLibrary when listing many presets
+    // returns false if the file is not a valid preset
+    static bool getPresetLibraryEntry(const char* filename, PresetLibraryEntry& entry);
+
     // load preset from a file, automatically replacing the current preset and optionally the default too
     // returning false means the current chain was unchanged, likely because the file contains invalid state
     bool loadCurrentPresetFromFile(const char* filename, bool replaceDefault);
@@ -496,6 +740,11 @@ public:
     // returning false means the current chain was unchanged
     bool switchPreset(uint8_t preset);
 
+    // request a switch to another preset within the current bank, done during the next `pollHostUpdates()`
+    // requests arriving before then are coalesced into a single switch to the latest requested preset
+    // can be called from any thread
+    void requestSwitchPreset(uint8_t preset);
+
     // rename a preset within the current bank
     void renamePreset(uint8_t preset, const char* name);
 
@@ -535,6 +784,28 @@ public:
     // this is done by saving an lv2 preset of the plugin inside the block
     bool saveBlockStateAsDefault(uint8_t row, uint8_t block);
 
+    // copy a block into another preset of the current bank, replacing the block in the destination
+    // the destination plugin instance is reused when it is the same plugin, only changed values are sent
+    // bindings are not copied
+    // returning false means nothing was changed
+    bool copyBlockToPreset(uint8_t preset,
+                           uint8_t row,
+                           uint8_t block,
+                           uint8_t destPreset,
+                           uint8_t destRow,
+                           uint8_t destBlock);
+
+    // move a block into another preset of the current bank, replacing the block in the destination
+    // the plugin instance is transferred as-is, leaving the source block empty
+    // bindings are not moved
+    // returning false means nothing was changed
+    bool moveBlockToPreset(uint8_t preset,
+                           uint8_t row,
+                           uint8_t block,
+                           uint8_t destPreset,
+                           uint8_t destRow,
+                           uint8_t destBlock);
+
     // convenience calls for single-chain builds
    #if NUM_BLOCK_CHAIN_ROWS == 1
     inline bool enableBlock(const uint8_t block, const bool enable, const SceneMode sceneMode)
@@ -784,6 +1055,31 @@ public:
     // enable monitoring for tool output parameter
     void monitorToolOutputParameter(uint8_t toolIndex, const char* symbol, bool enable = true);
 
+    // use a mixer tool for crossfading presets when switching, see setPresetSwitchCrossfadeTime
+    // the tool must mix 2 stereo inputs (A and B) into a stereo output, according to a control parameter
+    // where 0 means only inputs A are heard and 1 only inputs B
+    // the active preset goes into one of the input pairs, tool outputs are connected to the playback ports
+    // passing null or empty mixSymbol stops using the tool, connecting presets directly to playback again
+    // NOTE the tool must already be enabled, and set again here if mod-host was restarted (until then it is not used)
+    bool setPresetSwitchCrossfadeTool(uint8_t toolIndex,
+                                      const char* mixSymbol,
+                                      const char* inSymbolAL,
+                                      const char* inSymbolAR,
+                                      const char* inSymbolBL,
+                                      const char* inSymbolBR,
+                                      const char* outSymbolL,
+                                      const char* outSymbolR);
+
+    // set the crossfade time for preset switches, 0 means fading out, switching and then fading back in
+    // crossfade needs a mixer tool, see setPresetSwitchCrossfadeTool
+    // the mixer is moved a step on each `pollHostUpdates()`, so that needs to be called often during a crossfade
+    void setPresetSwitchCrossfadeTime(uint32_t timeMs);
+
+    // set how long delay and reverb blocks of the previous preset keep ringing after a preset switch
+    // their inputs are disconnected and outputs go straight to playback, 0 disables spillover
+    // NOTE ringing blocks count towards the spare instances budget, see setInstancePoolBudget
+    void setPresetSwitchSpilloverTime(uint32_t timeMs);
+
     // ----------------------------------------------------------------------------------------------------------------
     // properties
 
@@ -827,6 +1123,15 @@ public:
     // NOTE path must end with OS-specific path separator (e.g. '/' under Linux)
     bool bundleRemove(const char* path);
 
+    // watch LV2_PATH directories and add or remove bundles as they are installed or uninstalled
+    // changes are applied to the LV2 world in the background, and to the host during `pollHostUpdates()`
+    // NOTE only supported on Linux
+    bool watchPluginBundles(bool enable, uint32_t debounceMs = 500);
+
+    // set the maximum number of spare plugin instances kept loaded for reuse, 0 disables reuse
+    // removed blocks keep their instance deactivated in mod-host, so new blocks using the same plugin load faster
+    void setInstancePoolBudget(uint16_t maxInstances);
+
     // ----------------------------------------------------------------------------------------------------------------
 
     // class to activate non-blocking mode during a function scope, same as Host::NonBlockingScope.
@@ -847,22 +1152,84 @@ public:
     // ----------------------------------------------------------------------------------------------------------------
 
 protected:
-    // load host state as stored in the `current` struct
-    // also preloads the other presets in the bank
-    void hostClearAndLoadCurrentBank();
-
-    void hostConnectAll(uint8_t row, uint8_t blockStart = 0, uint8_t blockEnd = NUM_BLOCKS_PER_PRESET - 1);
-    void hostConnectBlockToBlock(uint8_t row, uint8_t blockA, uint8_t blockB);
-    void hostConnectBlockToChainInput(uint8_t row, uint8_t block);
-    void hostConnectBlockToChainOutput(uint8_t row, uint8_t block);
-    void hostConnectChainEndpoints(uint8_t row);
-
-    void hostDisconnectAll(bool disconnectSideChains = false);
-    void hostDisconnectAllBlockInputs(uint8_t row, uint8_t block, bool disconnectSideChains = false);
-    void hostDisconnectAllBlockOutputs(uint8_t row, uint8_t block, bool disconnectSideChains = false);
-    void hostDisconnectAllBlockInputs(const Block& blockdata, const HostBlockPair& hbp, bool disconnectSideChains = false);
-    void hostDisconnectAllBlockOutputs(const Block& blockdata, const HostBlockPair& hbp, bool disconnectSideChains = false);
-    void hostDisconnectChainEndpoints(uint8_t row);
+    // replace the current bank with the one parsed into `_nextBank.presets`, starting with `preset`
+    // instances of the previous bank with a plugin used in the new bank are kept for reuse, all others are removed
+    // other presets in the bank are marked for preloading later, see hostRunDeferredWork
+    void hostClearAndLoadCurrentBank(uint8_t preset);
+
+    // unmap all instances of the current bank, keeping as spares the ones with a plugin used in `presets`
+    // and removing the rest, spare instances not needed for `presets` are removed too
+    void hostReleaseBankInstances(const std::array<Preset, NUM_PRESETS_PER_BANK>& presets);
+
+    // bring a newly connected mod-host in sync with the current bank, returns false if the connection failed again
+    // a restarted mod-host gets all presets loaded from memory (including unsaved changes), active preset first
+    bool hostResync();
+
+    // disconnect direct endpoint connections a fresh mod-host might start with
+    void hostDisconnectLeftoverEndpoints();
+
+    // forget all instances, after having removed all of them from mod-host
+    void forgetAllInstances();
+
+    // with no instances mapped, load the active preset right away
+    // and mark other presets for preloading later, see hostRunDeferredWork
+    void hostReloadAllPresets();
+
+    // do pending deferred work in small steps, until running out of work or over the time budget
+    // does nothing if a user-facing command was received recently, returns false if there was no work done
+    // stops early if a preset switch gets requested meanwhile
+    bool hostRunDeferredWork();
+
+    // make sure a preset is ready for use, doing any of its pending deferred work right away
+    void hostEnsurePresetLoaded(uint8_t preset);
+
+    // swap active bank data and instance mapping with the prepared bank, does not trigger host commands
+    void swapPreparedBank();
+
+    // make the prepared bank the active one, starting with `preset`
+    // audio is faded out and back in around the swap of active instances and connections, as in preset switches
+    // instances of the previous bank are removed later, as deferred work
+    void hostSwitchToPreparedBank(uint8_t preset);
+
+    // remove instances of the prepared bank, if any, and of previous banks still waiting for removal
+    void hostDropPreparedBank();
+
+    // remove instances of previous banks still waiting for removal
+    void hostRemoveLeftoverInstances();
+
+    // restore one block of a preset switched away from back to its default state
+    void hostRestorePresetBlock(uint8_t preset, const Preset& prev, uint8_t row, uint8_t block);
+
+    // find delay and reverb blocks of a preset being switched away from that can keep ringing, within budget
+    void getSpilloverTails(const Preset& prev, uint8_t preset, std::vector<DeferredPresetWork::Tail>& tails) const;
+
+    // disconnect and deactivate the blocks of a preset left ringing after a switch, if any
+    void hostEndSpillover(uint8_t preset);
+
+    // same as above, for all presets whose blocks were left ringing for long enough
+    void hostEndExpiredSpillover();
+
+    // take note of a user-facing command, delaying deferred work
+    void markUserCommand() noexcept { _lastUserCommand = std::chrono::steady_clock::now(); }
+
+    // collect all audio connections the active preset should have, including sidechain and dual-mono ones
+    void getConnections(HostConnectionGraph& graph) const;
+
+    // make the connections in mod-host match the active preset, only sending the needed connect/disconnect
+    void hostUpdateConnections();
+
+    // the 2 steps of hostUpdateConnections, for when something needs to happen in between
+    void hostRemoveOutdatedConnections(const HostConnectionGraph& graph);
+    void hostAddMissingConnections(const HostConnectionGraph& graph);
+
+    // disconnect all known connections of a block instance and its pair
+    void hostDisconnectBlockPair(const HostBlockPair& hbp);
+
+    // forget about known connections of an instance that mod-host has dropped on its own, -1 for all instances
+    void forgetConnections(int16_t id);
+
+    // forget about known connections and port names of a removed instance, -1 for all instances
+    void forgetInstance(int16_t id);
 
     void hostEnsureStereoChain(uint8_t preset, uint8_t row, uint8_t blockStart = 0, bool recursive = false);
 
@@ -873,12 +1240,54 @@ protected:
 
     void hostRemoveInstanceForBlock(uint8_t row, uint8_t block);
 
+    // map a block to a spare instance of a plugin if available, otherwise to a new preloaded one
+    bool hostPreloadInstanceForBlock(uint8_t preset, uint8_t row, uint8_t block, const char* uri, uint16_t& id);
+
+    // unmap a block and keep its instance(s) as spare if within budget, removing them otherwise
+    void hostReleaseInstanceForBlock(uint8_t preset, uint8_t row, uint8_t block, const Block& blockdata);
+
+    // keep already unmapped block instance(s) as spare if within budget, removing them otherwise
+    void hostReleaseBlockPair(const HostBlockPair& hbp, const Block& blockdata);
+
+    // bring already unmapped block instance(s) back to a freshly preloaded state and keep them as spare
+    void hostKeepBlockPairAsSpare(const HostBlockPair& hbp, const Block& blockdata);
+
+    // take a spare instance of a plugin, returns false if there is none
+    bool takeSpareInstance(const char* uri, uint16_t& id);
+
+    // remove spare instances until there are at most `size` left
+    void hostTrimInstancePool(uint16_t size);
+
 private:
-    void hostConnectChainEndpointsAction(uint8_t row, bool connect);
-    void hostConnectChainInputAction(uint8_t row, uint8_t block, bool connect);
-    void hostConnectChainOutputAction(uint8_t row, uint8_t block, bool connect);
+    // full jack port name of an audio port of an instance, cached when first needed
+    const std::string& getInstancePortName(uint16_t id, const std::shared_ptr<const Lv2Plugin>& plugin, size_t port) const;
+    const InstancePortNames& cacheInstancePortNames(uint16_t id, const std::shared_ptr<const Lv2Plugin>& plugin) const;
+
+    // playback ports of a chain row, which for the first row are the crossfade mixer inputs if in use
+    const std::array<std::string, 2>& getChainPlayback(uint8_t row) const;
+
+    void addChainEndpointConnections(HostConnectionGraph& graph, uint8_t row) const;
+    void addChainInputConnections(HostConnectionGraph& graph, uint8_t row, uint8_t block) const;
+    void addChainOutputConnections(HostConnectionGraph& graph, uint8_t row, uint8_t block) const;
+    void addBlockOutputConnections(HostConnectionGraph& graph,
+                                   const HostBlockPair& hbp,
+                                   const std::shared_ptr<const Lv2Plugin>& plugin,
+                                   const std::array<std::string, 2>& playback) const;
+    void addBlockToBlockConnections(HostConnectionGraph& graph, uint8_t row, uint8_t blockA, uint8_t blockB) const;
     void hostDisconnectBlockAction(const Block& blockdata, const HostBlockPair& hbp, bool outputs, bool disconnectSideChains);
 
+    // shared implementation of copyBlockToPreset and moveBlockToPreset, to be used within a non-blocking scope
+    bool hostTransferBlock(uint8_t preset,
+                           uint8_t row,
+                           uint8_t block,
+                           uint8_t destPreset,
+                           uint8_t destRow,
+                           uint8_t destBlock,
+                           bool move);
+
+    // remove all bindings related to a block of any preset, returns true if any binding was removed
+    bool removeAllBlockBindings(Preset& presetdata, uint8_t row, uint8_t block) const;
+
     // loads preset data, does not trigger host commands
     void jsonPresetLoad(Preset& presetdata, const nlohmann::json& json) const;
 
@@ -886,10 +1295,46 @@ private:
     void jsonPresetSave(const Preset& presetdata, nlohmann::json& json) const;
 
     // load preset data from the current bank, only does host commands
+    // replays a cached load program when possible, compiling a new one otherwise
     void hostLoadPreset(uint8_t preset);
 
+    // turn preset data into a load program, assigning instances to its blocks
+    void compileLoadProgram(HostLoadProgram& program, uint8_t preset, const Preset& presetdata);
+
+    // assign instances to the blocks of an already compiled load program, retargeting it if they changed
+    void mapLoadProgram(HostLoadProgram& program, uint8_t preset);
+
+    // assign an instance to a block of a load program, preferring a spare instance of the same plugin
+    uint16_t mapLoadProgramInstance(HostLoadProgram& program,
+                                    uint8_t preset,
+                                    uint8_t row,
+                                    uint8_t block,
+                                    const char* uri,
+                                    bool pair);
+
+    // cached load program for preset data, nullptr if there is none or its file was modified since
+    HostLoadProgram* getCachedLoadProgram(const Preset& presetdata);
+
+    // drop all cached load programs, needed when plugin information changes
+    void forgetLoadPrograms();
+
     // unload "old" and load current preset, only does host commands
-    void hostSwitchPreset(const Current& old);
+    // uses a crossfade instead of fading out and in if setup, see setPresetSwitchCrossfadeTool
+    // the crossfade only starts here, the "old" preset keeps playing until it ends during `pollHostUpdates()`
+    // restoring the "old" preset to its defaults is deferred, old preset data is moved into the deferred work queue
+    void hostSwitchPreset(Current&& old);
+
+    // activate or deactivate all instances of a preset, except for its blocks left ringing
+    void hostActivatePreset(const Preset& presetdata, uint8_t preset, bool activate);
+
+    // move the crossfade mixer a step closer to the active preset inputs, called during `pollHostUpdates()`
+    // the crossfade ends once its time is up, see hostEndCrossfade
+    void hostRunCrossfade();
+
+    // move the crossfade mixer fully over to the active preset inputs, disconnecting and deactivating the previous one
+    // must be called before anything else changes the active preset or the mixer, does nothing if no crossfade is running
+    // NOTE hostUpdateConnections calls this too, as connections of the previous preset are only kept during a crossfade
+    void hostEndCrossfade();
 
     // add (active==true) or preload block defined by blockdata to instance_number
     bool hostLoadInstance(const Block& blockdata, uint16_t instance_number, bool active);
@@ -914,13 +1359,14 @@ private:
     // internal feedback handling, for updating parameter values
     void hostFeedbackCallback(const HostFeedbackData& data) override;
 
-    // init block using plugin default values, optionally fill index maps
-    void initBlock(Block& blockdata,
-                   const std::shared_ptr<const Lv2Plugin>& plugin,
-                   uint8_t numInputs,
-                   uint8_t numOutputs,
-                   uint8_t numSideInputs,
-                   uint8_t numSideOutputs) const;
+    // init block from a plugin prototype, then apply user defaults
+    void initBlock(Block& blockdata, const BlockPrototype& proto) const;
+
+    // get cached prototype for a plugin, creating it if needed
+    const BlockPrototype& getBlockPrototype(const std::shared_ptr<const Lv2Plugin>& plugin) const;
+
+    // get user defaults for a block, or null if there are none
+    const BlockDefaults* getBlockDefaults(const Block& blockdata) const;
 
     void allocBlock(Block& blockdata) const;
     void resetBlock(Block& blockdata) const;
@@ -936,6 +1382,7 @@ using HostBindings = HostConnector::Bindings;
 using HostBlock = HostConnector::Block;
 using HostParameter = HostConnector::Parameter;
 using HostParameterBinding = HostConnector::ParameterBinding;
+using HostPresetLibraryEntry = HostConnector::PresetLibraryEntry;
 using HostProperty = HostConnector::Property;
 using HostPropertyBinding = HostConnector::PropertyBinding;
 using HostSceneMode = HostConnector::SceneMode;
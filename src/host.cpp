@@ -12,6 +12,9 @@
 #include <cassert>
 #include <cstring>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // --------------------------------------------------------------------------------------------------------------------
 
@@ -160,8 +163,19 @@ struct Host::Impl
         }
        #endif
 
+        // drop broken connection, mod-host might have been restarted
+        if (connectionLost)
+        {
+            connectionLost = false;
+            ipc.reset();
+        }
+
         if (ipc == nullptr)
+        {
+            // a new connection might be to a different mod-host, nothing can be assumed about it
+            instances.clear();
             ipc.reset(IPC::createDualSocketIPC(portNumber));
+        }
 
         last_error = ipc->last_error;
 
@@ -182,7 +196,29 @@ struct Host::Impl
 
     void setWriteBlockingAndWait(const bool blocking)
     {
+        assert(! batching);
+
+        nonBlocking = ! blocking;
         ipc->setWriteBlockingAndWait(blocking);
+
+        if (! blocking)
+            return;
+
+        // waiting for replies only fails on connection errors
+        if (! ipc->last_error.empty())
+            connectionLost = true;
+
+        // replies only arrive now, we cannot tell which of the messages failed
+        else if (const uint16_t numFailed = ipc->getNumFailedResponses())
+        {
+            mod_log_warn("%u non-blocking messages failed, forgetting state of %zu instances",
+                         numFailed, nonBlockingInstances.size());
+
+            for (const int16_t instance_number : nonBlockingInstances)
+                forgetInstanceState(instance_number);
+        }
+
+        nonBlockingInstances.clear();
     }
 
     bool writeMessageAndWait(const std::string& message,
@@ -202,6 +238,18 @@ struct Host::Impl
             return false;
         }
 
+        if (batching)
+        {
+            assert(resp == nullptr);
+
+            if (batchCount != 0)
+                batch.push_back('\0');
+
+            batch += message;
+            ++batchCount;
+            return true;
+        }
+
         if (ipc->writeMessage(message, respType, resp))
             return true;
 
@@ -210,13 +258,176 @@ struct Host::Impl
         else
             last_error = ipc->last_error;
 
+        // errors reported by mod-host itself come without an IPC error
+        if (! ipc->last_error.empty())
+            connectionLost = true;
+
         return false;
     }
 
+    // send all messages collected during a batch scope at once
+    void flushBatch()
+    {
+        if (batchCount == 0)
+            return;
+
+        if (ipc != nullptr && ! ipc->writeMessages(batch, batchCount))
+        {
+            last_error = ipc->last_error;
+            connectionLost = true;
+        }
+
+        batch.clear();
+        batchCount = 0;
+    }
+
+    // set when the connection to mod-host broke, so the next reconnect starts a new one
+    bool connectionLost = false;
+
+    // messages collected during a batch scope, separated by null characters
+    bool nonBlocking = false;
+    bool batching = false;
+    std::string batch;
+    uint16_t batchCount = 0;
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // last known state of plugin instances in mod-host, used to skip messages that would not change anything
+
+    struct InstanceState {
+        // -1 while unknown
+        int8_t active = -1;
+        int8_t bypassed = -1;
+        // values not listed here are unknown and always sent
+        std::unordered_map<std::string, float> params;
+        std::unordered_map<std::string, std::string> patches;
+        // parameters that mod-host can change on its own, never skipped
+        std::unordered_set<std::string> mapped;
+    };
+
+    std::unordered_map<int16_t, InstanceState> instances;
+    SkippedMessages skipped = {};
+
+    // instances touched while in non-blocking mode, their state is only confirmed once replies arrive
+    std::unordered_set<int16_t> nonBlockingInstances;
+
+    // returns null for instances not added through this class, which are never skipped
+    InstanceState* getInstanceState(const int16_t instance_number)
+    {
+        const auto it = instances.find(instance_number);
+        if (it == instances.end())
+            return nullptr;
+
+        if (nonBlocking)
+            nonBlockingInstances.insert(instance_number);
+
+        return &it->second;
+    }
+
+    void setInstanceAdded(const int16_t instance_number, const bool active)
+    {
+        if (nonBlocking)
+            nonBlockingInstances.insert(instance_number);
+
+        InstanceState& state = instances[instance_number];
+        state = {};
+        state.active = active ? 1 : 0;
+        state.bypassed = 0;
+    }
+
+    // unknown state is always the safe choice, used on errors and on removal
+    void forgetInstance(const int16_t instance_number)
+    {
+        if (instance_number < 0)
+            instances.clear();
+        else
+            instances.erase(instance_number);
+    }
+
+    // keeps the instance and its mapped parameters, everything else becomes unknown
+    void forgetInstanceState(const int16_t instance_number)
+    {
+        const auto it = instances.find(instance_number);
+        if (it == instances.end())
+            return;
+
+        InstanceState& state = it->second;
+        state.active = -1;
+        state.bypassed = -1;
+        state.params.clear();
+        state.patches.clear();
+    }
+
+    // for messages that change parameters or properties in ways we cannot follow
+    void forgetInstanceValues(const int16_t instance_number)
+    {
+        if (InstanceState* const state = getInstanceState(instance_number))
+        {
+            state->params.clear();
+            state->patches.clear();
+        }
+    }
+
+    bool isActive(const int16_t instance_number, const bool active)
+    {
+        const InstanceState* const state = getInstanceState(instance_number);
+        return state != nullptr && state->active == (active ? 1 : 0);
+    }
+
+    bool isBypassed(const int16_t instance_number, const bool bypassed)
+    {
+        const InstanceState* const state = getInstanceState(instance_number);
+        return state != nullptr && state->bypassed == (bypassed ? 1 : 0) && state->mapped.count(":bypass") == 0;
+    }
+
+    bool isParameterSet(const int16_t instance_number, const char* const symbol, const float value)
+    {
+        const InstanceState* const state = getInstanceState(instance_number);
+        if (state == nullptr)
+            return false;
+
+        const auto it = state->params.find(symbol);
+        return it != state->params.end() && isEqual(it->second, value);
+    }
+
+    void setParameter(const int16_t instance_number, const char* const symbol, const float value)
+    {
+        if (InstanceState* const state = getInstanceState(instance_number))
+        {
+            if (state->mapped.count(symbol) == 0)
+                state->params[symbol] = value;
+        }
+    }
+
+    void setParameterMapped(const int16_t instance_number, const char* const symbol, const bool mapped)
+    {
+        if (InstanceState* const state = getInstanceState(instance_number))
+        {
+            state->params.erase(symbol);
+
+            if (mapped)
+                state->mapped.insert(symbol);
+            else
+                state->mapped.erase(symbol);
+        }
+    }
+
+    // params given to a flush are applied after the optional reset
+    void setParametersFlushed(const int16_t instance_number,
+                              const uint8_t reset_value,
+                              const unsigned int param_count,
+                              const flushed_param* const params)
+    {
+        if (reset_value != 0)
+            forgetInstanceValues(instance_number);
+
+        for (unsigned int i = 0; i < param_count; ++i)
+            setParameter(instance_number, params[i].symbol, params[i].value);
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // feedback port handling
 
-    [[nodiscard]] bool poll(FeedbackCallback* const callback) const
+    [[nodiscard]] bool poll(FeedbackCallback* const callback)
     {
         std::string error;
 
@@ -226,7 +437,7 @@ struct Host::Impl
     }
 
 private:
-    [[nodiscard]] bool _poll(FeedbackCallback* const callback, std::string& error) const
+    [[nodiscard]] bool _poll(FeedbackCallback* const callback, std::string& error)
     {
         uint32_t bytesRead;
         char* const buffer = ipc->readMessage(&bytesRead);
@@ -307,6 +518,16 @@ private:
             msgbuffer = sep;
             d.paramSet.value = std::atof(msgbuffer);
 
+            if (std::strcmp(d.paramSet.symbol, ":bypass") == 0)
+            {
+                if (InstanceState* const state = getInstanceState(d.paramSet.effect_id))
+                    state->bypassed = d.paramSet.value > 0.5f ? 1 : 0;
+            }
+            else
+            {
+                setParameter(d.paramSet.effect_id, d.paramSet.symbol, d.paramSet.value);
+            }
+
             callback->hostFeedbackCallback(d);
         }
         else if (std::strncmp(buffer, "param_state ", 12) == 0)
@@ -493,6 +714,21 @@ private:
                 break;
             }
 
+            if (InstanceState* const state = getInstanceState(d.patchSet.effect_id))
+            {
+                switch (d.patchSet.type)
+                {
+                case 's':
+                case 'p':
+                case 'u':
+                    state->patches[d.patchSet.key] = d.patchSet.data.s;
+                    break;
+                default:
+                    state->patches.erase(d.patchSet.key);
+                    break;
+                }
+            }
+
             callback->hostFeedbackCallback(d);
             std::free(ptr2free);
         }
@@ -679,6 +915,7 @@ private:
 
     friend class NonBlockingScope;
     friend class NonBlockingScopeWithAudioFades;
+    friend class BatchScope;
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -714,6 +951,26 @@ Host::NonBlockingScopeWithAudioFades::~NonBlockingScopeWithAudioFades()
     host.impl->setWriteBlockingAndWait(true);
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+
+Host::BatchScope::BatchScope(Host& host_)
+    : host(host_)
+{
+    assert(! host.impl->batching);
+
+    // messages need to be replied one by one in blocking mode
+    host.impl->batching = host.impl->nonBlocking;
+}
+
+Host::BatchScope::~BatchScope()
+{
+    if (! host.impl->batching)
+        return;
+
+    host.impl->batching = false;
+    host.impl->flushBatch();
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // input validation for debug builds
 
@@ -803,18 +1060,33 @@ static std::string escape(const char* const str)
     return str;
 }
 
+// quote character for jack port names that need it, used inline in messages to avoid escaped copies of the names
+static const char* port_quote(const char* const port)
+{
+    return std::strchr(port, ' ') != nullptr ? "\"" : "";
+}
+
 bool Host::add(const char* const uri, const int16_t instance_number)
 {
     VALIDATE_INSTANCE_NUMBER(instance_number);
     VALIDATE_URI(uri);
 
-    return impl->writeMessageAndWait(format("add %s %d", uri, instance_number));
+    if (! impl->writeMessageAndWait(format("add %s %d", uri, instance_number)))
+    {
+        impl->forgetInstance(instance_number);
+        return false;
+    }
+
+    impl->setInstanceAdded(instance_number, true);
+    return true;
 }
 
 bool Host::remove(const int16_t instance_number)
 {
     VALIDATE_INSTANCE_REMOVE_NUMBER(instance_number);
 
+    impl->forgetInstance(instance_number);
+
     return impl->writeMessageAndWait(format("remove %d", instance_number));
 }
 
@@ -822,8 +1094,18 @@ bool Host::activate(const int16_t instance_number, const bool activate_value)
 {
     VALIDATE_INSTANCE_NUMBER(instance_number);
 
-    return impl->writeMessageAndWait(format("activate %d %d",
-                                            instance_number, activate_value ? 1 : 0));
+    if (impl->isActive(instance_number, activate_value))
+    {
+        ++impl->skipped.activate;
+        return true;
+    }
+
+    const bool ok = impl->writeMessageAndWait(format("activate %d %d", instance_number, activate_value ? 1 : 0));
+
+    if (Impl::InstanceState* const state = impl->getInstanceState(instance_number))
+        state->active = ok ? (activate_value ? 1 : 0) : -1;
+
+    return ok;
 }
 
 bool Host::preload(const char* const uri, const int16_t instance_number)
@@ -831,7 +1113,30 @@ bool Host::preload(const char* const uri, const int16_t instance_number)
     VALIDATE_INSTANCE_NUMBER(instance_number);
     VALIDATE_URI(uri);
 
-    return impl->writeMessageAndWait(format("preload %s %d", uri, instance_number));
+    if (! impl->writeMessageAndWait(format("preload %s %d", uri, instance_number)))
+    {
+        impl->forgetInstance(instance_number);
+        return false;
+    }
+
+    impl->setInstanceAdded(instance_number, false);
+    return true;
+}
+
+int Host::preload_probe(const char* const uri, const int16_t instance_number)
+{
+    VALIDATE_INSTANCE_NUMBER(instance_number);
+    VALIDATE_URI(uri);
+
+    IPC::Response resp = {};
+    if (impl->writeMessageAndWait(format("preload %s %d", uri, instance_number), IPC::kResponseNone, &resp))
+    {
+        impl->setInstanceAdded(instance_number, false);
+        return 0;
+    }
+
+    impl->forgetInstance(instance_number);
+    return resp.code == ERR_INSTANCE_ALREADY_EXISTS ? 1 : -1;
 }
 
 bool Host::preset_load(const int16_t instance_number, const char* const preset_uri)
@@ -839,6 +1144,8 @@ bool Host::preset_load(const int16_t instance_number, const char* const preset_u
     VALIDATE_INSTANCE_NUMBER(instance_number);
     VALIDATE_URI(preset_uri);
 
+    impl->forgetInstanceValues(instance_number);
+
     return impl->writeMessageAndWait(format("preset_load %d %s", instance_number, preset_uri));
 }
 
@@ -875,10 +1182,13 @@ bool Host::connect(const char* const origin_port, const char* const destination_
     VALIDATE_JACK_PORT(origin_port);
     VALIDATE_JACK_PORT(destination_port);
 
-    return impl->writeMessageAndWait(format("%s %s %s",
-                                            safe ? "connect_safe" : "connect" ,
-                                            escape(origin_port).c_str(),
-                                            escape(destination_port).c_str()));
+    const char* const qo = port_quote(origin_port);
+    const char* const qd = port_quote(destination_port);
+
+    return impl->writeMessageAndWait(format("%s %s%s%s %s%s%s",
+                                            safe ? "connect_safe" : "connect",
+                                            qo, origin_port, qo,
+                                            qd, destination_port, qd));
 }
 
 bool Host::connect_matching(const char* const matching_port, const char* const destination_port)
@@ -886,8 +1196,12 @@ bool Host::connect_matching(const char* const matching_port, const char* const d
     VALIDATE_JACK_PORT(matching_port);
     VALIDATE_JACK_PORT(destination_port);
 
-    return impl->writeMessageAndWait(format("connect_matching %s %s",
-                                            escape(matching_port).c_str(), escape(destination_port).c_str()));
+    const char* const qm = port_quote(matching_port);
+    const char* const qd = port_quote(destination_port);
+
+    return impl->writeMessageAndWait(format("connect_matching %s%s%s %s%s%s",
+                                            qm, matching_port, qm,
+                                            qd, destination_port, qd));
 }
 
 bool Host::disconnect(const char* const origin_port, const char* const destination_port, const bool safe)
@@ -895,24 +1209,40 @@ bool Host::disconnect(const char* const origin_port, const char* const destinati
     VALIDATE_JACK_PORT(origin_port);
     VALIDATE_JACK_PORT(destination_port);
 
-    return impl->writeMessageAndWait(format("%s %s %s",
-                                            safe ? "disconnect_safe" : "disconnect" ,
-                                            escape(origin_port).c_str(),
-                                            escape(destination_port).c_str()));
+    const char* const qo = port_quote(origin_port);
+    const char* const qd = port_quote(destination_port);
+
+    return impl->writeMessageAndWait(format("%s %s%s%s %s%s%s",
+                                            safe ? "disconnect_safe" : "disconnect",
+                                            qo, origin_port, qo,
+                                            qd, destination_port, qd));
 }
 
 bool Host::disconnect_all(const char* const origin_port)
 {
     VALIDATE_JACK_PORT(origin_port);
 
-    return impl->writeMessageAndWait(format("disconnect_all %s", escape(origin_port).c_str()));
+    const char* const qo = port_quote(origin_port);
+
+    return impl->writeMessageAndWait(format("disconnect_all %s%s%s", qo, origin_port, qo));
 }
 
 bool Host::bypass(const int16_t instance_number, const bool bypass_value)
 {
     VALIDATE_INSTANCE_NUMBER(instance_number);
 
-    return impl->writeMessageAndWait(format("bypass %d %d", instance_number, bypass_value ? 1 : 0));
+    if (impl->isBypassed(instance_number, bypass_value))
+    {
+        ++impl->skipped.bypass;
+        return true;
+    }
+
+    const bool ok = impl->writeMessageAndWait(format("bypass %d %d", instance_number, bypass_value ? 1 : 0));
+
+    if (Impl::InstanceState* const state = impl->getInstanceState(instance_number))
+        state->bypassed = ok ? (bypass_value ? 1 : 0) : -1;
+
+    return ok;
 }
 
 bool Host::param_set(const int16_t instance_number, const char* const param_symbol, const float param_value)
@@ -920,7 +1250,21 @@ bool Host::param_set(const int16_t instance_number, const char* const param_symb
     VALIDATE_INSTANCE_NUMBER(instance_number);
     VALIDATE_SYMBOL(param_symbol);
 
-    return impl->writeMessageAndWait(format("param_set %d %s %f", instance_number, param_symbol, param_value));
+    if (impl->isParameterSet(instance_number, param_symbol, param_value))
+    {
+        ++impl->skipped.param_set;
+        return true;
+    }
+
+    if (! impl->writeMessageAndWait(format("param_set %d %s %f", instance_number, param_symbol, param_value)))
+    {
+        if (Impl::InstanceState* const state = impl->getInstanceState(instance_number))
+            state->params.erase(param_symbol);
+        return false;
+    }
+
+    impl->setParameter(instance_number, param_symbol, param_value);
+    return true;
 }
 
 float Host::param_get(const int16_t instance_number, const char* const param_symbol)
@@ -961,7 +1305,14 @@ bool Host::params_flush(const int16_t instance_number,
         msg += format(" %s %f", params[i].symbol, params[i].value);
     }
 
-    return impl->writeMessageAndWait(msg);
+    if (! impl->writeMessageAndWait(msg))
+    {
+        impl->forgetInstanceValues(instance_number);
+        return false;
+    }
+
+    impl->setParametersFlushed(instance_number, reset_value, param_count, params);
+    return true;
 }
 
 bool Host::pre_run(const int16_t instance_number,
@@ -979,7 +1330,14 @@ bool Host::pre_run(const int16_t instance_number,
         msg += format(" %s %f", params[i].symbol, params[i].value);
     }
 
-    return impl->writeMessageAndWait(msg);
+    if (! impl->writeMessageAndWait(msg))
+    {
+        impl->forgetInstanceValues(instance_number);
+        return false;
+    }
+
+    impl->setParametersFlushed(instance_number, reset_value, param_count, params);
+    return true;
 }
 
 bool Host::patch_set(const int16_t instance_number, const char* const property_uri, const char* const value)
@@ -987,8 +1345,29 @@ bool Host::patch_set(const int16_t instance_number, const char* const property_u
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_URI(property_uri)
 
-    return impl->writeMessageAndWait(format("patch_set %d %s %s",
-                                            instance_number, property_uri, escape(value).c_str()));
+    Impl::InstanceState* const state = impl->getInstanceState(instance_number);
+
+    if (state != nullptr)
+    {
+        if (const auto it = state->patches.find(property_uri); it != state->patches.end() && it->second == value)
+        {
+            ++impl->skipped.patch_set;
+            return true;
+        }
+    }
+
+    if (! impl->writeMessageAndWait(format("patch_set %d %s %s",
+                                           instance_number, property_uri, escape(value).c_str())))
+    {
+        if (state != nullptr)
+            state->patches.erase(property_uri);
+        return false;
+    }
+
+    if (state != nullptr)
+        state->patches[property_uri] = value;
+
+    return true;
 }
 
 bool Host::patch_get(const int16_t instance_number, const char* const property_uri)
@@ -1035,6 +1414,8 @@ bool Host::midi_learn(const int16_t instance_number,
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
+    impl->setParameterMapped(instance_number, param_symbol, true);
+
     return impl->writeMessageAndWait(format("midi_learn %d %s %f %f",
                                             instance_number, param_symbol, minimum, maximum));
 }
@@ -1050,6 +1431,8 @@ bool Host::midi_map(const int16_t instance_number,
     VALIDATE_MIDI_CHANNEL(midi_channel)
     VALIDATE_SYMBOL(param_symbol)
 
+    impl->setParameterMapped(instance_number, param_symbol, true);
+
     return impl->writeMessageAndWait(format("midi_map %d %s %d %d %f %f",
                                             instance_number, param_symbol, midi_channel, midi_cc, minimum, maximum));
 }
@@ -1059,7 +1442,11 @@ bool Host::midi_unmap(const int16_t instance_number, const char* const param_sym
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
-    return impl->writeMessageAndWait(format("midi_unmap %d %s", instance_number, param_symbol));
+    if (! impl->writeMessageAndWait(format("midi_unmap %d %s", instance_number, param_symbol)))
+        return false;
+
+    impl->setParameterMapped(instance_number, param_symbol, false);
+    return true;
 }
 
 bool Host::monitor_audio_levels(const char* const source_port_name, bool enable)
@@ -1100,6 +1487,8 @@ bool Host::cc_map(const int16_t instance_number,
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
+    impl->setParameterMapped(instance_number, param_symbol, true);
+
     std::string msg = format("cc_map %d %s %d %d %s %f %f %f %d %d %s %u",
                              instance_number,
                              param_symbol,
@@ -1125,7 +1514,11 @@ bool Host::cc_unmap(const int16_t instance_number, const char* const param_symbo
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
-    return impl->writeMessageAndWait(format("cc_unmap %d %s", instance_number, param_symbol));
+    if (! impl->writeMessageAndWait(format("cc_unmap %d %s", instance_number, param_symbol)))
+        return false;
+
+    impl->setParameterMapped(instance_number, param_symbol, false);
+    return true;
 }
 
 bool Host::cc_value_set(const int16_t instance_number, const char* const param_symbol, const float value)
@@ -1147,6 +1540,8 @@ bool Host::cv_map(const int16_t instance_number,
     VALIDATE_JACK_PORT(source_port_name)
     VALIDATE_SYMBOL(param_symbol)
 
+    impl->setParameterMapped(instance_number, param_symbol, true);
+
     return impl->writeMessageAndWait(format("cv_map %d %s %s %f %f %c",
                                             instance_number,
                                             param_symbol,
@@ -1161,7 +1556,11 @@ bool Host::cv_unmap(const int16_t instance_number, const char* const param_symbo
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
-    return impl->writeMessageAndWait(format("cv_unmap %d %s", instance_number, param_symbol));
+    if (! impl->writeMessageAndWait(format("cv_unmap %d %s", instance_number, param_symbol)))
+        return false;
+
+    impl->setParameterMapped(instance_number, param_symbol, false);
+    return true;
 }
 
 bool Host::hmi_map(const int16_t instance_number,
@@ -1179,6 +1578,8 @@ bool Host::hmi_map(const int16_t instance_number,
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
+    impl->setParameterMapped(instance_number, param_symbol, true);
+
     return impl->writeMessageAndWait(format("hmi_map %d %s %d %d %d %d %d %s %f %f %d",
                                             instance_number,
                                             param_symbol,
@@ -1198,7 +1599,11 @@ bool Host::hmi_unmap(const int16_t instance_number, const char* const param_symb
     VALIDATE_INSTANCE_NUMBER(instance_number)
     VALIDATE_SYMBOL(param_symbol)
 
-    return impl->writeMessageAndWait(format("hmi_unmap %d %s", instance_number, param_symbol));
+    if (! impl->writeMessageAndWait(format("hmi_unmap %d %s", instance_number, param_symbol)))
+        return false;
+
+    impl->setParameterMapped(instance_number, param_symbol, false);
+    return true;
 }
 
 float Host::cpu_load()
@@ -1215,6 +1620,8 @@ float Host::max_cpu_load()
 
 bool Host::load(const char* const file_name)
 {
+    impl->forgetInstance(-1);
+
     return impl->writeMessageAndWait(format("load %s", escape(file_name).c_str()));
 }
 
@@ -1233,14 +1640,19 @@ bool Host::bundle_remove(const char* const bundle_path, const char* const resour
     if (resource != nullptr && resource[0] != '\0')
     {
         VALIDATE_URI(resource);
+        impl->forgetInstance(-1);
         return impl->writeMessageAndWait(format("bundle_remove %s %s", escape(bundle_path).c_str(), resource));
     }
 
+    impl->forgetInstance(-1);
     return impl->writeMessageAndWait(format("bundle_remove %s \"\"", escape(bundle_path).c_str()));
 }
 
 bool Host::state_load(const char* const dir)
 {
+    for (auto& it : impl->instances)
+        impl->forgetInstanceValues(it.first);
+
     return impl->writeMessageAndWait(format("state_load %s", escape(dir).c_str()));
 }
 
@@ -1344,7 +1756,17 @@ bool Host::multi_add(const unsigned int instance_count,
         msg += format(" %s %d", uris[i], instances[i]);
     }
 
-    return impl->writeMessageAndWait(msg);
+    if (! impl->writeMessageAndWait(msg))
+    {
+        for (unsigned int i = 0; i < instance_count; ++i)
+            impl->forgetInstance(instances[i]);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < instance_count; ++i)
+        impl->setInstanceAdded(instances[i], true);
+
+    return true;
 }
 
 bool Host::multi_remove(const unsigned int instance_count, const int16_t* const instances)
@@ -1357,6 +1779,7 @@ bool Host::multi_remove(const unsigned int instance_count, const int16_t* const
     {
         VALIDATE_INSTANCE_NUMBER(instances[i])
         msg += format(" %d", instances[i]);
+        impl->forgetInstance(instances[i]);
     }
 
     return impl->writeMessageAndWait(msg);
@@ -1368,15 +1791,42 @@ bool Host::multi_activate(const bool activate_value,
 {
     VALIDATE_INSTANCE_COUNT(instance_count);
 
-    std::string msg = format("multi_activate %d %u", activate_value ? 1 : 0, instance_count);
+    std::vector<int16_t> needed;
+    needed.reserve(instance_count);
 
     for (unsigned int i = 0; i < instance_count; ++i)
     {
         VALIDATE_INSTANCE_NUMBER(instances[i])
-        msg += format(" %d", instances[i]);
+
+        if (impl->isActive(instances[i], activate_value))
+            ++impl->skipped.activate;
+        else
+            needed.push_back(instances[i]);
     }
 
-    return impl->writeMessageAndWait(msg);
+    switch (needed.size())
+    {
+    case 0:
+        return true;
+    case 1:
+        return activate(needed.front(), activate_value);
+    }
+
+    const unsigned int needed_count = needed.size();
+    std::string msg = format("multi_activate %d %u", activate_value ? 1 : 0, needed_count);
+
+    for (const int16_t instance : needed)
+        msg += format(" %d", instance);
+
+    const bool ok = impl->writeMessageAndWait(msg);
+
+    for (const int16_t instance : needed)
+    {
+        if (Impl::InstanceState* const state = impl->getInstanceState(instance))
+            state->active = ok ? (activate_value ? 1 : 0) : -1;
+    }
+
+    return ok;
 }
 
 bool Host::multi_preload(const unsigned int instance_count,
@@ -1393,22 +1843,59 @@ bool Host::multi_preload(const unsigned int instance_count,
         msg += format(" %s %d", uris[i], instances[i]);
     }
 
-    return impl->writeMessageAndWait(msg);
+    if (! impl->writeMessageAndWait(msg))
+    {
+        for (unsigned int i = 0; i < instance_count; ++i)
+            impl->forgetInstance(instances[i]);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < instance_count; ++i)
+        impl->setInstanceAdded(instances[i], false);
+
+    return true;
 }
 
 bool Host::multi_bypass(const bool bypass_value, const unsigned int instance_count, const int16_t* const instances)
 {
     VALIDATE_INSTANCE_COUNT(instance_count);
 
-    std::string msg = format("multi_bypass %d %u", bypass_value ? 1 : 0, instance_count);
+    std::vector<int16_t> needed;
+    needed.reserve(instance_count);
 
     for (unsigned int i = 0; i < instance_count; ++i)
     {
         VALIDATE_INSTANCE_NUMBER(instances[i])
-        msg += format(" %d", instances[i]);
+
+        if (impl->isBypassed(instances[i], bypass_value))
+            ++impl->skipped.bypass;
+        else
+            needed.push_back(instances[i]);
     }
 
-    return impl->writeMessageAndWait(msg);
+    switch (needed.size())
+    {
+    case 0:
+        return true;
+    case 1:
+        return bypass(needed.front(), bypass_value);
+    }
+
+    const unsigned int needed_count = needed.size();
+    std::string msg = format("multi_bypass %d %u", bypass_value ? 1 : 0, needed_count);
+
+    for (const int16_t instance : needed)
+        msg += format(" %d", instance);
+
+    const bool ok = impl->writeMessageAndWait(msg);
+
+    for (const int16_t instance : needed)
+    {
+        if (Impl::InstanceState* const state = impl->getInstanceState(instance))
+            state->bypassed = ok ? (bypass_value ? 1 : 0) : -1;
+    }
+
+    return ok;
 }
 
 bool Host::multi_param_set(const char* const param_symbol,
@@ -1419,15 +1906,44 @@ bool Host::multi_param_set(const char* const param_symbol,
     VALIDATE_INSTANCE_COUNT(instance_count);
     VALIDATE_SYMBOL(param_symbol);
 
-    std::string msg = format("multi_param_set %s %f %u", param_symbol, param_value, instance_count);
+    std::vector<int16_t> needed;
+    needed.reserve(instance_count);
 
     for (unsigned int i = 0; i < instance_count; ++i)
     {
         VALIDATE_INSTANCE_NUMBER(instances[i])
-        msg += format(" %d", instances[i]);
+
+        if (impl->isParameterSet(instances[i], param_symbol, param_value))
+            ++impl->skipped.param_set;
+        else
+            needed.push_back(instances[i]);
     }
 
-    return impl->writeMessageAndWait(msg);
+    switch (needed.size())
+    {
+    case 0:
+        return true;
+    case 1:
+        return param_set(needed.front(), param_symbol, param_value);
+    }
+
+    const unsigned int needed_count = needed.size();
+    std::string msg = format("multi_param_set %s %f %u", param_symbol, param_value, needed_count);
+
+    for (const int16_t instance : needed)
+        msg += format(" %d", instance);
+
+    const bool ok = impl->writeMessageAndWait(msg);
+
+    for (const int16_t instance : needed)
+    {
+        if (ok)
+            impl->setParameter(instance, param_symbol, param_value);
+        else if (Impl::InstanceState* const state = impl->getInstanceState(instance))
+            state->params.erase(param_symbol);
+    }
+
+    return ok;
 }
 
 bool Host::multi_params_flush(const uint8_t reset_value,
@@ -1454,7 +1970,17 @@ bool Host::multi_params_flush(const uint8_t reset_value,
         msg += format(" %s %f", params[i].symbol, params[i].value);
     }
 
-    return impl->writeMessageAndWait(msg);
+    const bool ok = impl->writeMessageAndWait(msg);
+
+    for (unsigned int i = 0; i < instance_count; ++i)
+    {
+        if (ok)
+            impl->setParametersFlushed(instances[i], reset_value, param_count, params);
+        else
+            impl->forgetInstanceValues(instances[i]);
+    }
+
+    return ok;
 }
 
 bool Host::multi_pre_run(const uint8_t reset_value,
@@ -1481,7 +2007,17 @@ bool Host::multi_pre_run(const uint8_t reset_value,
         msg += format(" %s %f", params[i].symbol, params[i].value);
     }
 
-    return impl->writeMessageAndWait(msg);
+    const bool ok = impl->writeMessageAndWait(msg);
+
+    for (unsigned int i = 0; i < instance_count; ++i)
+    {
+        if (ok)
+            impl->setParametersFlushed(instances[i], reset_value, param_count, params);
+        else
+            impl->forgetInstanceValues(instances[i]);
+    }
+
+    return ok;
 }
 
 bool Host::wait_audio_cycle()
@@ -1489,6 +2025,11 @@ bool Host::wait_audio_cycle()
     return impl->writeMessageAndWait("wait_audio_cycle");
 }
 
+Host::SkippedMessages Host::skipped_messages() const
+{
+    return impl->skipped;
+}
+
 bool Host::poll_feedback(FeedbackCallback* const callback) const
 {
     return impl->poll(callback);
@@ -1499,4 +2040,9 @@ bool Host::reconnect()
     return impl->reconnect();
 }
 
+bool Host::connection_lost() const
+{
+    return impl->connectionLost;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
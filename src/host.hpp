@@ -153,6 +153,19 @@ struct Host {
      */
     std::string last_error;
 
+    /**
+     * number of messages not sent to mod-host because it already had the requested state.
+     * only values set through this class (or reported back by mod-host) are known,
+     * and parameters mapped to MIDI, CV or HMI are always sent.
+     */
+    struct SkippedMessages {
+        uint32_t activate;
+        uint32_t bypass;
+        uint32_t param_set;
+        uint32_t patch_set;
+    };
+    SkippedMessages skipped_messages() const;
+
     /* add an LV2 plugin encapsulated as a jack client
      * @a instance_number must be any value between 0 ~ 9990, inclusively
      */
@@ -174,6 +187,11 @@ struct Host {
      */
     bool preload(const char* uri, int16_t instance_number);
 
+    /* preload an LV2 plugin unless @a instance_number is already in use, for finding out which instances mod-host has
+     * returns 1 if the instance already existed, 0 if it was preloaded now, or -1 on any other error
+     */
+    int preload_probe(const char* uri, int16_t instance_number);
+
     /**
      * load a preset state of an effect instance
      */
@@ -524,10 +542,16 @@ struct Host {
     ~Host();
 
    /**
-     * try to reconnect host if it previously failed
+     * try to reconnect host if it previously failed, or if the connection was lost since
      */
     bool reconnect();
 
+   /**
+     * whether the connection to mod-host was lost while sending messages (e.g. mod-host crashed).
+     * use reconnect() to start a new one.
+     */
+    bool connection_lost() const;
+
    /**
      * class to activate non-blocking mode during a function scope.
      * this allows to send a bunch of related messages in quick succession,
@@ -554,6 +578,17 @@ struct Host {
         ~NonBlockingScopeWithAudioFades();
     };
 
+   /**
+     * class to collect messages during a function scope and send them in a single write (in the class destructor).
+     * only has an effect inside a non-blocking scope, and cannot be nested.
+     */
+    class BatchScope {
+        Host& host;
+    public:
+        BatchScope(Host& host);
+        ~BatchScope();
+    };
+
 private:
     struct Impl;
     Impl* const impl;
@@ -10,8 +10,11 @@
 
 // --------------------------------------------------------------------------------------------------------------------
 
-HostInstanceMapper::HostInstanceMapper() noexcept
+HostInstanceMapper::HostInstanceMapper(const uint8_t range) noexcept
+    : first(range * kMaxHostInstancesPerBank)
 {
+    assert(range < kNumHostInstanceRanges);
+
     reset();
 }
 
@@ -27,7 +30,7 @@ uint16_t HostInstanceMapper::add(const uint8_t preset, const uint8_t row, const
     assert(map.presets[preset].blocks[rblock].id == kMaxHostInstances);
     assert(map.presets[preset].blocks[rblock].pair == kMaxHostInstances);
 
-    for (uint16_t id = 0; id < kMaxHostInstances; ++id)
+    for (uint16_t id = first; id < first + kMaxHostInstancesPerBank; ++id)
     {
         if (used[id])
             continue;
@@ -54,7 +57,7 @@ uint16_t HostInstanceMapper::add_pair(const uint8_t preset, const uint8_t row, c
     assert(map.presets[preset].blocks[rblock].id != kMaxHostInstances);
     assert(map.presets[preset].blocks[rblock].pair == kMaxHostInstances);
 
-    for (uint16_t id2 = 0; id2 < kMaxHostInstances; ++id2)
+    for (uint16_t id2 = first; id2 < first + kMaxHostInstancesPerBank; ++id2)
     {
         if (used[id2])
             continue;
@@ -119,6 +122,75 @@ uint16_t HostInstanceMapper::remove_pair(const uint8_t preset, const uint8_t row
 
 // --------------------------------------------------------------------------------------------------------------------
 
+HostInstanceMapper::BlockPair HostInstanceMapper::detach(const uint8_t preset,
+                                                         const uint8_t row,
+                                                         const uint8_t block) noexcept
+{
+    assert(preset < NUM_PRESETS_PER_BANK);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+
+    const uint16_t rblock = row * NUM_BLOCKS_PER_PRESET + block;
+    const BlockPair bp = map.presets[preset].blocks[rblock];
+
+    map.presets[preset].blocks[rblock].id = kMaxHostInstances;
+    map.presets[preset].blocks[rblock].pair = kMaxHostInstances;
+
+    return bp;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostInstanceMapper::attach(const uint8_t preset,
+                                const uint8_t row,
+                                const uint8_t block,
+                                const uint16_t id) noexcept
+{
+    assert(preset < NUM_PRESETS_PER_BANK);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(id < kMaxHostInstances);
+    assert(used[id]);
+
+    const uint16_t rblock = row * NUM_BLOCKS_PER_PRESET + block;
+    assert(map.presets[preset].blocks[rblock].id == kMaxHostInstances);
+    assert(map.presets[preset].blocks[rblock].pair == kMaxHostInstances);
+
+    map.presets[preset].blocks[rblock].id = id;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostInstanceMapper::attach_pair(const uint8_t preset,
+                                     const uint8_t row,
+                                     const uint8_t block,
+                                     const uint16_t id2) noexcept
+{
+    assert(preset < NUM_PRESETS_PER_BANK);
+    assert(row < NUM_BLOCK_CHAIN_ROWS);
+    assert(block < NUM_BLOCKS_PER_PRESET);
+    assert(id2 < kMaxHostInstances);
+    assert(used[id2]);
+
+    const uint16_t rblock = row * NUM_BLOCKS_PER_PRESET + block;
+    assert(map.presets[preset].blocks[rblock].id != kMaxHostInstances);
+    assert(map.presets[preset].blocks[rblock].pair == kMaxHostInstances);
+
+    map.presets[preset].blocks[rblock].pair = id2;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+void HostInstanceMapper::release(const uint16_t id) noexcept
+{
+    assert(id < kMaxHostInstances);
+    assert(used[id]);
+
+    used[id] = false;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 HostInstanceMapper::BlockPair HostInstanceMapper::get(const uint8_t preset,
                                                       const uint8_t row,
                                                       const uint8_t block) const noexcept
@@ -9,11 +9,15 @@
 
 // --------------------------------------------------------------------------------------------------------------------
 
-static constexpr const uint16_t kMaxHostInstances = NUM_PRESETS_PER_BANK
-                                                  * NUM_BLOCKS_PER_PRESET * 2 /* dual-mono pair */
-                                                  * NUM_BLOCK_CHAIN_ROWS
-                                                  * NUM_PRESETS_PER_BANK
-                                                  + 2 /* reserved space for block replacement */;
+static constexpr const uint16_t kMaxHostInstancesPerBank = NUM_PRESETS_PER_BANK
+                                                         * NUM_BLOCKS_PER_PRESET * 2 /* dual-mono pair */
+                                                         * NUM_BLOCK_CHAIN_ROWS
+                                                         * NUM_PRESETS_PER_BANK
+                                                         + 2 /* reserved space for block replacement */;
+
+// one instance range for the active bank, plus another for preparing the next one if enabled
+static constexpr const uint8_t kNumHostInstanceRanges = PREPARED_BANK_INSTANCES ? 2 : 1;
+static constexpr const uint16_t kMaxHostInstances = kMaxHostInstancesPerBank * kNumHostInstanceRanges;
 static_assert(kMaxHostInstances < MAX_MOD_HOST_PLUGIN_INSTANCES,
               "maximum amount of instances is bigger than what mod-host can do");
 
@@ -30,11 +34,19 @@ struct HostInstanceMapper {
         uint16_t pair;
     };
 
-    HostInstanceMapper() noexcept;
+    // range selects which part of the instance ids this mapper gives out, less than kNumHostInstanceRanges
+    explicit HostInstanceMapper(uint8_t range = 0) noexcept;
     uint16_t add(uint8_t preset, uint8_t row, uint8_t block) noexcept;
     uint16_t add_pair(uint8_t preset, uint8_t row, uint8_t block) noexcept;
     BlockPair remove(uint8_t preset, uint8_t row, uint8_t block) noexcept;
     uint16_t remove_pair(uint8_t preset, uint8_t row, uint8_t block) noexcept;
+    // unmap block without freeing its ids, so they can be given to another block later
+    BlockPair detach(uint8_t preset, uint8_t row, uint8_t block) noexcept;
+    // map block to an id previously kept with detach
+    void attach(uint8_t preset, uint8_t row, uint8_t block, uint16_t id) noexcept;
+    void attach_pair(uint8_t preset, uint8_t row, uint8_t block, uint16_t id2) noexcept;
+    // free an id previously kept with detach
+    void release(uint16_t id) noexcept;
     [[nodiscard]] BlockPair get(uint8_t preset, uint8_t row, uint8_t block) const noexcept;
     [[nodiscard]] BlockAndRow get_block_with_id(uint8_t preset, uint16_t id) const noexcept;
     void reset() noexcept;
@@ -51,6 +63,7 @@ private:
     } map;
 
     std::array<bool, kMaxHostInstances> used;
+    uint16_t first;
 };
 
 using HostBlockAndRow = HostInstanceMapper::BlockAndRow;
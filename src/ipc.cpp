@@ -25,6 +25,11 @@
 typedef int SOCKET;
 #endif
 
+// a restarted mod-host must show up as a send error instead of killing us through SIGPIPE
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 #ifdef HAVE_SERIALPORT
 #include <libserialport.h>
 #define SERIALPORT_BLOCKING_READ_TIMEOUT_MS 40
@@ -232,6 +237,11 @@ struct IPC::Impl
         return last_error.empty() ? buffer : nullptr;
     }
 
+    uint16_t getNumFailedResponses() const noexcept
+    {
+        return numFailedResponses;
+    }
+
     void setWriteBlockingAndWait(const bool blocking)
     {
         if (blocking)
@@ -404,7 +414,11 @@ struct IPC::Impl
             const int respcode = std::atoi(respbuffer);
 
             if (respcode < 0)
+            {
+                if (resp != nullptr)
+                    resp->code = respcode;
                 return false;
+            }
 
             // stop here if not wanting response data
             if (resp == nullptr)
@@ -434,6 +448,26 @@ struct IPC::Impl
         return true;
     }
 
+    bool writeMessages(const std::string& messages, const uint16_t count)
+    {
+        assert(nonBlockingWriteMode);
+
+        if (dummyDevMode)
+            return true;
+
+        if (! iface->writeMessage(messages))
+        {
+            mod_log_warn("iface->writeMessage() error: %s", last_error.c_str());
+            return false;
+        }
+
+        numNonBlockingOps += count;
+
+        mod_log_debug3("%s: non-block send of %u messages, numNonBlockingOps: %u", __func__, count, numNonBlockingOps);
+
+        return true;
+    }
+
     bool writeMessageWithoutReply(const std::string& message)
     {
         if (dummyDevMode)
@@ -449,6 +483,11 @@ private:
         int r;
         last_error.clear();
 
+        // keep the start of each reply, enough to know if it is an error
+        char reply[8];
+        uint8_t replyLen = 0;
+        numFailedResponses = 0;
+
        #ifndef NDEBUG
         std::string cmd;
         uint64_t* times;
@@ -482,6 +521,12 @@ private:
 
                 if (c == '\0')
                 {
+                    reply[replyLen] = '\0';
+                    replyLen = 0;
+
+                    if (std::strncmp(reply, "resp -", 6) == 0 || std::strncmp(reply, "r -", 3) == 0)
+                        ++numFailedResponses;
+
                     --numNonBlockingOps;
                     mod_log_debug3("%s: next, numNonBlockingOps: %u", __func__, numNonBlockingOps);
 
@@ -498,6 +543,10 @@ private:
                     }
                    #endif
                 }
+                else if (replyLen < sizeof(reply) - 1)
+                {
+                    reply[replyLen++] = c;
+                }
 
                 continue;
             }
@@ -526,6 +575,7 @@ private:
     bool dummyDevMode = false;
     bool nonBlockingWriteMode = false;
     uint16_t numNonBlockingOps = 0;
+    uint16_t numFailedResponses = 0;
 
     char* buffer = nullptr;
     uint32_t bufferSize = 0;
@@ -753,7 +803,7 @@ bool IPC::Impl::SingleSocketTCP::writeMessage(const std::string& message)
 
     while (msgsize > 0)
     {
-        ret = ::send(sockets.outfd, buffer, msgsize, 0);
+        ret = ::send(sockets.outfd, buffer, msgsize, MSG_NOSIGNAL);
         if (ret < 0)
         {
             last_error = "send error";
@@ -911,7 +961,7 @@ bool IPC::Impl::DualSocketTCP::writeMessage(const std::string& message)
 
     while (msgsize > 0)
     {
-        ret = ::send(sockets.out, buffer, msgsize, 0);
+        ret = ::send(sockets.out, buffer, msgsize, MSG_NOSIGNAL);
         if (ret < 0)
         {
             last_error = "send error";
@@ -1047,11 +1097,21 @@ void IPC::setWriteBlockingAndWait(const bool blocking)
     impl->setWriteBlockingAndWait(blocking);
 }
 
+uint16_t IPC::getNumFailedResponses() const noexcept
+{
+    return impl->getNumFailedResponses();
+}
+
 bool IPC::writeMessage(const std::string& message, const ResponseType respType, Response* const resp)
 {
     return impl->writeMessage(message, respType, resp);
 }
 
+bool IPC::writeMessages(const std::string& messages, const uint16_t count)
+{
+    return impl->writeMessages(messages, count);
+}
+
 bool IPC::writeMessageWithoutReply(const std::string& message)
 {
     return impl->writeMessageWithoutReply(message);
@@ -70,11 +70,22 @@ struct IPC
      */
     void setWriteBlockingAndWait(bool blocking);
 
+    /**
+     * number of error replies received during the last wait for non-blocking responses.
+     */
+    uint16_t getNumFailedResponses() const noexcept;
+
     /**
      * write a message and potentially fetch remote response.
      */
     bool writeMessage(const std::string& message, ResponseType respType = kResponseNone, Response* resp = nullptr);
 
+    /**
+     * write several null-separated messages at once, only valid in non-blocking mode.
+     * @a count must match the amount of messages, as each one gets a reply.
+     */
+    bool writeMessages(const std::string& messages, uint16_t count);
+
     /**
      * write a message without a reply, typically used for replies themselves.
      */
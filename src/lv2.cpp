@@ -4,6 +4,7 @@
 #define MOD_LOG_GROUP "lv2"
 
 #include "lv2.hpp"
+#include "json.hpp"
 #include "utils.hpp"
 #include "sha1/sha1.h"
 
@@ -14,14 +15,30 @@
 #include "mod-lv2-extensions/mod-license.lv2/mod-license.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <filesystem>
-#include <list>
+#include <fstream>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_set>
 
 #include <lilv/lilv.h>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #include <io.h>
 #endif
@@ -44,6 +61,9 @@
 #include <lv2/lv2plug.in/ns/ext/units/units.h>
 #endif
 
+// bump when Lv2Plugin or its cache serialization changes
+#define LV2_CACHE_VERSION 2
+
 // Fix compatibility with old LV2 versions which don't provide these properties
 #ifndef LV2_CORE__Parameter
 #define LV2_CORE__Parameter LV2_CORE_PREFIX "Parameter"
@@ -61,6 +81,11 @@
 #define LV2_CORE__shortName LV2_CORE_PREFIX "shortName"
 #endif
 
+// Same for old MOD extension headers
+#ifndef LV2_MOD__brand
+#define LV2_MOD__brand "http://moddevices.com/ns/mod#brand"
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // compatibility functions
 
@@ -101,6 +126,88 @@ static std::string _keysdir()
     return homedir() + "keys" PATH_SEP_STR;
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// get plugin metadata cache directory, setting MOD_LV2_CACHE_PATH to an empty string disables the cache
+// NOTE: returned value always has path separator as the last character (or is empty)
+
+static std::string _cachedir()
+{
+    if (const char* const cachedir = std::getenv("MOD_LV2_CACHE_PATH"))
+    {
+        assert(*cachedir == '\0' || cachedir[std::strlen(cachedir) - 1] == PATH_SEP_CHAR);
+        return cachedir;
+    }
+
+    return homedir() + ".cache" PATH_SEP_STR "mod-connector" PATH_SEP_STR;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// get list of directories to scan for LV2 bundles, same as lilv does
+// returns empty list if the default paths are not known, in which case lilv discovery must be used
+
+static std::vector<std::string> _lv2path()
+{
+    std::string lv2path;
+
+    if (const char* const envpath = std::getenv("LV2_PATH"))
+        lv2path = envpath;
+    else
+   #if defined(_WIN32)
+        return {};
+   #elif defined(__APPLE__)
+        lv2path = "~/.lv2:~/Library/Audio/Plug-Ins/LV2:/usr/local/lib/lv2:/usr/lib/lv2:/Library/Audio/Plug-Ins/LV2";
+   #else
+        lv2path = "~/.lv2:/usr/local/lib/lv2:/usr/lib/lv2";
+   #endif
+
+   #ifdef _WIN32
+    constexpr const char separator = ';';
+   #else
+    constexpr const char separator = ':';
+   #endif
+
+    std::vector<std::string> dirs;
+
+    for (size_t start = 0, end; start <= lv2path.length(); start = end + 1)
+    {
+        end = lv2path.find(separator, start);
+        if (end == std::string::npos)
+            end = lv2path.length();
+
+        std::string dir = lv2path.substr(start, end - start);
+        if (dir.empty())
+            continue;
+
+        if (dir[0] == '~' && (dir.length() == 1 || dir[1] == PATH_SEP_CHAR))
+            dir = homedir() + dir.substr(std::min<size_t>(2, dir.length()));
+
+        dirs.push_back(std::move(dir));
+    }
+
+    return dirs;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// get the most recent modification time of the turtle files within a bundle
+
+static int64_t _bundleModTime(const std::string& bundlepath)
+{
+    int64_t mtime = 0;
+    std::error_code ec;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(bundlepath, ec))
+    {
+        if (entry.path().extension() != ".ttl")
+            continue;
+
+        const std::filesystem::file_time_type ftime = entry.last_write_time(ec);
+        if (! ec)
+            mtime = std::max<int64_t>(mtime, ftime.time_since_epoch().count());
+    }
+
+    return mtime;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // proper lilv_file_uri_parse function that returns absolute paths
 
@@ -164,6 +271,205 @@ static std::string _sha1(const char* const cstring)
     return hashdec;
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// set while running the background prewarm thread, errors from it are not reported to callers
+
+static thread_local bool _isPrewarmThread = false;
+
+// --------------------------------------------------------------------------------------------------------------------
+// check if a commercial plugin has a valid license file
+
+static bool _isPluginLicensed(const std::string& uri, const uint32_t flags)
+{
+    static const std::string keysdir = _keysdir();
+
+    std::string licensefile;
+   #ifdef _DARKGLASS_DEVICE_PABLITO
+    // system plugins in Anagram all share the same license URI
+    // if bundle is not user removable, assume to be a system plugin
+    if ((flags & Lv2PluginIsUserRemovable) == 0)
+    {
+        licensefile = keysdir + "149e897c16e874bea75961557c8fef52567ad3db";
+    }
+    else
+   #endif
+    {
+        licensefile = keysdir + _sha1(uri.c_str());
+    }
+
+    return std::filesystem::exists(licensefile);
+
+    // unused in some builds
+    (void)flags;
+}
+
+#ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+// --------------------------------------------------------------------------------------------------------------------
+// helpers for plugin catalogue searches
+
+static std::string _lowercase(std::string str)
+{
+    for (char& c : str)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    return str;
+}
+
+// check if a plugin category matches a filter, parent categories (e.g. "Filter") match their subcategories
+static bool _categoryMatches(const Lv2Category category, const Lv2Category filter)
+{
+    if (filter == kLv2CategoryNone || category == filter)
+        return true;
+
+    // subcategories are listed right after their parent and have a ", " in their name
+    if (category < filter || std::strchr(lv2_category_name(filter), ',') != nullptr)
+        return false;
+
+    for (int c = filter + 1; c <= category; ++c)
+    {
+        if (std::strchr(lv2_category_name(static_cast<Lv2Category>(c)), ',') == nullptr)
+            return false;
+    }
+
+    return true;
+}
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// plugin metadata cache serialization
+
+static nlohmann::json _pluginToJson(const Lv2Plugin& plugin)
+{
+    nlohmann::json jplugin = nlohmann::json::object({
+        { "uri", plugin.uri },
+        { "bundlepath", plugin.bundlepath },
+        { "version", plugin.version },
+        { "flags", plugin.flags },
+    });
+
+   #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+    jplugin["name"] = plugin.name;
+    jplugin["abbreviation"] = plugin.abbreviation;
+    jplugin["brand"] = plugin.brand;
+    jplugin["category"] = plugin.category;
+    jplugin["blockImageOff"] = plugin.blockImageOff;
+    jplugin["blockImageOn"] = plugin.blockImageOn;
+
+    auto& jports = jplugin["ports"] = nlohmann::json::array();
+    for (const Lv2Port& port : plugin.ports)
+    {
+        auto& jport = jports.emplace_back(nlohmann::json::object({
+            { "symbol", port.symbol },
+            { "name", port.name },
+            { "shortname", port.shortname },
+            { "flags", port.flags },
+            { "designation", port.designation },
+            { "def", port.def },
+            { "min", port.min },
+            { "max", port.max },
+            { "unit", port.unit },
+        }));
+
+        auto& jscalepoints = jport["scalePoints"] = nlohmann::json::array();
+        for (const Lv2ScalePoint& scalepoint : port.scalePoints)
+            jscalepoints.push_back({ { "label", scalepoint.label }, { "value", scalepoint.value } });
+    }
+
+    auto& jprops = jplugin["properties"] = nlohmann::json::array();
+    for (const Lv2Property& prop : plugin.properties)
+    {
+        jprops.push_back(nlohmann::json::object({
+            { "uri", prop.uri },
+            { "name", prop.name },
+            { "shortname", prop.shortname },
+            { "flags", prop.flags },
+            { "defpath", prop.defpath },
+            { "def", prop.def },
+            { "min", prop.min },
+            { "max", prop.max },
+        }));
+    }
+   #endif
+
+    return jplugin;
+}
+
+static Lv2Plugin* _pluginFromJson(const nlohmann::json& jplugin)
+{
+    Lv2Plugin* const plugin = new Lv2Plugin;
+
+    try {
+        plugin->uri = jplugin.at("uri").get<std::string>();
+        plugin->bundlepath = jplugin.at("bundlepath").get<std::string>();
+        plugin->version = jplugin.at("version").get<std::string>();
+        plugin->flags = jplugin.at("flags").get<uint32_t>();
+
+       #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+        plugin->name = jplugin.at("name").get<std::string>();
+        plugin->abbreviation = jplugin.at("abbreviation").get<std::string>();
+        plugin->brand = jplugin.at("brand").get<std::string>();
+        plugin->category = static_cast<Lv2Category>(jplugin.at("category").get<int>());
+        plugin->blockImageOff = jplugin.at("blockImageOff").get<std::string>();
+        plugin->blockImageOn = jplugin.at("blockImageOn").get<std::string>();
+
+        const auto& jports = jplugin.at("ports");
+        plugin->ports.resize(jports.size());
+
+        for (size_t i = 0; i < jports.size(); ++i)
+        {
+            const auto& jport = jports[i];
+            Lv2Port& port(plugin->ports[i]);
+
+            port.symbol = jport.at("symbol").get<std::string>();
+            port.name = jport.at("name").get<std::string>();
+            port.shortname = jport.at("shortname").get<std::string>();
+            port.flags = jport.at("flags").get<uint32_t>();
+            port.designation = jport.at("designation").get<uint32_t>();
+            port.def = jport.at("def").get<float>();
+            port.min = jport.at("min").get<float>();
+            port.max = jport.at("max").get<float>();
+            port.unit = jport.at("unit").get<std::string>();
+
+            for (const auto& jscalepoint : jport.at("scalePoints"))
+                port.scalePoints.push_back({ jscalepoint.at("label").get<std::string>(),
+                                             jscalepoint.at("value").get<float>() });
+        }
+
+        const auto& jprops = jplugin.at("properties");
+        plugin->properties.resize(jprops.size());
+
+        for (size_t i = 0; i < jprops.size(); ++i)
+        {
+            const auto& jprop = jprops[i];
+            Lv2Property& prop(plugin->properties[i]);
+
+            prop.uri = jprop.at("uri").get<std::string>();
+            prop.name = jprop.at("name").get<std::string>();
+            prop.shortname = jprop.at("shortname").get<std::string>();
+            prop.flags = jprop.at("flags").get<uint32_t>();
+            prop.defpath = jprop.at("defpath").get<std::string>();
+            prop.def = jprop.at("def").get<float>();
+            prop.min = jprop.at("min").get<float>();
+            prop.max = jprop.at("max").get<float>();
+        }
+       #endif
+    } catch (...) {
+        delete plugin;
+        return nullptr;
+    }
+
+    // license state is not cached, as license files may be added at any time
+    if ((plugin->flags & Lv2PluginIsCommercial) != 0)
+    {
+        if (_isPluginLicensed(plugin->uri, plugin->flags))
+            plugin->flags |= Lv2PluginIsLicensed;
+        else
+            plugin->flags &= ~Lv2PluginIsLicensed;
+    }
+
+    return plugin;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 struct Lv2NamespaceDefinitions {
@@ -224,6 +530,7 @@ struct Lv2NamespaceDefinitions {
     LilvNode* const lv2core_portProperty;
     LilvNode* const lv2core_shortName;
     LilvNode* const lv2core_symbol;
+    LilvNode* const mod_brand;
     LilvNode* const mod_releaseNumber;
     LilvNode* const modlicense_interface;
     LilvNode* const patch_readable;
@@ -292,6 +599,7 @@ struct Lv2NamespaceDefinitions {
           lv2core_portProperty(lilv_new_uri(world, LV2_CORE__portProperty)),
           lv2core_shortName(lilv_new_uri(world, LV2_CORE__shortName)),
           lv2core_symbol(lilv_new_uri(world, LV2_CORE__symbol)),
+          mod_brand(lilv_new_uri(world, LV2_MOD__brand)),
           mod_releaseNumber(lilv_new_uri(world, LV2_MOD__releaseNumber)),
           modlicense_interface(lilv_new_uri(world, MOD_LICENSE__interface)),
           patch_readable(lilv_new_uri(world, LV2_PATCH__readable)),
@@ -363,6 +671,7 @@ struct Lv2NamespaceDefinitions {
         lilv_node_free(lv2core_portProperty);
         lilv_node_free(lv2core_shortName);
         lilv_node_free(lv2core_symbol);
+        lilv_node_free(mod_brand);
         lilv_node_free(mod_releaseNumber);
         lilv_node_free(modlicense_interface);
         lilv_node_free(patch_readable);
@@ -387,38 +696,50 @@ struct Lv2World::Impl
        #ifdef LILV_OPTION_OBJECT_INDEX
         lilv_world_set_option(world, LILV_OPTION_OBJECT_INDEX, nullptr);
        #endif
-        lilv_world_load_all(world);
 
-        plugins = lilv_world_get_all_plugins(world);
-        pluginURIs.reserve(lilv_plugins_size(plugins));
+        // pre-map atom types used in state values, must match k_urid_* order
+        _mapfn(this, LV2_ATOM__Bool);
+        _mapfn(this, LV2_ATOM__Int);
+        _mapfn(this, LV2_ATOM__Long);
+        _mapfn(this, LV2_ATOM__Float);
+        _mapfn(this, LV2_ATOM__Double);
 
-        LILV_FOREACH(plugins, it, plugins)
-        {
-            const LilvPlugin* const p = lilv_plugins_get(plugins, it);
+        const std::string cachedir = _cachedir();
+        const std::vector<std::string> lv2path = cachedir.empty() ? std::vector<std::string>() : _lv2path();
 
-            const std::string uri(lilv_node_as_uri(lilv_plugin_get_uri(p)));
-            pluginURIs.emplace_back(uri);
-            pluginsCache[uri] = {};
+        if (lv2path.empty())
+        {
+            _loadAll();
+            return;
+        }
 
-            if (char* const lilvparsed = _lilv_file_abspath(lilv_plugin_get_bundle_uri(p)))
-            {
-                if (const char* const bundlepath = _realpath_with_terminator(lilvparsed))
-                {
-                    const std::string bundlestr = bundlepath;
+        cachefile = cachedir + "lv2-plugins.json";
+        _loadAllWithCache(lv2path);
+    }
 
-                    if (std::find(bundles.begin(), bundles.end(), bundlestr) == bundles.end())
-                        bundles.push_back(bundlestr);
-                }
+    ~Impl()
+    {
+        stopBundleWatcher();
 
-                std::free(lilvparsed);
+        if (prewarmThread.joinable())
+        {
+            {
+                const std::lock_guard<std::mutex> lock(prewarmMutex);
+                prewarmStop = true;
             }
+
+            prewarmCond.notify_one();
+            prewarmThread.join();
         }
-    }
 
-    ~Impl()
-    {
+        if (cacheDirty)
+            saveCache();
+
         pluginsCache.clear();
 
+        if (probeWorld != nullptr)
+            lilv_world_free(probeWorld);
+
         ns.free();
         lilv_world_free(world);
     }
@@ -446,14 +767,33 @@ struct Lv2World::Impl
     {
         assert(uri != nullptr && *uri != '\0');
 
-        PluginCache& cache = pluginsCache[uri];
+        const std::unordered_map<std::string, PluginCache>::iterator cacheIt = pluginsCache.find(uri);
+
+        if (cacheIt == pluginsCache.end())
+        {
+            const std::lock_guard<std::mutex> lock(lilvMutex);
+            _setLastError("Invalid Plugin");
+            return nullptr;
+        }
+
+        PluginCache& cache = cacheIt->second;
 
-        if (cache.plugin != nullptr)
-            return cache.plugin;
+        if (std::shared_ptr<const Lv2Plugin> cachedplugin = std::atomic_load(&cache.plugin))
+            return cachedplugin;
+
+        // lilv is not thread-safe, extract one plugin at a time
+        const std::lock_guard<std::mutex> lock(lilvMutex);
+
+        // check again, plugin might have been extracted by another thread while we waited
+        if (std::shared_ptr<const Lv2Plugin> cachedplugin = std::atomic_load(&cache.plugin))
+            return cachedplugin;
 
         std::string bundlepath;
         const LilvPlugin* plugin;
 
+        if (! cache.bundlepath.empty())
+            _loadBundleIfNeeded(cache.bundlepath);
+
         if (LilvNode* const urinode = lilv_new_uri(world, uri))
         {
             plugin = lilv_plugins_get_by_uri(plugins, urinode);
@@ -461,7 +801,7 @@ struct Lv2World::Impl
 
             if (plugin == nullptr)
             {
-                last_error = "Invalid Plugin";
+                _setLastError("Invalid Plugin");
                 return nullptr;
             }
 
@@ -473,13 +813,13 @@ struct Lv2World::Impl
 
             if (bundlepath.empty())
             {
-                last_error = "Invalid Bundle path";
+                _setLastError("Invalid Bundle path");
                 return nullptr;
             }
         }
         else
         {
-            last_error = "Invalid URI";
+            _setLastError("Invalid URI");
             return nullptr;
         }
 
@@ -539,23 +879,7 @@ struct Lv2World::Impl
         {
             retplugin->flags |= Lv2PluginIsCommercial;
 
-            static const std::string keysdir = _keysdir();
-
-            std::string licensefile;
-           #ifdef _DARKGLASS_DEVICE_PABLITO
-            // system plugins in Anagram all share the same license URI
-            // if bundle is not user removable, assume to be a system plugin
-            if ((retplugin->flags & Lv2PluginIsUserRemovable) == 0)
-            {
-                licensefile = keysdir + "149e897c16e874bea75961557c8fef52567ad3db";
-            }
-            else
-           #endif
-            {
-                licensefile = keysdir + _sha1(uri);
-            }
-
-            if (std::filesystem::exists(licensefile))
+            if (_isPluginLicensed(retplugin->uri, retplugin->flags))
                 retplugin->flags |= Lv2PluginIsLicensed;
         }
 
@@ -584,6 +908,20 @@ struct Lv2World::Impl
             lilv_nodes_free(nodes);
         }
 
+        // ------------------------------------------------------------------------------------------------------------
+        // brand, falling back to author name
+
+        if (LilvNodes* const nodes = lilv_plugin_get_value(plugin, ns.mod_brand))
+        {
+            retplugin->brand = lilv_node_as_string(lilv_nodes_get_first(nodes));
+            lilv_nodes_free(nodes);
+        }
+        else if (LilvNode* const node = lilv_plugin_get_author_name(plugin))
+        {
+            retplugin->brand = lilv_node_as_string(node);
+            lilv_node_free(node);
+        }
+
         // ------------------------------------------------------------------------------------------------------------
         // category
 
@@ -760,7 +1098,7 @@ struct Lv2World::Impl
 
             if (! supported)
             {
-                last_error = "Plugin uses non-supported port types";
+                _setLastError("Plugin uses non-supported port types");
                 return nullptr;
             }
 
@@ -1150,8 +1488,9 @@ struct Lv2World::Impl
         // ------------------------------------------------------------------------------------------------------------
        #endif // MOD_CONNECTOR_MINIMAL_LV2_WORLD
 
-        cache.plugin = std::shared_ptr<const Lv2Plugin>(retplugin);
-        return cache.plugin;
+        const std::shared_ptr<const Lv2Plugin> sharedplugin(retplugin);
+        std::atomic_store(&cache.plugin, sharedplugin);
+        return sharedplugin;
     }
 
 #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
@@ -1160,17 +1499,21 @@ struct Lv2World::Impl
         assert(uri != nullptr);
         assert(*uri != '\0');
 
-        PluginCache& cache = pluginsCache[uri];
-
-        if (cache.plugin == nullptr)
-            getPluginByURI(uri);
-
-        std::shared_ptr<const Lv2Plugin> retplugin = cache.plugin;
+        const std::shared_ptr<const Lv2Plugin> retplugin = getPluginByURI(uri);
         assert_return(retplugin != nullptr, nullptr);
         assert_return(retplugin->flags & Lv2PluginHasBlockImageStyling, nullptr);
 
-        if (cache.blockImageStyling != nullptr)
-            return cache.blockImageStyling;
+        PluginCache& cache = pluginsCache.find(uri)->second;
+
+        if (std::shared_ptr<const CustomStyling::BlockImage> cached = std::atomic_load(&cache.blockImageStyling))
+            return cached;
+
+        const std::lock_guard<std::mutex> lock(lilvMutex);
+
+        if (std::shared_ptr<const CustomStyling::BlockImage> cached = std::atomic_load(&cache.blockImageStyling))
+            return cached;
+
+        _loadBundleIfNeeded(retplugin->bundlepath);
 
         LilvNode* stylingNode = nullptr;
         {
@@ -1178,7 +1521,7 @@ struct Lv2World::Impl
 
             if (urinode == nullptr)
             {
-                last_error = "Invalid URI";
+                _setLastError("Invalid URI");
                 return nullptr;
             }
 
@@ -1188,14 +1531,14 @@ struct Lv2World::Impl
 
             if (plugin == nullptr)
             {
-                last_error = "Invalid Plugin";
+                _setLastError("Invalid Plugin");
                 return nullptr;
             }
 
             LilvNodes* const stylingNodes = lilv_plugin_get_value(plugin, ns.dgcs_blockImage);
             if (stylingNodes == nullptr)
             {
-                last_error = "Plugin does not contain block styling";
+                _setLastError("Plugin does not contain block styling");
                 return nullptr;
             }
 
@@ -1305,8 +1648,9 @@ struct Lv2World::Impl
 
         lilv_node_free(stylingNode);
 
-        cache.blockImageStyling = std::shared_ptr<const CustomStyling::BlockImage>(styling);
-        return cache.blockImageStyling;
+        const std::shared_ptr<const CustomStyling::BlockImage> sharedstyling(styling);
+        std::atomic_store(&cache.blockImageStyling, sharedstyling);
+        return sharedstyling;
     }
 
     std::shared_ptr<const CustomStyling::BlockSettings> getPluginBlockSettingsStyling(const char* const uri)
@@ -1314,14 +1658,24 @@ struct Lv2World::Impl
         assert(uri != nullptr);
         assert(*uri != '\0');
 
-        PluginCache& cache = pluginsCache[uri];
+        const std::unordered_map<std::string, PluginCache>::iterator cacheIt = pluginsCache.find(uri);
+        assert_return(cacheIt != pluginsCache.end(), nullptr);
 
-        std::shared_ptr<const Lv2Plugin> retplugin = cache.plugin;
+        PluginCache& cache = cacheIt->second;
+
+        const std::shared_ptr<const Lv2Plugin> retplugin = std::atomic_load(&cache.plugin);
         assert_return(retplugin != nullptr, nullptr);
         assert_return(retplugin->flags & Lv2PluginHasBlockSettingsStyling, nullptr);
 
-        if (cache.blockSettingsStyling != nullptr)
-            return cache.blockSettingsStyling;
+        if (std::shared_ptr<const CustomStyling::BlockSettings> cached = std::atomic_load(&cache.blockSettingsStyling))
+            return cached;
+
+        const std::lock_guard<std::mutex> lock(lilvMutex);
+
+        if (std::shared_ptr<const CustomStyling::BlockSettings> cached = std::atomic_load(&cache.blockSettingsStyling))
+            return cached;
+
+        _loadBundleIfNeeded(retplugin->bundlepath);
 
         LilvNode* stylingNode = nullptr;
         {
@@ -1329,7 +1683,7 @@ struct Lv2World::Impl
 
             if (urinode == nullptr)
             {
-                last_error = "Invalid URI";
+                _setLastError("Invalid URI");
                 return nullptr;
             }
 
@@ -1339,14 +1693,14 @@ struct Lv2World::Impl
 
             if (plugin == nullptr)
             {
-                last_error = "Invalid Plugin";
+                _setLastError("Invalid Plugin");
                 return nullptr;
             }
 
             LilvNodes* const stylingNodes = lilv_plugin_get_value(plugin, ns.dgcs_blockSettings);
             if (stylingNodes == nullptr)
             {
-                last_error = "Plugin does not contain block settings styling";
+                _setLastError("Plugin does not contain block settings styling");
                 return nullptr;
             }
 
@@ -1540,8 +1894,9 @@ struct Lv2World::Impl
 
         lilv_node_free(stylingNode);
 
-        cache.blockSettingsStyling = std::shared_ptr<const CustomStyling::BlockSettings>(styling);
-        return cache.blockSettingsStyling;
+        const std::shared_ptr<const CustomStyling::BlockSettings> sharedstyling(styling);
+        std::atomic_store(&cache.blockSettingsStyling, sharedstyling);
+        return sharedstyling;
     }
 
     // helpers used for block and block settings
@@ -1718,7 +2073,8 @@ struct Lv2World::Impl
     {
         assert(path != nullptr && *path != '\0');
 
-        LV2_URID_Map uridMap = { this, _mapfn };
+        const std::lock_guard<std::mutex> lock(lilvMutex);
+
         LilvState* const state = lilv_state_new_from_file(world, &uridMap, nullptr, path);
         assert_return(state != nullptr, {});
 
@@ -1736,7 +2092,7 @@ struct Lv2World::Impl
         assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
 
         // stop now if bundle is already loaded
-        if (std::find(bundles.begin(), bundles.end(), path) != bundles.end())
+        if (bundles.find(path) != bundles.end())
             return false;
 
         // query plugins in bundle
@@ -1744,30 +2100,57 @@ struct Lv2World::Impl
         std::vector<std::string>& pluginsInBundle = pluginsInBundlePtr != nullptr
                                                   ? *pluginsInBundlePtr
                                                   : pluginsInBundleLocal;
-        _pluginsInBundle(pluginsInBundle, path);
+        _probeBundle(pluginsInBundle, path);
         assert_return(! pluginsInBundle.empty(), false);
 
         // load the bundle
+        if (! cachefile.empty())
+        {
+            _loadSpecificationsIfNeeded();
+            unloadedBundles.erase(path);
+        }
+
         if (LilvNode* const b = lilv_new_file_uri(world, nullptr, path))
         {
             lilv_world_load_bundle(world, b);
             lilv_node_free(b);
         }
 
-        // add to loaded list
-        bundles.emplace_back(path);
-
         // refresh cache
         plugins = lilv_world_get_all_plugins(world);
-        pluginURIs.reserve(lilv_plugins_size(plugins));
+        pluginURIs.reserve(pluginURIs.size() + pluginsInBundle.size());
 
         for (const std::string& uri : pluginsInBundle)
         {
-            assert(pluginsCache.find(uri) == pluginsCache.end());
+            assert_continue(pluginsCache.find(uri) == pluginsCache.end());
+
+            _addPluginURI(uri, path);
+        }
+
+        // keep on-disk cache in sync
+        if (! cachefile.empty())
+        {
+            bundleMTimes[path] = _bundleModTime(path);
+
+            for (const std::string& uri : pluginsInBundle)
+                getPluginByURI(uri.c_str());
+
+            cacheDirty = true;
+        }
+
+       #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+        // keep catalogue in sync, if already in use
+        if (catalogueBuilt)
+        {
+            const std::lock_guard<std::mutex> lock(catalogueMutex);
 
-            pluginURIs.emplace_back(uri);
-            pluginsCache[uri] = {};
+            for (const std::string& uri : pluginsInBundle)
+            {
+                if (std::shared_ptr<const Lv2Plugin> plugin = getPluginByURI(uri.c_str()))
+                    _catalogueAdd(plugin);
+            }
         }
+       #endif
 
         return true;
     }
@@ -1778,121 +2161,1067 @@ struct Lv2World::Impl
         assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
 
         // stop now if bundle is not loaded
-        if (std::find(bundles.begin(), bundles.end(), path) == bundles.end())
+        const std::unordered_map<std::string, std::vector<std::string>>::iterator bundleIt = bundles.find(path);
+        if (bundleIt == bundles.end())
             return false;
 
-        // query plugins in bundle
+        // plugins in bundle are known from when it was added, no need to query the bundle files again
         std::vector<std::string> pluginsInBundleLocal;
         std::vector<std::string>& pluginsInBundle = pluginsInBundlePtr != nullptr
                                                   ? *pluginsInBundlePtr
                                                   : pluginsInBundleLocal;
-        _pluginsInBundle(pluginsInBundle, path);
-        assert_return(! pluginsInBundle.empty(), false);
+        pluginsInBundle = std::move(bundleIt->second);
+        bundles.erase(bundleIt);
 
-        // unload the bundle
-        if (LilvNode* const b = lilv_new_file_uri(world, nullptr, path))
+        // unload the bundle, if it was loaded in lilv in the first place
+        if (unloadedBundles.erase(path) == 0)
         {
-            lilv_world_unload_bundle(world, b);
-            lilv_node_free(b);
-        }
-
-        // remove from loaded list
-        bundles.remove(path);
+            if (LilvNode* const b = lilv_new_file_uri(world, nullptr, path))
+            {
+                lilv_world_unload_bundle(world, b);
+                lilv_node_free(b);
+            }
 
-        // refresh cache
-        plugins = lilv_world_get_all_plugins(world);
+            plugins = lilv_world_get_all_plugins(world);
+        }
 
         for (const std::string& uri : pluginsInBundle)
-        {
-            const std::vector<std::string>::const_iterator it = std::find(pluginURIs.cbegin(), pluginURIs.cend(), uri);
-            assert_continue(it != pluginURIs.cend());
+            _removePluginURI(uri);
 
-            pluginURIs.erase(it);
+        // keep on-disk cache in sync
+        if (! cachefile.empty())
+        {
+            bundleMTimes.erase(path);
+            cacheDirty = true;
+        }
 
-            const std::unordered_map<std::string, PluginCache>::const_iterator it2 = pluginsCache.find(uri);
-            assert_continue(it2 != pluginsCache.cend());
+       #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+        // keep catalogue in sync, if already in use
+        if (catalogueBuilt)
+        {
+            const std::lock_guard<std::mutex> lock(catalogueMutex);
 
-            pluginsCache.erase(it2);
+            for (const std::string& uri : pluginsInBundle)
+                _catalogueRemove(uri);
         }
+       #endif
 
         return true;
     }
 
-    static bool getPluginsInBundle(const char* const path, std::vector<std::string>& pluginsInBundle)
+    // write cache after bundle changes, so it survives crashes or power loss
+    void saveCacheIfDirty()
     {
-        assert(path != nullptr && *path != '\0');
-        assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
-
-        _pluginsInBundle(pluginsInBundle, path);
-
-        return ! pluginsInBundle.empty();
+        if (cacheDirty)
+            saveCache();
     }
 
-private:
-    std::string& last_error;
+#ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+    std::vector<std::shared_ptr<const Lv2Plugin>> findPlugins(const Lv2PluginQuery& query)
+    {
+        const std::lock_guard<std::mutex> lock(catalogueMutex);
+        _buildCatalogueIfNeeded();
 
-    LilvWorld* const world = nullptr;
-    const LilvPlugins* plugins = nullptr;
+        const std::string text = _lowercase(query.text);
+        std::vector<std::shared_ptr<const Lv2Plugin>> results;
 
-    Lv2NamespaceDefinitions ns;
-    std::list<std::string> bundles;
-    std::vector<std::string> pluginURIs;
+        const auto matches = [&query](const Lv2Plugin& plugin) {
+            return _categoryMatches(plugin.category, query.category) &&
+                   (query.brand.empty() || plugin.brand == query.brand);
+        };
 
-    struct PluginCache {
-        std::shared_ptr<const Lv2Plugin> plugin;
-        std::shared_ptr<const CustomStyling::BlockImage> blockImageStyling;
-        std::shared_ptr<const CustomStyling::BlockSettings> blockSettingsStyling;
-    };
-    std::unordered_map<std::string, PluginCache> pluginsCache;
+        // prefix search is done through the sorted maps
+        if (query.prefixOnly && ! text.empty())
+        {
+            std::vector<Catalogue::const_iterator> found;
 
-    static LV2_URID _mapfn(LV2_URID_Map_Handle handle, const char* uri);
-    static void _portfn(const char* symbol, void* userData, const void* value, uint32_t size, uint32_t type);
-    static void _pluginsInBundle(std::vector<std::string>& pluginsInBundle, const char* bundlepath);
-};
+            for (Catalogue::const_iterator it = catalogue.lower_bound(text);
+                 it != catalogue.cend() && it->first.compare(0, text.length(), text) == 0; ++it)
+                found.push_back(it);
 
-// --------------------------------------------------------------------------------------------------------------------
+            for (CatalogueAbbreviations::const_iterator it = catalogueAbbreviations.lower_bound(text);
+                 it != catalogueAbbreviations.cend() && it->first.compare(0, text.length(), text) == 0; ++it)
+                found.push_back(it->second);
 
-Lv2World::Lv2World() : impl(new Impl(last_error)) {}
-Lv2World::~Lv2World() { delete impl; }
+            // keep name order and drop plugins matched by both name and abbreviation
+            std::sort(found.begin(), found.end(), [](const Catalogue::const_iterator a,
+                                                     const Catalogue::const_iterator b) {
+                return a->first < b->first;
+            });
+            found.erase(std::unique(found.begin(), found.end()), found.end());
 
-// --------------------------------------------------------------------------------------------------------------------
+            for (const Catalogue::const_iterator& it : found)
+            {
+                if (matches(*it->second.plugin))
+                    results.push_back(it->second.plugin);
+            }
 
-enum {
-    k_urid_null,
-    k_urid_atom_bool,
-    k_urid_atom_int,
-    k_urid_atom_long,
-    k_urid_atom_float,
-    k_urid_atom_double,
-};
+            return results;
+        }
 
-LV2_URID Lv2World::Impl::_mapfn(LV2_URID_Map_Handle, const char* const uri)
-{
-    assert_return(uri != nullptr && uri[0] != '\0', k_urid_null);
+        for (const Catalogue::value_type& entry : catalogue)
+        {
+            if (! text.empty() &&
+                entry.second.name.find(text) == std::string::npos &&
+                entry.second.abbreviation.find(text) == std::string::npos)
+                continue;
 
-    static std::vector<std::string> mapping = {
-        LV2_ATOM__Bool,
-        LV2_ATOM__Int,
-        LV2_ATOM__Long,
-        LV2_ATOM__Float,
-        LV2_ATOM__Double,
-    };
+            if (matches(*entry.second.plugin))
+                results.push_back(entry.second.plugin);
+        }
 
-    LV2_URID urid = 1;
-    for (const std::string& uri2 : mapping)
-    {
-        if (uri2 == uri)
-            return urid;
-        ++urid;
+        return results;
     }
 
-    mapping.emplace_back(uri);
-    return urid;
-}
+    std::vector<std::string> getPluginBrands()
+    {
+        const std::lock_guard<std::mutex> lock(catalogueMutex);
+        _buildCatalogueIfNeeded();
 
-void Lv2World::Impl::_portfn(const char* const symbol,
-                             void* const userData,
-                             const void* const value,
+        std::vector<std::string> brands;
+        brands.reserve(catalogueBrands.size());
+
+        for (const std::map<std::string, uint32_t>::value_type& brand : catalogueBrands)
+            brands.push_back(brand.first);
+
+        return brands;
+    }
+#endif
+
+    void prewarm(const std::vector<std::string>& uris)
+    {
+        const std::vector<std::string>& queued = uris.empty() ? pluginURIs : uris;
+
+        const std::lock_guard<std::mutex> lock(prewarmMutex);
+
+        // latest request has priority over anything still pending
+        prewarmQueue.insert(prewarmQueue.begin(), queued.begin(), queued.end());
+
+        if (! prewarmThread.joinable())
+            prewarmThread = std::thread(&Impl::_prewarmRun, this);
+        else
+            prewarmCond.notify_one();
+    }
+
+    bool startBundleWatcher(const uint32_t debounceMs)
+    {
+       #ifdef __linux__
+        if (watcherThread.joinable())
+            return true;
+
+        const int inotifyfd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyfd < 0)
+        {
+            mod_log_warn("startBundleWatcher(): inotify_init1 failed: %s", std::strerror(errno));
+            return false;
+        }
+
+        // watch descriptor -> watched directory, with path separator as last character
+        std::unordered_map<int, std::string> roots;
+
+        for (const std::string& dir : _lv2path())
+        {
+            std::error_code ec;
+            const std::filesystem::path canonical = std::filesystem::canonical(dir, ec);
+            if (ec)
+                continue;
+
+            const int wd = inotify_add_watch(inotifyfd, canonical.c_str(),
+                                             IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+            if (wd >= 0)
+                roots[wd] = canonical.string() + PATH_SEP_STR;
+        }
+
+        if (roots.empty())
+        {
+            close(inotifyfd);
+            return false;
+        }
+
+        if (pipe2(watcherStopPipe, O_CLOEXEC) != 0)
+        {
+            close(inotifyfd);
+            return false;
+        }
+
+        // watch descriptor -> loaded bundle directory and its modification time, for in-place modifications
+        std::unordered_map<int, std::pair<std::string, int64_t>> loadedBundles;
+        _watchLoadedBundles(inotifyfd, loadedBundles);
+
+        watcherThread = std::thread(&Impl::_watcherRun, this, inotifyfd,
+                                    std::move(roots), std::move(loadedBundles), debounceMs);
+        return true;
+       #else
+        // only implemented through inotify for now
+        return false;
+
+        // unused
+        (void)debounceMs;
+       #endif
+    }
+
+    void stopBundleWatcher()
+    {
+       #ifdef __linux__
+        if (! watcherThread.joinable())
+            return;
+
+        const char c = 0;
+        [[maybe_unused]] const ssize_t ret = write(watcherStopPipe[1], &c, 1);
+
+        watcherThread.join();
+
+        close(watcherStopPipe[0]);
+        close(watcherStopPipe[1]);
+        watcherStopPipe[0] = watcherStopPipe[1] = -1;
+       #endif
+    }
+
+    std::vector<Lv2BundleChange> takeBundleChanges()
+    {
+        const std::lock_guard<std::mutex> lock(watcherMutex);
+        return std::move(bundleChanges);
+    }
+
+    static bool getPluginsInBundle(const char* const path, std::vector<std::string>& pluginsInBundle)
+    {
+        assert(path != nullptr && *path != '\0');
+        assert(path[std::strlen(path) - 1] == PATH_SEP_CHAR);
+
+        _pluginsInBundle(pluginsInBundle, path);
+
+        return ! pluginsInBundle.empty();
+    }
+
+    // must be held while calling any of the methods above, besides the static ones.
+    // shared for lookups, exclusive for adding or removing bundles.
+    // lilv access under shared lock is further serialized by lilvMutex.
+    std::shared_mutex mutex;
+
+    // URID map features, usable without holding the mutex
+    LV2_URID_Map uridMap = { this, _mapfn };
+    LV2_URID_Unmap uridUnmap = { this, _unmapfn };
+
+private:
+    std::string& last_error;
+
+    LilvWorld* const world = nullptr;
+    const LilvPlugins* plugins = nullptr;
+
+    Lv2NamespaceDefinitions ns;
+    // bundle path -> plugin URIs in bundle, only contains bundles with plugins
+    std::unordered_map<std::string, std::vector<std::string>> bundles;
+    std::vector<std::string> pluginURIs;
+
+    struct PluginCache {
+        std::string bundlepath;
+        // position within pluginURIs
+        uint32_t index = 0;
+        std::shared_ptr<const Lv2Plugin> plugin;
+        std::shared_ptr<const CustomStyling::BlockImage> blockImageStyling;
+        std::shared_ptr<const CustomStyling::BlockSettings> blockSettingsStyling;
+    };
+    std::unordered_map<std::string, PluginCache> pluginsCache;
+
+    // on-disk plugin metadata cache, empty if disabled
+    std::string cachefile;
+    // set on bundle changes, cleared once the cache is written to disk
+    bool cacheDirty = false;
+    // modification time for every known bundle, including those without plugins
+    std::unordered_map<std::string, int64_t> bundleMTimes;
+    // bundles restored from cache and not yet loaded in lilv
+    std::unordered_set<std::string> unloadedBundles;
+    bool specificationsLoaded = false;
+
+    // separate lilv world for querying plugins in new bundles, kept around so it is not recreated every time
+    LilvWorld* probeWorld = nullptr;
+
+    // serializes lilv access and lazy extraction between concurrent readers
+    std::mutex lilvMutex;
+
+   #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+    // plugin catalogue, built on first search
+    struct CatalogueEntry {
+        // lowercase, for searching
+        std::string name;
+        std::string abbreviation;
+        std::shared_ptr<const Lv2Plugin> plugin;
+    };
+    // key is lowercase name followed by uri, for stable sorting of plugins with the same name
+    using Catalogue = std::map<std::string, CatalogueEntry>;
+    using CatalogueAbbreviations = std::multimap<std::string, Catalogue::const_iterator>;
+    Catalogue catalogue;
+    CatalogueAbbreviations catalogueAbbreviations;
+    std::unordered_map<std::string, Catalogue::const_iterator> catalogueURIs;
+    std::map<std::string, uint32_t> catalogueBrands;
+    std::mutex catalogueMutex;
+    bool catalogueBuilt = false;
+
+    // catalogueMutex must be held
+    void _buildCatalogueIfNeeded()
+    {
+        if (catalogueBuilt)
+            return;
+
+        catalogueBuilt = true;
+
+        for (const std::string& uri : pluginURIs)
+        {
+            if (std::shared_ptr<const Lv2Plugin> plugin = getPluginByURI(uri.c_str()))
+                _catalogueAdd(plugin);
+        }
+    }
+
+    // catalogueMutex must be held
+    void _catalogueAdd(const std::shared_ptr<const Lv2Plugin>& plugin)
+    {
+        if (catalogueURIs.find(plugin->uri) != catalogueURIs.end())
+            return;
+
+        CatalogueEntry entry;
+        entry.name = _lowercase(plugin->name);
+        entry.abbreviation = _lowercase(plugin->abbreviation);
+        entry.plugin = plugin;
+
+        std::string key = entry.name;
+        key.push_back('\0');
+        key += plugin->uri;
+
+        const Catalogue::const_iterator it = catalogue.emplace(std::move(key), std::move(entry)).first;
+        catalogueURIs[plugin->uri] = it;
+
+        if (! it->second.abbreviation.empty())
+            catalogueAbbreviations.emplace(it->second.abbreviation, it);
+
+        if (! plugin->brand.empty())
+            ++catalogueBrands[plugin->brand];
+    }
+
+    // catalogueMutex must be held
+    void _catalogueRemove(const std::string& uri)
+    {
+        const std::unordered_map<std::string, Catalogue::const_iterator>::iterator uriIt = catalogueURIs.find(uri);
+        if (uriIt == catalogueURIs.end())
+            return;
+
+        const Catalogue::const_iterator it = uriIt->second;
+        catalogueURIs.erase(uriIt);
+
+        for (CatalogueAbbreviations::iterator abbrIt = catalogueAbbreviations.lower_bound(it->second.abbreviation);
+             abbrIt != catalogueAbbreviations.end() && abbrIt->first == it->second.abbreviation; ++abbrIt)
+        {
+            if (abbrIt->second == it)
+            {
+                catalogueAbbreviations.erase(abbrIt);
+                break;
+            }
+        }
+
+        const std::string& brand = it->second.plugin->brand;
+        if (! brand.empty())
+        {
+            const std::map<std::string, uint32_t>::iterator brandIt = catalogueBrands.find(brand);
+            if (brandIt != catalogueBrands.end() && --brandIt->second == 0)
+                catalogueBrands.erase(brandIt);
+        }
+
+        catalogue.erase(it);
+    }
+   #endif
+
+    // background extraction of plugin metadata
+    std::mutex prewarmMutex;
+    std::thread prewarmThread;
+    std::condition_variable prewarmCond;
+    std::deque<std::string> prewarmQueue;
+    bool prewarmStop = false;
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // background watcher of LV2_PATH directories
+    std::thread watcherThread;
+    int watcherStopPipe[2] = { -1, -1 };
+    // changes applied by the watcher and not yet taken by the caller, protected by watcherMutex
+    std::mutex watcherMutex;
+    std::vector<Lv2BundleChange> bundleChanges;
+
+   #ifdef __linux__
+    void _watcherRun(const int inotifyfd,
+                     const std::unordered_map<int, std::string> roots,
+                     std::unordered_map<int, std::pair<std::string, int64_t>> loadedBundles,
+                     const uint32_t debounceMs)
+    {
+        // watch descriptor -> new bundle directory, for extending debounce while bundle files are being written
+        std::unordered_map<int, std::string> newBundles;
+        // watch descriptors of loaded bundles with file activity
+        std::unordered_set<int> modified;
+        std::unordered_set<std::string> pending;
+        std::chrono::steady_clock::time_point deadline;
+
+        alignas(struct inotify_event) char buffer[4096];
+
+        for (;;)
+        {
+            int timeout = -1;
+
+            if (! pending.empty() || ! modified.empty())
+            {
+                const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                timeout = std::max<int>(0, static_cast<int>(remaining.count()));
+            }
+
+            struct pollfd pfds[2] = {
+                { inotifyfd, POLLIN, 0 },
+                { watcherStopPipe[0], POLLIN, 0 },
+            };
+
+            if (poll(pfds, 2, timeout) < 0 && errno != EINTR)
+                break;
+
+            if (pfds[1].revents != 0)
+                break;
+
+            if (pfds[0].revents != 0)
+            {
+                for (ssize_t len; (len = read(inotifyfd, buffer, sizeof(buffer))) > 0;)
+                {
+                    for (ssize_t i = 0; i < len;)
+                    {
+                        const struct inotify_event* const event
+                            = reinterpret_cast<const struct inotify_event*>(buffer + i);
+                        i += sizeof(struct inotify_event) + event->len;
+
+                        // event queue overflow, look for new and missing bundles
+                        if ((event->mask & IN_Q_OVERFLOW) != 0)
+                        {
+                            const std::shared_lock<std::shared_mutex> lock(mutex);
+
+                            for (const std::pair<const int, std::string>& root : roots)
+                            {
+                                std::error_code ec;
+                                for (const std::filesystem::directory_entry& entry :
+                                     std::filesystem::directory_iterator(root.second, ec))
+                                {
+                                    std::string bundlepath = entry.path().string() + PATH_SEP_STR;
+                                    if (bundles.find(bundlepath) == bundles.end())
+                                        pending.insert(std::move(bundlepath));
+                                }
+                            }
+
+                            for (const std::pair<const std::string, std::vector<std::string>>& bundle : bundles)
+                            {
+                                std::error_code ec;
+                                if (! std::filesystem::exists(bundle.first + "manifest.ttl", ec))
+                                    pending.insert(bundle.first);
+                            }
+
+                            continue;
+                        }
+
+                        if ((event->mask & IN_IGNORED) != 0)
+                        {
+                            newBundles.erase(event->wd);
+                            loadedBundles.erase(event->wd);
+                            continue;
+                        }
+
+                        const std::unordered_map<int, std::string>::const_iterator rootIt = roots.find(event->wd);
+
+                        if (rootIt == roots.cend())
+                        {
+                            // activity within a new bundle
+                            const std::unordered_map<int, std::string>::const_iterator bundleIt
+                                = newBundles.find(event->wd);
+
+                            if (bundleIt != newBundles.cend())
+                                pending.insert(bundleIt->second);
+                            else if (loadedBundles.find(event->wd) != loadedBundles.cend())
+                                modified.insert(event->wd);
+                            continue;
+                        }
+
+                        if (event->len == 0)
+                            continue;
+
+                        const std::string bundlepath = rootIt->second + event->name + PATH_SEP_STR;
+                        pending.insert(bundlepath);
+
+                        if ((event->mask & IN_ISDIR) != 0 && (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                        {
+                            const int wd = inotify_add_watch(inotifyfd, bundlepath.c_str(),
+                                                             IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_ONLYDIR);
+                            if (wd >= 0)
+                                newBundles[wd] = bundlepath;
+                        }
+                    }
+                }
+
+                deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(debounceMs);
+                continue;
+            }
+
+            // debounce time has passed without further activity
+            if ((! pending.empty() || ! modified.empty()) && std::chrono::steady_clock::now() >= deadline)
+            {
+                // files changed within loaded bundles, only reload those with newer contents
+                for (const int wd : modified)
+                {
+                    const std::unordered_map<int, std::pair<std::string, int64_t>>::iterator it
+                        = loadedBundles.find(wd);
+                    if (it == loadedBundles.end())
+                        continue;
+
+                    const int64_t mtime = _bundleModTime(it->second.first);
+                    if (mtime == it->second.second)
+                        continue;
+
+                    it->second.second = mtime;
+                    pending.insert(it->second.first);
+                }
+                modified.clear();
+
+                for (const std::pair<const int, std::string>& bundle : newBundles)
+                    inotify_rm_watch(inotifyfd, bundle.first);
+                newBundles.clear();
+
+                if (! pending.empty())
+                {
+                    _applyBundleChanges(pending);
+                    pending.clear();
+                }
+
+                _watchLoadedBundles(inotifyfd, loadedBundles);
+            }
+        }
+
+        close(inotifyfd);
+    }
+
+    // watch files of loaded bundles not yet being watched, so that in-place modifications are noticed
+    void _watchLoadedBundles(const int inotifyfd, std::unordered_map<int, std::pair<std::string, int64_t>>& loadedBundles)
+    {
+        std::unordered_set<std::string> watched;
+        for (const std::pair<const int, std::pair<std::string, int64_t>>& bundle : loadedBundles)
+            watched.insert(bundle.second.first);
+
+        const std::shared_lock<std::shared_mutex> lock(mutex);
+
+        for (const std::pair<const std::string, std::vector<std::string>>& bundle : bundles)
+        {
+            if (watched.find(bundle.first) != watched.end())
+                continue;
+
+            const int wd = inotify_add_watch(inotifyfd, bundle.first.c_str(),
+                                             IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_ONLYDIR);
+            if (wd >= 0)
+                loadedBundles[wd] = { bundle.first, _bundleModTime(bundle.first) };
+        }
+    }
+   #endif
+
+    void _applyBundleChanges(const std::unordered_set<std::string>& paths)
+    {
+        std::vector<Lv2BundleChange> changes;
+
+        {
+            const std::lock_guard<std::shared_mutex> lock(mutex);
+
+            for (const std::string& path : paths)
+            {
+                std::error_code ec;
+                const bool exists = std::filesystem::exists(path + "manifest.ttl", ec);
+
+                // a bundle that is replaced gets removed and added again
+                if (bundles.find(path) != bundles.end() && bundleRemove(path.c_str()))
+                {
+                    mod_log_info("bundle removed: %s", path.c_str());
+                    changes.push_back({ path, false });
+                }
+
+                if (exists && bundleAdd(path.c_str()))
+                {
+                    mod_log_info("bundle added: %s", path.c_str());
+                    changes.push_back({ path, true });
+                }
+            }
+
+            saveCacheIfDirty();
+        }
+
+        if (changes.empty())
+            return;
+
+        const std::lock_guard<std::mutex> lock(watcherMutex);
+        bundleChanges.insert(bundleChanges.end(), changes.begin(), changes.end());
+    }
+
+    void _prewarmRun()
+    {
+        _isPrewarmThread = true;
+
+        for (;;)
+        {
+            std::string uri;
+
+            {
+                std::unique_lock<std::mutex> lock(prewarmMutex);
+
+                while (! prewarmStop && prewarmQueue.empty())
+                    prewarmCond.wait(lock);
+
+                if (prewarmStop)
+                    break;
+
+                uri = std::move(prewarmQueue.front());
+                prewarmQueue.pop_front();
+            }
+
+            // skips already extracted plugins, and fails quietly on removed ones
+            const std::shared_lock<std::shared_mutex> lock(mutex);
+            getPluginByURI(uri.c_str());
+        }
+    }
+
+    // errors are only reported to foreground callers, lilvMutex must be held
+    void _setLastError(const char* const error)
+    {
+        if (! _isPrewarmThread)
+            last_error = error;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    void _addPluginURI(const std::string& uri, const std::string& bundlepath)
+    {
+        PluginCache& cache = pluginsCache[uri];
+        cache.bundlepath = bundlepath;
+        cache.index = static_cast<uint32_t>(pluginURIs.size());
+
+        pluginURIs.push_back(uri);
+
+        if (! bundlepath.empty())
+            bundles[bundlepath].push_back(uri);
+    }
+
+    // NOTE does not update bundles, caller is expected to handle it
+    void _removePluginURI(const std::string& uri)
+    {
+        const std::unordered_map<std::string, PluginCache>::iterator it = pluginsCache.find(uri);
+        assert_return(it != pluginsCache.end(),);
+
+        // move last plugin into the removed slot, pluginURIs is only sorted on startup
+        const uint32_t index = it->second.index;
+        assert_return(index < pluginURIs.size() && pluginURIs[index] == uri,);
+
+        if (index + 1 != pluginURIs.size())
+        {
+            pluginURIs[index] = std::move(pluginURIs.back());
+            pluginsCache[pluginURIs[index]].index = index;
+        }
+
+        pluginURIs.pop_back();
+        pluginsCache.erase(it);
+    }
+
+    // query the plugins declared in a bundle manifest, without loading it into the main world
+    void _probeBundle(std::vector<std::string>& pluginsInBundle, const char* const bundlepath)
+    {
+        if (probeWorld == nullptr)
+        {
+            probeWorld = lilv_world_new();
+            assert_return(probeWorld != nullptr,);
+
+           #ifdef LILV_OPTION_OBJECT_INDEX
+            lilv_world_set_option(probeWorld, LILV_OPTION_OBJECT_INDEX, nullptr);
+           #endif
+        }
+
+        LilvNode* const b = lilv_new_file_uri(probeWorld, nullptr, bundlepath);
+        assert_return(b != nullptr,);
+
+        // only the manifest is parsed here, plugin data is loaded lazily by lilv
+        lilv_world_load_bundle(probeWorld, b);
+
+        const LilvPlugins* const wplugins = lilv_world_get_all_plugins(probeWorld);
+
+        LILV_FOREACH(plugins, iter, wplugins)
+        {
+            const LilvPlugin* const p = lilv_plugins_get(wplugins, iter);
+
+            pluginsInBundle.emplace_back(lilv_node_as_uri(lilv_plugin_get_uri(p)));
+        }
+
+        // unload right away, so that the probe world stays empty
+        lilv_world_unload_bundle(probeWorld, b);
+        lilv_node_free(b);
+    }
+
+    // regular startup, lets lilv discover and parse everything
+    void _loadAll()
+    {
+        lilv_world_load_all(world);
+        specificationsLoaded = true;
+
+        plugins = lilv_world_get_all_plugins(world);
+        pluginURIs.reserve(lilv_plugins_size(plugins));
+
+        LILV_FOREACH(plugins, it, plugins)
+        {
+            const LilvPlugin* const p = lilv_plugins_get(plugins, it);
+
+            std::string bundlestr;
+
+            if (char* const lilvparsed = _lilv_file_abspath(lilv_plugin_get_bundle_uri(p)))
+            {
+                if (const char* const bundlepath = _realpath_with_terminator(lilvparsed))
+                    bundlestr = bundlepath;
+
+                std::free(lilvparsed);
+            }
+
+            _addPluginURI(lilv_node_as_uri(lilv_plugin_get_uri(p)), bundlestr);
+        }
+    }
+
+    // cached startup, only bundles that changed since last run are parsed by lilv
+    void _loadAllWithCache(const std::vector<std::string>& lv2path)
+    {
+        // discover bundles, in the same order as lilv
+        std::vector<std::string> bundlepaths;
+        {
+            std::unordered_set<std::string> seen;
+
+            for (const std::string& dir : lv2path)
+            {
+                std::vector<std::string> dirbundles;
+                std::error_code ec;
+
+                for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(dir, ec))
+                {
+                    if (! std::filesystem::exists(entry.path() / "manifest.ttl", ec))
+                        continue;
+
+                    if (const char* const bundlepath = _realpath_with_terminator(entry.path().string().c_str()))
+                    {
+                        if (seen.insert(bundlepath).second)
+                            dirbundles.emplace_back(bundlepath);
+                    }
+                }
+
+                std::sort(dirbundles.begin(), dirbundles.end());
+                bundlepaths.insert(bundlepaths.end(), dirbundles.begin(), dirbundles.end());
+            }
+        }
+
+        // load previous cache, ignoring it if invalid or outdated
+        nlohmann::json jbundles;
+
+        if (std::ifstream f(cachefile); ! f.fail())
+        {
+            try {
+                const nlohmann::json j = nlohmann::json::parse(f);
+
+               #ifdef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+                constexpr const bool minimal = true;
+               #else
+                constexpr const bool minimal = false;
+               #endif
+
+                if (j.at("type").get<std::string>() == "lv2-cache" &&
+                    j.at("version").get<int>() == LV2_CACHE_VERSION &&
+                    j.at("minimal").get<bool>() == minimal)
+                {
+                    jbundles = j.at("bundles");
+                }
+            } catch (const std::exception& e) {
+                mod_log_warn("failed to parse lv2 cache: %s", e.what());
+            }
+        }
+
+        if (! jbundles.is_object())
+            jbundles = nlohmann::json::object();
+
+        // register plugins from unchanged bundles, collect the rest for lilv parsing
+        std::vector<std::string> staleBundles;
+
+        for (const std::string& bundlepath : bundlepaths)
+        {
+            const int64_t mtime = _bundleModTime(bundlepath);
+            bundleMTimes[bundlepath] = mtime;
+
+            const nlohmann::json::const_iterator it = jbundles.find(bundlepath);
+
+            if (it == jbundles.cend() || ! _registerCachedBundle(bundlepath, mtime, *it))
+                staleBundles.push_back(bundlepath);
+        }
+
+        const bool cacheChanged = ! staleBundles.empty() ||
+                                  jbundles.size() != bundlepaths.size() - staleBundles.size();
+
+        mod_log_debug("lv2 cache: %zu bundles cached, %zu to parse",
+                      bundlepaths.size() - staleBundles.size(), staleBundles.size());
+
+        // parse changed bundles through lilv
+        if (! staleBundles.empty())
+        {
+            for (const std::string& bundlepath : staleBundles)
+            {
+                if (LilvNode* const b = lilv_new_file_uri(world, nullptr, bundlepath.c_str()))
+                {
+                    lilv_world_load_bundle(world, b);
+                    lilv_node_free(b);
+                }
+            }
+
+            _loadSpecificationsIfNeeded();
+
+            plugins = lilv_world_get_all_plugins(world);
+
+            std::vector<std::string> newURIs;
+
+            LILV_FOREACH(plugins, it, plugins)
+            {
+                const LilvPlugin* const p = lilv_plugins_get(plugins, it);
+
+                const std::string uri(lilv_node_as_uri(lilv_plugin_get_uri(p)));
+
+                if (pluginsCache.find(uri) != pluginsCache.end())
+                    continue;
+
+                std::string bundlestr;
+
+                if (char* const lilvparsed = _lilv_file_abspath(lilv_plugin_get_bundle_uri(p)))
+                {
+                    if (const char* const bundlepath = _realpath_with_terminator(lilvparsed))
+                        bundlestr = bundlepath;
+
+                    std::free(lilvparsed);
+                }
+
+                _addPluginURI(uri, bundlestr);
+                newURIs.push_back(uri);
+            }
+
+            for (const std::string& uri : newURIs)
+                getPluginByURI(uri.c_str());
+        }
+
+        // plugins were registered per bundle, use the same URI order as lilv and _loadAll
+        _sortPluginURIs();
+
+        if (cacheChanged)
+            saveCache();
+    }
+
+    void _sortPluginURIs()
+    {
+        std::sort(pluginURIs.begin(), pluginURIs.end());
+
+        for (uint32_t i = 0; i < pluginURIs.size(); ++i)
+            pluginsCache[pluginURIs[i]].index = i;
+    }
+
+    // register all plugins from a cached bundle, returns false if cache entry is outdated or invalid
+    bool _registerCachedBundle(const std::string& bundlepath, const int64_t mtime, const nlohmann::json& jbundle)
+    {
+        std::vector<std::pair<std::string, std::shared_ptr<const Lv2Plugin>>> records;
+
+        try {
+            if (jbundle.at("mtime").get<int64_t>() != mtime)
+                return false;
+
+            for (const auto& jplugin : jbundle.at("plugins").items())
+            {
+                // skip duplicates, first bundle wins as in lilv
+                if (pluginsCache.find(jplugin.key()) != pluginsCache.end())
+                    continue;
+
+                // null means plugin is known to be unsupported
+                if (jplugin.value().is_null())
+                {
+                    records.emplace_back(jplugin.key(), nullptr);
+                    continue;
+                }
+
+                Lv2Plugin* const plugin = _pluginFromJson(jplugin.value());
+
+                if (plugin == nullptr)
+                    return false;
+
+                records.emplace_back(jplugin.key(), plugin);
+            }
+        } catch (...) {
+            return false;
+        }
+
+        for (const auto& record : records)
+        {
+            _addPluginURI(record.first, bundlepath);
+            pluginsCache[record.first].plugin = record.second;
+        }
+
+        unloadedBundles.insert(bundlepath);
+        return true;
+    }
+
+    // load bundle in lilv, if it was skipped during startup due to being cached
+    void _loadBundleIfNeeded(const std::string& bundlepath)
+    {
+        if (unloadedBundles.erase(bundlepath) == 0)
+            return;
+
+        _loadSpecificationsIfNeeded();
+
+        if (LilvNode* const b = lilv_new_file_uri(world, nullptr, bundlepath.c_str()))
+        {
+            lilv_world_load_bundle(world, b);
+            lilv_node_free(b);
+        }
+
+        plugins = lilv_world_get_all_plugins(world);
+    }
+
+    // load specification bundles and plugin classes, as done by lilv_world_load_all
+    void _loadSpecificationsIfNeeded()
+    {
+        if (specificationsLoaded)
+            return;
+
+        specificationsLoaded = true;
+
+        // bundles without plugins are assumed to contain specifications
+        for (std::unordered_set<std::string>::iterator it = unloadedBundles.begin(); it != unloadedBundles.end();)
+        {
+            if (bundles.find(*it) != bundles.end())
+            {
+                ++it;
+                continue;
+            }
+
+            if (LilvNode* const b = lilv_new_file_uri(world, nullptr, it->c_str()))
+            {
+                lilv_world_load_bundle(world, b);
+                lilv_node_free(b);
+            }
+
+            it = unloadedBundles.erase(it);
+        }
+
+        lilv_world_load_specifications(world);
+        lilv_world_load_plugin_classes(world);
+    }
+
+    void saveCache()
+    {
+        if (cachefile.empty())
+            return;
+
+        cacheDirty = false;
+
+        nlohmann::json jbundles = nlohmann::json::object();
+
+        for (const auto& bundle : bundleMTimes)
+        {
+            jbundles[bundle.first] = nlohmann::json::object({
+                { "mtime", bundle.second },
+                { "plugins", nlohmann::json::object() },
+            });
+        }
+
+        for (const auto& entry : pluginsCache)
+        {
+            if (entry.second.bundlepath.empty())
+                continue;
+
+            const nlohmann::json::iterator it = jbundles.find(entry.second.bundlepath);
+            if (it == jbundles.end())
+                continue;
+
+            (*it)["plugins"][entry.first] = entry.second.plugin != nullptr
+                                          ? _pluginToJson(*entry.second.plugin)
+                                          : nlohmann::json();
+        }
+
+        const nlohmann::json j = nlohmann::json::object({
+            { "type", "lv2-cache" },
+            { "version", LV2_CACHE_VERSION },
+           #ifdef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+            { "minimal", true },
+           #else
+            { "minimal", false },
+           #endif
+            { "bundles", jbundles },
+        });
+
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(cachefile).parent_path(), ec);
+
+        if (! safeFileSave(cachefile, j.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace)))
+            mod_log_warn("failed to save lv2 cache to %s", cachefile.c_str());
+    }
+
+    // per-world URID map, shared by all state handling
+    std::mutex uridMutex;
+    std::unordered_map<std::string, LV2_URID> urids;
+    std::deque<std::string> uridURIs;
+
+    static LV2_URID _mapfn(LV2_URID_Map_Handle handle, const char* uri);
+    static const char* _unmapfn(LV2_URID_Unmap_Handle handle, LV2_URID urid);
+    static void _portfn(const char* symbol, void* userData, const void* value, uint32_t size, uint32_t type);
+    static void _pluginsInBundle(std::vector<std::string>& pluginsInBundle, const char* bundlepath);
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+Lv2World::Lv2World() : impl(new Impl(last_error)) {}
+Lv2World::~Lv2World() { delete impl; }
+
+// --------------------------------------------------------------------------------------------------------------------
+
+enum {
+    k_urid_null,
+    k_urid_atom_bool,
+    k_urid_atom_int,
+    k_urid_atom_long,
+    k_urid_atom_float,
+    k_urid_atom_double,
+};
+
+LV2_URID Lv2World::Impl::_mapfn(const LV2_URID_Map_Handle handle, const char* const uri)
+{
+    assert_return(uri != nullptr && uri[0] != '\0', k_urid_null);
+
+    Impl* const self = static_cast<Impl*>(handle);
+
+    const std::lock_guard<std::mutex> lock(self->uridMutex);
+
+    const std::unordered_map<std::string, LV2_URID>::const_iterator it = self->urids.find(uri);
+    if (it != self->urids.cend())
+        return it->second;
+
+    // urids start at 1, 0 is reserved
+    self->uridURIs.emplace_back(uri);
+    const LV2_URID urid = static_cast<LV2_URID>(self->uridURIs.size());
+    self->urids.emplace(uri, urid);
+    return urid;
+}
+
+const char* Lv2World::Impl::_unmapfn(const LV2_URID_Unmap_Handle handle, const LV2_URID urid)
+{
+    assert_return(urid != k_urid_null, nullptr);
+
+    Impl* const self = static_cast<Impl*>(handle);
+
+    const std::lock_guard<std::mutex> lock(self->uridMutex);
+
+    // NOTE deque never moves existing elements, pointer stays valid after unlock
+    return urid <= self->uridURIs.size() ? self->uridURIs[urid - 1].c_str() : nullptr;
+}
+
+void Lv2World::Impl::_portfn(const char* const symbol,
+                             void* const userData,
+                             const void* const value,
                              const uint32_t size,
                              const uint32_t type)
 {
@@ -1973,59 +3302,125 @@ void Lv2World::Impl::_pluginsInBundle(std::vector<std::string>& pluginsInBundle,
 
 uint32_t Lv2World::getPluginCount() const noexcept
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginCount();
 }
 
-const std::string& Lv2World::getPluginURI(const uint32_t index) const
+std::string Lv2World::getPluginURI(const uint32_t index) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginURI(index);
 }
 
 std::shared_ptr<const Lv2Plugin> Lv2World::getPluginByIndex(const uint32_t index) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginByIndex(index);
 }
 
 std::shared_ptr<const Lv2Plugin> Lv2World::getPluginByURI(const char* const uri) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginByURI(uri);
 }
 
 #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
 std::shared_ptr<const CustomStyling::BlockImage> Lv2World::getPluginBlockImageStyling(const char* uri) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginBlockImageStyling(uri);
 }
 
 std::shared_ptr<const CustomStyling::BlockSettings> Lv2World::getPluginBlockSettingsStyling(const char* uri) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginBlockSettingsStyling(uri);
 }
 
 const Lv2Port& Lv2World::getPluginPort(const char* const uri, const char* const symbol) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->getPluginPort(uri, symbol);
 }
 
 bool Lv2World::isPluginAvailable(const char* const uri) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->isPluginAvailable(uri);
 }
 
 std::unordered_map<std::string, float> Lv2World::loadPluginState(const char* const path) const
 {
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
     return impl->loadPluginState(path);
 }
 #endif
 
 bool Lv2World::bundleAdd(const char* const path, std::vector<std::string>* pluginsInBundle)
 {
-    return impl->bundleAdd(path, pluginsInBundle);
+    const std::lock_guard<std::shared_mutex> lock(impl->mutex);
+
+    if (! impl->bundleAdd(path, pluginsInBundle))
+        return false;
+
+    impl->saveCacheIfDirty();
+    return true;
 }
 
 bool Lv2World::bundleRemove(const char* const path, std::vector<std::string>* pluginsInBundle)
 {
-    return impl->bundleRemove(path, pluginsInBundle);
+    const std::lock_guard<std::shared_mutex> lock(impl->mutex);
+
+    if (! impl->bundleRemove(path, pluginsInBundle))
+        return false;
+
+    impl->saveCacheIfDirty();
+    return true;
+}
+
+#ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+std::vector<std::shared_ptr<const Lv2Plugin>> Lv2World::findPlugins(const Lv2PluginQuery& query) const
+{
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
+    return impl->findPlugins(query);
+}
+
+std::vector<std::string> Lv2World::getPluginBrands() const
+{
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
+    return impl->getPluginBrands();
+}
+#endif
+
+void Lv2World::prewarm(const std::vector<std::string>& uris) const
+{
+    const std::shared_lock<std::shared_mutex> lock(impl->mutex);
+    impl->prewarm(uris);
+}
+
+uint32_t Lv2World::mapURI(const char* const uri) const
+{
+    return impl->uridMap.map(impl->uridMap.handle, uri);
+}
+
+const char* Lv2World::unmapURID(const uint32_t urid) const
+{
+    return impl->uridUnmap.unmap(impl->uridUnmap.handle, urid);
+}
+
+bool Lv2World::startBundleWatcher(const uint32_t debounceMs)
+{
+    return impl->startBundleWatcher(debounceMs);
+}
+
+void Lv2World::stopBundleWatcher()
+{
+    impl->stopBundleWatcher();
+}
+
+std::vector<Lv2BundleChange> Lv2World::takeBundleChanges()
+{
+    return impl->takeBundleChanges();
 }
 
 bool Lv2World::getPluginsInBundle(const char* const path, std::vector<std::string>& pluginsInBundle)
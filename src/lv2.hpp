@@ -137,6 +137,8 @@ struct Lv2Plugin {
 #ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
     std::string name;
     std::string abbreviation;
+    // mod:brand, or author name if not set
+    std::string brand;
     Lv2Category category = kLv2CategoryNone;
     std::vector<Lv2Port> ports;
     std::vector<Lv2Property> properties;
@@ -146,9 +148,30 @@ struct Lv2Plugin {
 #endif
 };
 
+#ifndef MOD_CONNECTOR_MINIMAL_LV2_WORLD
+struct Lv2PluginQuery {
+    // case-insensitive text to match against plugin name and abbreviation, empty matches all
+    std::string text;
+    // match only the start of name or abbreviation, instead of anywhere within
+    bool prefixOnly = false;
+    // kLv2CategoryNone matches all, parent categories match their subcategories
+    Lv2Category category = kLv2CategoryNone;
+    // exact brand name, empty matches all
+    std::string brand;
+};
+#endif
+
+struct Lv2BundleChange {
+    // NOTE includes path separator as last character
+    std::string path;
+    bool added;
+};
+
+// NOTE all lookups are safe to call from multiple threads at once, bundleAdd and bundleRemove run exclusively
 struct Lv2World {
    /**
     * string describing the last error, in case any operation fails.
+    * @note not synchronized, only reliable when Lv2World is used from a single thread
     */
     std::string last_error;
 
@@ -157,8 +180,11 @@ struct Lv2World {
     [[nodiscard]] uint32_t getPluginCount() const noexcept;
 
    /* get the plugin URI @a index
+    * plugins are sorted by URI on startup, same as lilv, regardless of the metadata cache being used
+    * NOTE plugins from bundleAdd are appended, and plugin order may change after bundleRemove
+    * returns a copy, as the internal list can change after the lock is released
     */
-    [[nodiscard]] const std::string& getPluginURI(uint32_t index) const;
+    [[nodiscard]] std::string getPluginURI(uint32_t index) const;
 
    /* get the plugin @a index
     * can return null in case of error or the plugin requires unsupported features
@@ -192,6 +218,15 @@ struct Lv2World {
    /* load a plugin state from disk and return a symbol -> value map
     */
     [[nodiscard]] std::unordered_map<std::string, float> loadPluginState(const char* path) const;
+
+   /* search the plugin catalogue, results are sorted by name
+    * plugins that fail to load are not part of the catalogue
+    */
+    [[nodiscard]] std::vector<std::shared_ptr<const Lv2Plugin>> findPlugins(const Lv2PluginQuery& query) const;
+
+   /* get the brands of all plugins in the catalogue, sorted
+    */
+    [[nodiscard]] std::vector<std::string> getPluginBrands() const;
 #endif
 
    /**
@@ -208,6 +243,45 @@ struct Lv2World {
     */
     [[nodiscard]] bool bundleRemove(const char* path, std::vector<std::string>* pluginsInBundle = nullptr);
 
+   /**
+    * extract plugin metadata in a background thread, so later lookups do not have to.
+    * @arg uris plugins to extract first, or empty to extract all known plugins
+    * @note lookups for a plugin being extracted will wait for it to finish
+    */
+    void prewarm(const std::vector<std::string>& uris = {}) const;
+
+   /**
+    * map an URI to an LV2 URID, shared by all LV2 state handling of this world.
+    * safe to call from any thread.
+    */
+    [[nodiscard]] uint32_t mapURI(const char* uri) const;
+
+   /**
+    * get the URI of a previously mapped LV2 URID, or null if unknown.
+    * returned string is valid for the lifetime of this world.
+    */
+    [[nodiscard]] const char* unmapURID(uint32_t urid) const;
+
+   /**
+    * watch the LV2_PATH directories for installed, removed or modified bundles, in a background thread.
+    * bundles with modified files are reloaded only if their ttl files are newer than when loaded.
+    * changes are debounced by @a debounceMs and applied to this world as they happen,
+    * use takeBundleChanges() to get what changed since the last call.
+    * @note currently only supported on Linux, returns false elsewhere
+    */
+    bool startBundleWatcher(uint32_t debounceMs = 500);
+
+   /**
+    * stop watching the LV2_PATH directories, does nothing if not watching.
+    */
+    void stopBundleWatcher();
+
+   /**
+    * get bundles added or removed by the watcher since the last call, in order.
+    * a reloaded bundle is reported as removed and then added again.
+    */
+    [[nodiscard]] std::vector<Lv2BundleChange> takeBundleChanges();
+
    /**
     * get the plugin URIs present in an LV2 bundle
     * @note path MUST end with OS-specific path separator (e.g. '/' under Linux)
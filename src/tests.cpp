@@ -5,12 +5,16 @@
 
 #define MONOBLOCK "urn:mod-connector:test1in1out"
 #define STEREOBLOCK "urn:mod-connector:test2in2out"
+#define PARAMSBLOCK "urn:mod-connector:testparams"
+#define MIXERBLOCK "urn:mod-connector:testmixer"
+#define DELAYBLOCK "urn:mod-connector:testdelay"
 #define SIDEOUTBLOCK "urn:mod-connector:testsideout"
 #define SIDEINBLOCK "urn:mod-connector:testsidein"
 
 #define PRESETFILEPATH "./test-presets"
 
 #include "connector.hpp"
+#include "json.hpp"
 #include "utils.hpp"
 
 #include <jack/jack.h>
@@ -18,8 +22,17 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QProcess>
+#include <QtCore/QThread>
 #include <QtCore/QTimer>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
 // --------------------------------------------------------------------------------------------------------------------
 
 constexpr const char* getProcessErrorAsString(QProcess::ProcessError error)
@@ -68,6 +81,15 @@ public:
             kill();
     }
 
+    // start a new mod-host process, as if the previous one had crashed
+    void restart()
+    {
+        terminate();
+        closing = false;
+        start();
+        waitForStarted(1000);
+    }
+
 public slots:
     void startSlot()
     {
@@ -117,6 +139,24 @@ static QStringList q_jack_port_get_all_connections(jack_client_t* const client,
     return {};
 }
 
+// number of port disconnections reported by jack so far, for checking which connections were kept
+static std::atomic<uint> numJackDisconnections { 0 };
+
+static void q_jack_port_connect_callback(jack_port_id_t, jack_port_id_t, const int connect, void*)
+{
+    if (connect == 0)
+        ++numJackDisconnections;
+}
+
+// number of port unregistrations reported by jack so far, for checking which plugin instances were kept
+static std::atomic<uint> numJackPortUnregistrations { 0 };
+
+static void q_jack_port_registration_callback(jack_port_id_t, const int reg, void*)
+{
+    if (reg == 0)
+        ++numJackPortUnregistrations;
+}
+
 class HostConnectorTests : public QObject
 {
     jack_client_t* const client;
@@ -150,6 +190,29 @@ class HostConnectorTests : public QObject
         assert_return(connector.lv2world.getPluginByURI(STEREOBLOCK) != nullptr, false);
         assert_return(connector.lv2world.getPluginByURI(SIDEOUTBLOCK) != nullptr, false);
         assert_return(connector.lv2world.getPluginByURI(SIDEINBLOCK) != nullptr, false);
+        assert_return(connector.lv2world.getPluginByURI(PARAMSBLOCK) != nullptr, false);
+        assert_return(connector.lv2world.getPluginByURI(MIXERBLOCK) != nullptr, false);
+        assert_return(connector.lv2world.getPluginByURI(DELAYBLOCK) != nullptr, false);
+
+        // test plugin metadata prewarming
+        assert_return(testLv2Prewarm(), false);
+
+        // test plugin lookups from several threads at once
+        assert_return(testLv2ConcurrentReaders(), false);
+
+        // test plugin catalogue search
+        assert_return(testLv2Catalogue(), false);
+
+        // test URID mapping
+        assert_return(testLv2URIDMap(), false);
+
+        // test lv2 metadata cache
+        assert_return(testLv2Cache(), false);
+
+       #ifdef __linux__
+        // test lv2 bundle watcher
+        assert_return(testLv2BundleWatcher(), false);
+       #endif
 
         // initial empty bank load
         {
@@ -169,6 +232,16 @@ class HostConnectorTests : public QObject
         // check return to pass-through connections
         assert_return(testPassthrough(), false);
 
+        // test user block defaults
+        assert_return(testBlockDefaults(), false);
+        // check return to pass-through connections
+        assert_return(testPassthrough(), false);
+
+        // test blocks created from cached prototypes
+        assert_return(testBlockPrototypes(), false);
+        // check return to pass-through connections
+        assert_return(testPassthrough(), false);
+
         // test mono chain actions
         assert_return(testSingleMonoChain(), false);
         // check return to pass-through state
@@ -179,11 +252,83 @@ class HostConnectorTests : public QObject
         // check return to pass-through state
         assert_return(testPassthrough(), false);
 
+        // test copying and moving blocks between presets
+        assert_return(testBlockTransfer(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test loading a preset file with several instances set up at once
+        assert_return(testBatchedPresetLoad(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test cached load programs follow preset edits
+        assert_return(testLoadProgramCache(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test bank load timings, with presets loaded in the background
+        assert_return(testBankLoadTimings(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test port names of instance ids given to other plugins
+        assert_return(testPortNameCache(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test reusing plugin instances when changing banks
+        assert_return(testInstanceReuseAcrossBanks(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test spare instance pool
+        assert_return(testInstancePool(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
         // test side chain management
         assert_return(testSideChain(), false);
         // check return to pass-through state
         assert_return(testPassthrough(), false);
 
+        // test rewiring through connection graph changes
+        assert_return(testConnectionGraph(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+       #if PREPARED_BANK_INSTANCES
+        // test switching to a bank prepared in the background
+        assert_return(testPreparedBank(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+       #endif
+
+        // test preset switches through a crossfade mixer tool
+        assert_return(testPresetSwitchCrossfade(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test delay blocks ringing after preset switches
+        assert_return(testPresetSwitchSpillover(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test coalescing of preset switch requests
+        assert_return(testPresetSwitchRequests(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test skipping of messages that would not change anything in mod-host
+        assert_return(testSkippedHostMessages(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
+        // test reconnecting to mod-host, needs to be the last test as it restarts mod-host
+        assert_return(testHostReconnect(), false);
+        // check return to pass-through state
+        assert_return(testPassthrough(), false);
+
         mod_log_info("SUCCESS: All tests finished successfully!");
 
         return true;
@@ -246,6 +391,354 @@ class HostConnectorTests : public QObject
         return true;
     }
 
+    // test prewarmed plugin metadata is the same as looked up on demand
+    bool testLv2Prewarm()
+    {
+        mod_log_info("testLv2Prewarm()");
+
+        const Lv2World& lv2world = connector.lv2world;
+
+        // explicit plugins go ahead of everything else
+        lv2world.prewarm({ MONOBLOCK, STEREOBLOCK });
+        lv2world.prewarm();
+
+        for (uint32_t i = 0; i < lv2world.getPluginCount(); ++i)
+        {
+            const std::string uri = lv2world.getPluginURI(i);
+            const std::shared_ptr<const Lv2Plugin> plugin = lv2world.getPluginByURI(uri.c_str());
+
+            // skip invalid plugins, if any
+            if (plugin == nullptr && uri != MONOBLOCK && uri != STEREOBLOCK)
+                continue;
+
+            assert_return(plugin != nullptr, false);
+            assert_return(plugin->uri == uri, false);
+
+            // lookups keep returning the same cached plugin, while prewarming or after
+            assert_return(lv2world.getPluginByURI(uri.c_str()) == plugin, false);
+            assert_return(lv2world.getPluginByIndex(i) == plugin, false);
+        }
+
+        return true;
+    }
+
+    // test plugin lookups running in parallel all get the same cached plugins
+    bool testLv2ConcurrentReaders()
+    {
+        mod_log_info("testLv2ConcurrentReaders()");
+
+        const Lv2World& lv2world = connector.lv2world;
+        const uint32_t count = lv2world.getPluginCount();
+
+        std::array<std::vector<std::shared_ptr<const Lv2Plugin>>, 4> found;
+        std::array<std::thread, 4> threads;
+        std::atomic<bool> portsOk { true };
+
+        for (uint32_t t = 0; t < threads.size(); ++t)
+        {
+            found[t].resize(count);
+
+            threads[t] = std::thread([&lv2world, &plugins = found[t], &portsOk, count, t] {
+                // each thread starts from a different plugin
+                for (uint32_t n = 0; n < count; ++n)
+                {
+                    const uint32_t i = (n + t * count / 4) % count;
+                    plugins[i] = lv2world.getPluginByURI(lv2world.getPluginURI(i).c_str());
+                }
+
+                if (lv2world.getPluginPort(MONOBLOCK, "in1").symbol != "in1")
+                    portsOk = false;
+                if (lv2world.getPluginPort(STEREOBLOCK, "out2").symbol != "out2")
+                    portsOk = false;
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        assert_return(portsOk, false);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (uint32_t t = 1; t < found.size(); ++t)
+                assert_return(found[t][i] == found[0][i], false);
+
+            if (found[0][i] != nullptr)
+                assert_return(found[0][i]->uri == lv2world.getPluginURI(i), false);
+        }
+
+        return true;
+    }
+
+    // test searching the plugin catalogue by text, category and brand
+    bool testLv2Catalogue()
+    {
+        mod_log_info("testLv2Catalogue()");
+
+        const Lv2World& lv2world = connector.lv2world;
+
+        // position of a plugin within search results, -1 if not found
+        const auto findIndex = [](const std::vector<std::shared_ptr<const Lv2Plugin>>& plugins, const char* const uri) {
+            for (size_t i = 0; i < plugins.size(); ++i)
+            {
+                if (plugins[i]->uri == uri)
+                    return static_cast<int>(i);
+            }
+            return -1;
+        };
+
+        Lv2PluginQuery query;
+        std::vector<std::shared_ptr<const Lv2Plugin>> plugins;
+
+        // empty query returns all plugins, sorted by name
+        plugins = lv2world.findPlugins(query);
+        assert_return(findIndex(plugins, MONOBLOCK) != -1, false);
+        assert_return(findIndex(plugins, STEREOBLOCK) != -1, false);
+        assert_return(findIndex(plugins, SIDEOUTBLOCK) != -1, false);
+        assert_return(findIndex(plugins, SIDEINBLOCK) != -1, false);
+        assert_return(findIndex(plugins, MONOBLOCK) < findIndex(plugins, STEREOBLOCK), false);
+
+        // text is case-insensitive
+        query.text = "2IN2";
+        plugins = lv2world.findPlugins(query);
+        assert_return(plugins.size() == 1, false);
+        assert_return(plugins.front()->uri == STEREOBLOCK, false);
+
+        // text matches anywhere within the name, unless searching by prefix
+        query.text = "1in1";
+        plugins = lv2world.findPlugins(query);
+        assert_return(findIndex(plugins, MONOBLOCK) != -1, false);
+
+        query.prefixOnly = true;
+        plugins = lv2world.findPlugins(query);
+        assert_return(findIndex(plugins, MONOBLOCK) == -1, false);
+
+        query.text = "test1";
+        plugins = lv2world.findPlugins(query);
+        assert_return(plugins.size() == 1, false);
+        assert_return(plugins.front()->uri == MONOBLOCK, false);
+
+        // parent categories match their subcategories
+        query = {};
+        query.category = kLv2CategoryUtility;
+        plugins = lv2world.findPlugins(query);
+        assert_return(findIndex(plugins, MONOBLOCK) != -1, false);
+        assert_return(findIndex(plugins, STEREOBLOCK) != -1, false);
+
+        query.category = kLv2CategoryDelay;
+        plugins = lv2world.findPlugins(query);
+        assert_return(findIndex(plugins, MONOBLOCK) == -1, false);
+        assert_return(findIndex(plugins, STEREOBLOCK) == -1, false);
+
+        // brand must match exactly
+        query = {};
+        query.brand = "urn:mod-connector:nonexistent";
+        assert_return(lv2world.findPlugins(query).empty(), false);
+
+        const std::vector<std::string> brands = lv2world.getPluginBrands();
+        assert_return(std::is_sorted(brands.begin(), brands.end()), false);
+
+        return true;
+    }
+
+    // test URIs map to stable ids that unmap back, also when mapped from several threads at once
+    bool testLv2URIDMap()
+    {
+        mod_log_info("testLv2URIDMap()");
+
+        const Lv2World& lv2world = connector.lv2world;
+
+        const uint32_t monoId = lv2world.mapURI(MONOBLOCK);
+        const uint32_t stereoId = lv2world.mapURI(STEREOBLOCK);
+        assert_return(monoId != 0, false);
+        assert_return(stereoId != 0, false);
+        assert_return(monoId != stereoId, false);
+        assert_return(lv2world.mapURI(MONOBLOCK) == monoId, false);
+        assert_return(std::strcmp(lv2world.unmapURID(monoId), MONOBLOCK) == 0, false);
+        assert_return(std::strcmp(lv2world.unmapURID(stereoId), STEREOBLOCK) == 0, false);
+
+        // ids not handed out yet do not unmap
+        assert_return(lv2world.unmapURID(UINT32_MAX) == nullptr, false);
+
+        // map the same new URIs from several threads, all must get the same ids
+        std::array<std::vector<uint32_t>, 4> ids;
+        std::array<std::thread, 4> threads;
+
+        for (uint32_t t = 0; t < threads.size(); ++t)
+        {
+            threads[t] = std::thread([&lv2world, &threadIds = ids[t]] {
+                for (uint32_t i = 0; i < 100; ++i)
+                    threadIds.push_back(lv2world.mapURI(format("urn:mod-connector:tests:urid%u", i).c_str()));
+            });
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            assert_return(ids[0][i] != 0, false);
+
+            for (uint32_t t = 1; t < ids.size(); ++t)
+                assert_return(ids[t][i] == ids[0][i], false);
+
+            assert_return(lv2world.unmapURID(ids[0][i]) == format("urn:mod-connector:tests:urid%u", i), false);
+        }
+
+        return true;
+    }
+
+    // test the lv2 metadata cache gives the same plugins as a full lilv scan, and is refreshed when outdated
+    bool testLv2Cache()
+    {
+        mod_log_info("testLv2Cache()");
+
+        const std::filesystem::path cachedir = std::filesystem::temp_directory_path() / "mod-connector-tests-lv2cache";
+        const std::filesystem::path cachefile = cachedir / "lv2-plugins.json";
+        std::filesystem::remove_all(cachedir);
+
+        const auto getURIs = [](const Lv2World& lv2world) {
+            std::vector<std::string> uris;
+            for (uint32_t i = 0; i < lv2world.getPluginCount(); ++i)
+                uris.push_back(lv2world.getPluginURI(i));
+            return uris;
+        };
+
+        // reference scan through lilv, without cache
+        setenv("MOD_LV2_CACHE_PATH", "", 1);
+
+        std::vector<std::string> uris;
+        std::string bundlepath;
+        size_t numPorts;
+        {
+            const Lv2World lv2world;
+            uris = getURIs(lv2world);
+            assert_return(std::is_sorted(uris.begin(), uris.end()), false);
+
+            const std::shared_ptr<const Lv2Plugin> plugin = lv2world.getPluginByURI(PARAMSBLOCK);
+            assert_return(plugin != nullptr, false);
+            bundlepath = plugin->bundlepath;
+            numPorts = plugin->ports.size();
+        }
+
+        setenv("MOD_LV2_CACHE_PATH", (cachedir.string() + PATH_SEP_STR).c_str(), 1);
+
+        // first run parses everything and writes the cache
+        {
+            const Lv2World lv2world;
+            assert_return(getURIs(lv2world) == uris, false);
+        }
+        assert_return(std::filesystem::exists(cachefile), false);
+
+        // second run is served from the cache, in the same order and with the same metadata
+        const std::filesystem::file_time_type cacheTime = std::filesystem::last_write_time(cachefile);
+        {
+            const Lv2World lv2world;
+            assert_return(getURIs(lv2world) == uris, false);
+
+            const std::shared_ptr<const Lv2Plugin> plugin = lv2world.getPluginByURI(PARAMSBLOCK);
+            assert_return(plugin != nullptr, false);
+            assert_return(plugin->bundlepath == bundlepath, false);
+            assert_return(plugin->ports.size() == numPorts, false);
+        }
+        assert_return(std::filesystem::last_write_time(cachefile) == cacheTime, false);
+
+        // modified bundle is parsed again, cache gets rewritten
+        const std::filesystem::path manifest = std::filesystem::path(bundlepath) / "manifest.ttl";
+        std::filesystem::last_write_time(manifest, std::filesystem::last_write_time(manifest) + std::chrono::seconds(1));
+        {
+            const Lv2World lv2world;
+            assert_return(getURIs(lv2world) == uris, false);
+            assert_return(lv2world.getPluginByURI(PARAMSBLOCK) != nullptr, false);
+        }
+        assert_return(std::filesystem::last_write_time(cachefile) != cacheTime, false);
+
+        // cache from an older version is ignored and replaced
+        {
+            std::ofstream f(cachefile);
+            f << "{\"type\":\"lv2-cache\",\"version\":0,\"minimal\":false,\"bundles\":{}}";
+        }
+        {
+            const Lv2World lv2world;
+            assert_return(getURIs(lv2world) == uris, false);
+        }
+        {
+            std::ifstream f(cachefile);
+            std::string contents((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            assert_return(contents.find("\"version\":0") == std::string::npos, false);
+            assert_return(contents.find(PARAMSBLOCK) != std::string::npos, false);
+        }
+
+        // bundle changes are written to disk right away, not only on shutdown
+        {
+            const auto cacheContains = [&cachefile](const char* const text) {
+                std::ifstream f(cachefile);
+                std::string contents((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                return contents.find(text) != std::string::npos;
+            };
+
+            Lv2World lv2world;
+            assert_return(lv2world.bundleRemove(bundlepath.c_str()), false);
+            assert_return(! cacheContains(PARAMSBLOCK), false);
+            assert_return(lv2world.bundleAdd(bundlepath.c_str()), false);
+            assert_return(cacheContains(PARAMSBLOCK), false);
+            assert_return(! std::filesystem::exists(cachefile.string() + ".tmp"), false);
+        }
+
+        unsetenv("MOD_LV2_CACHE_PATH");
+        std::filesystem::remove_all(cachedir);
+
+        return true;
+    }
+
+   #ifdef __linux__
+    // test the bundle watcher reloads bundles modified in place, but only if their contents are newer
+    bool testLv2BundleWatcher()
+    {
+        mod_log_info("testLv2BundleWatcher()");
+
+        setenv("MOD_LV2_CACHE_PATH", "", 1);
+
+        Lv2World lv2world;
+        unsetenv("MOD_LV2_CACHE_PATH");
+
+        const std::shared_ptr<const Lv2Plugin> plugin = lv2world.getPluginByURI(PARAMSBLOCK);
+        assert_return(plugin != nullptr, false);
+
+        const std::string bundlepath = plugin->bundlepath;
+        const std::filesystem::path manifest = std::filesystem::path(bundlepath) / "manifest.ttl";
+
+        assert_return(lv2world.startBundleWatcher(100), false);
+
+        // waits for changes to be applied, or the timeout to pass
+        const auto takeChanges = [&lv2world](const uint32_t timeout_ms) {
+            std::vector<Lv2BundleChange> changes;
+            for (uint32_t ms = 0; ms < timeout_ms && changes.empty(); ms += 50)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                changes = lv2world.takeBundleChanges();
+            }
+            return changes;
+        };
+
+        // touching files without changing their mtime does not reload the bundle
+        std::filesystem::last_write_time(manifest, std::filesystem::last_write_time(manifest));
+        assert_return(takeChanges(500).empty(), false);
+
+        // newer contents reload the bundle
+        std::filesystem::last_write_time(manifest, std::filesystem::last_write_time(manifest) + std::chrono::seconds(1));
+
+        const std::vector<Lv2BundleChange> changes = takeChanges(2000);
+        assert_return(changes.size() == 2, false);
+        assert_return(changes[0].path == bundlepath && ! changes[0].added, false);
+        assert_return(changes[1].path == bundlepath && changes[1].added, false);
+        assert_return(lv2world.getPluginByURI(PARAMSBLOCK) != nullptr, false);
+
+        lv2world.stopBundleWatcher();
+        return true;
+    }
+   #endif
+
     // test loading each individual test block
     bool testPluginLoad()
     {
@@ -299,6 +792,142 @@ class HostConnectorTests : public QObject
         return true;
     }
 
+    // test user block defaults apply to new blocks, and changes to them are picked up
+    bool testBlockDefaults()
+    {
+        mod_log_info("testBlockDefaults()");
+
+        // test blocks have no brand or abbreviation, their user defaults bundle is shared
+        const std::filesystem::path defdir = QDir::homePath().toStdString() + "/.lv2/default-.lv2";
+        const std::filesystem::path statefile = defdir / "default.ttl";
+        const std::filesystem::path extrafile = defdir / "defaults.json";
+
+        // do not touch defaults from a real user
+        if (std::filesystem::exists(defdir))
+        {
+            mod_log_warn("testBlockDefaults(): %s already exists, skipping test", defdir.c_str());
+            return true;
+        }
+
+        int numWrites = 0;
+
+        const auto writeDefaults = [&](const float gain, const char* const quickpot) {
+            std::filesystem::create_directories(defdir);
+
+            std::ofstream(statefile)
+                << "@prefix lv2: <http://lv2plug.in/ns/lv2core#> .\n"
+                << "@prefix pset: <http://lv2plug.in/ns/ext/presets#> .\n"
+                << "<> a pset:Preset ;\n"
+                << "    lv2:appliesTo <" PARAMSBLOCK "> ;\n"
+                << "    lv2:port [ lv2:symbol \"gain\" ; pset:value " << gain << " ] .\n";
+
+            std::ofstream(extrafile) << "{\"quickpot\":\"" << quickpot << "\"}\n";
+
+            // make sure modification times change, even on filesystems with coarse timestamps
+            const std::filesystem::file_time_type mtime = std::filesystem::file_time_type::clock::now()
+                                                        + std::chrono::seconds(++numWrites);
+            std::filesystem::last_write_time(statefile, mtime);
+            std::filesystem::last_write_time(extrafile, mtime);
+        };
+
+        // new block uses user defaults
+        writeDefaults(0.25f, "level");
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.25f), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "level"), 5.f), false);
+        assert_return(connector.current.block(0, 0).quickPotSymbol == "level", false);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+
+        // changed user defaults are picked up
+        writeDefaults(0.75f, "gain");
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.75f), false);
+        assert_return(connector.current.block(0, 0).quickPotSymbol == "gain", false);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+
+        // removed user defaults are no longer used
+        std::filesystem::remove_all(defdir);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.5f), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "level"), 5.f), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+
+        return true;
+    }
+
+    // test blocks of the same plugin start out the same, regardless of changes to other blocks
+    bool testBlockPrototypes()
+    {
+        mod_log_info("testBlockPrototypes()");
+
+        // chain: params
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        connector.setBlockParameter(0, 0, "gain", 0.9f);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.9f), false);
+
+        // chain becomes: params - params
+        // new block starts from defaults, not from the changes on the first one
+        assert_return(connector.replaceBlock(0, 1, PARAMSBLOCK), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.9f), false);
+        assert_return(isEqual(blockParameterValue(0, 1, "gain"), 0.5f), false);
+        assert_return(isEqual(blockParameterValue(0, 1, "level"), 5.f), false);
+
+        // both blocks have the same parameters
+        {
+            const HostConnector::Block& block0 = connector.current.block(0, 0);
+            const HostConnector::Block& block1 = connector.current.block(0, 1);
+            assert_return(block0.parameterIndexForSymbol("gain") != UINT8_MAX, false);
+            assert_return(block0.parameterIndexForSymbol("gain") == block1.parameterIndexForSymbol("gain"), false);
+            assert_return(block0.parameterIndexForSymbol("level") == block1.parameterIndexForSymbol("level"), false);
+        }
+
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // chain becomes: mono - params
+        // and back to: params - params, with defaults again
+        assert_return(connector.replaceBlock(0, 0, MONOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.5f), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+
+        // virtual parameters added after the plugin was used apply to new blocks
+        {
+            Lv2Port vport;
+            vport.symbol = ":vgain";
+            vport.name = "Virtual Gain";
+            vport.flags = Lv2PortIsControl|Lv2ParameterVirtual;
+            vport.def = 0.5f;
+            connector.virtualParameters[PARAMSBLOCK] = { vport };
+        }
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(connector.current.block(0, 0).parameterIndexForSymbol(":vgain") != UINT8_MAX, false);
+        assert_return(connector.current.block(0, 0).parameterIndexForSymbol("gain") != UINT8_MAX, false);
+        assert_return(connector.current.block(0, 1).parameterIndexForSymbol(":vgain") == UINT8_MAX, false);
+
+        // and no longer apply once removed
+        connector.virtualParameters.erase(PARAMSBLOCK);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(connector.current.block(0, 0).parameterIndexForSymbol(":vgain") == UINT8_MAX, false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+
+        // remove blocks
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+
+        return true;
+    }
+
     // test adding, reordering and removing on a single-row mono chain
     bool testSingleMonoChain()
     {
@@ -355,6 +984,30 @@ class HostConnectorTests : public QObject
         // save preset state to file
         assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSingleMonoChain.json"), false);
 
+        // check preset library index matches saved preset
+        {
+            HostConnector::PresetLibraryEntry entry;
+            assert_return(HostConnector::getPresetLibraryEntry(PRESETFILEPATH "/testSingleMonoChain.json", entry), false);
+            assert_return(entry.uris.size() == 1, false);
+            assert_return(entry.uris.front() == MONOBLOCK, false);
+            assert_return(! HostConnector::getPresetLibrary(PRESETFILEPATH).empty(), false);
+            assert_return(HostConnector::getPresetNameFromFile(PRESETFILEPATH "/testSingleMonoChain.json") == entry.name, false);
+
+            // renamed preset must not return the indexed name, mtime bumped for coarse filesystem timestamps
+            const std::filesystem::path path(PRESETFILEPATH "/testSingleMonoChain.json");
+            connector.setCurrentPresetName("testPresetLibraryRenamed");
+            assert_return(connector.saveCurrentPresetToFile(path.string().c_str()), false);
+            std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+            assert_return(HostConnector::getPresetNameFromFile(path.string().c_str()) == "testPresetLibraryRenamed", false);
+            assert_return(HostConnector::getPresetLibraryEntry(path.string().c_str(), entry), false);
+            assert_return(entry.name == "testPresetLibraryRenamed", false);
+            assert_return(HostConnector::getPresetNameFromFile(path.string().c_str()) == "testPresetLibraryRenamed", false);
+
+            // index lives in the connector cache directory, never inside preset folders
+            for (const std::filesystem::directory_entry& dirEntry : std::filesystem::directory_iterator(PRESETFILEPATH))
+                assert_return(dirEntry.path().filename().string().front() != '.', false);
+        }
+
         // remove plugin from end
         assert_return(connector.replaceBlock(0, 5, nullptr), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
@@ -813,124 +1466,124 @@ class HostConnectorTests : public QObject
         return true;
     }
 
-    // test building 2-row (sidechain) setup from left to right (and dismantling right to left)
-    bool testSideChainBuiltInOrder()
+    // test copying and moving blocks between active and inactive presets
+    bool testBlockTransfer()
     {
-        mod_log_info("testSideChainBuiltInOrder()");
+        mod_log_info("testBlockTransfer()");
 
-        // branch to sidechain
-        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
-        assert_return(testNoPassthrough(), false);
+        // load empty bank
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        // add a block on non-finished sidechain
-        assert_return(connector.replaceBlock(1, 2, MONOBLOCK), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
-        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
-        assert_return(testNoPassthrough(), false);
+        // chain: mono - empty - mono
+        assert_return(connector.replaceBlock(0, 0, MONOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 2, MONOBLOCK), false);
 
-        // complete sidechain
-        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        // copy block from active preset into inactive one, source stays as-is
+        assert_return(connector.copyBlockToPreset(0, 0, 0, 1, 0, 3), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // save preset state to file
-        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder1.json"), false);
-
-        // remove sidein block (undo sidechain ending)
-        assert_return(connector.replaceBlock(0, 4, nullptr), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
-        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
+        // check copied block
+        assert_return(connector.switchPreset(1), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 3), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 3), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // replace sidechain block with a stereo one
-        assert_return(connector.replaceBlock(1, 2, STEREOBLOCK), false);
+        // chain becomes: empty - stereo - empty - dual mono
+        assert_return(connector.replaceBlock(0, 1, STEREOBLOCK), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
-        assert_return(checkNoConnections(blockPortOut2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 1), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 3)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPairPortIn1(0, 3)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 3), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 3), JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // complete sidechain
-        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        // move stereo block from inactive preset into active one
+        // chain becomes: mono - stereo - dual mono
+        assert_return(connector.switchPreset(0), false);
+        assert_return(connector.moveBlockToPreset(1, 0, 1, 0, 0, 1), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), blockPortIn1(0, 1), blockPortIn2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // save preset state to file
-        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder2.json"), false);
+        // source preset no longer has the stereo block, mono block loses its pair
+        assert_return(connector.switchPreset(1), false);
+        assert_return(connector.getBlockIdPairOnly(0, 3).empty(), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 3), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 3), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
 
-        // remove sidein block (undo sidechain ending)
-        assert_return(connector.replaceBlock(0, 4, nullptr), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
-        assert_return(checkNoConnections(blockPortOut2(1, 2)), false);
+        // move stereo block out of the active preset
+        // chain becomes: mono - empty - mono
+        assert_return(connector.switchPreset(0), false);
+        assert_return(connector.moveBlockToPreset(0, 0, 1, 2, 0, 0), false);
+        assert_return(connector.getBlockIdPairOnly(0, 2).empty(), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // remove stereo block from sidechain
-        assert_return(connector.replaceBlock(1, 2, nullptr), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        // check moved block
+        assert_return(connector.switchPreset(2), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 0), JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
+        assert_return(connector.switchPreset(0), false);
 
-        // remove remaining block
-        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+        // transfers within the same preset are rejected
+        assert_return(!connector.copyBlockToPreset(0, 0, 0, 0, 0, 5), false);
+        assert_return(!connector.moveBlockToPreset(0, 0, 0, 0, 0, 5), false);
 
-        assert_return(testPassthrough(), false);
-        
-        // switch to an empty preset and back
-        assert_return(connector.switchPreset(1), false);
-        assert_return(testPassthrough(), false);
-        assert_return(connector.switchPreset(0), false);
+        // transfers from an empty block are rejected
+        assert_return(!connector.copyBlockToPreset(0, 0, 1, 1, 0, 0), false);
+        assert_return(!connector.moveBlockToPreset(0, 0, 1, 1, 0, 0), false);
 
-        // check connections are the same as before saving the file
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        // chain becomes: mono - empty - mono - empty - sidechain out
+        assert_return(connector.replaceBlock(0, 4, SIDEOUTBLOCK), false);
+
+        // transfers of sidechain blocks are rejected
+        assert_return(!connector.copyBlockToPreset(0, 0, 4, 1, 0, 0), false);
+        assert_return(!connector.moveBlockToPreset(0, 0, 4, 1, 0, 0), false);
+
+        // nothing changed
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        assert_return(connector.switchPreset(1), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 3), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 3), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test loading a preset sets up all instances and dual mono pairs with their saved state
+    bool testBatchedPresetLoad()
+    {
+        mod_log_info("testBatchedPresetLoad()");
+
         // load empty bank
         const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
             "1.json", // nonexisting
@@ -939,123 +1592,394 @@ class HostConnectorTests : public QObject
         };
         connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        assert_return(testPassthrough(), false);
+        // chain: stereo - dual params - dual params (disabled)
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 1, PARAMSBLOCK), false);
+        assert_return(connector.replaceBlock(0, 2, PARAMSBLOCK), false);
+        connector.setBlockParameter(0, 1, "gain", 0.3f);
+        connector.setBlockParameter(0, 2, "level", 2.f);
+        assert_return(connector.enableBlock(0, 2, false, HostConnector::SceneModeClear), false);
 
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testBatchedPresetLoad.json"), false);
 
-        // ***** New setup: stereo between sidechaining blocks on row 0
+        // reload through the preset file
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        // branch to sidechain
-        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
-        assert_return(testNoPassthrough(), false);
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
+            PRESETFILEPATH "/testBatchedPresetLoad.json",
+            {},
+            {},
+        };
+        connector.loadBankFromPresetFiles(bankPresets, 0);
 
-        // add stereo block on row 0
-        assert_return(connector.replaceBlock(0, 2, STEREOBLOCK), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        // check saved state, for both blocks of dual mono pairs
+        assert_return(connector.current.block(0, 1).enabled, false);
+        assert_return(!connector.current.block(0, 2).enabled, false);
+        assert_return(isEqual(blockParameterValue(0, 1, "gain"), 0.3f), false);
+        assert_return(isEqual(blockParameterValue(0, 2, "gain"), 0.5f), false);
+        assert_return(isEqual(blockParameterValue(0, 2, "level"), 2.f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 1), "gain"), 0.3f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 1), "gain"), 0.3f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 2), "level"), 2.f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 2), "level"), 2.f), false);
+
+        // check connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 1), blockPairPortIn1(0, 2)), false);
         assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
-        // row 1
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
-        // complete sidechain
-        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 4), blockPairPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 4), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn2(0, 4), blockPortOut2(0, 1)), false);
-        assert_return(testNoPassthrough(), false);
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        // save preset state to file
-        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder3.json"), false);
+        return true;
+    }
 
-        // remove sidein block (undo sidechain ending)
-        assert_return(connector.replaceBlock(0, 4, nullptr), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
-        assert_return(testNoPassthrough(), false);
+    // test presets loaded again after edits do not use stale cached load programs
+    bool testLoadProgramCache()
+    {
+        mod_log_info("testLoadProgramCache()");
 
-        // remove remaining stereo block
-        assert_return(connector.replaceBlock(0, 2, nullptr), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
-        assert_return(testNoPassthrough(), false);
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        // remove remaining block
-        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
+            PRESETFILEPATH "/testLoadProgramCache.json",
+            {},
+            {},
+        };
 
-        assert_return(testPassthrough(), false);
-        
-        // switch to an empty preset and back
-        assert_return(connector.switchPreset(1), false);
-        assert_return(testPassthrough(), false);
-        assert_return(connector.switchPreset(0), false);
+        const auto reloadAndCheckGain = [this, &bankPresets, &bankPresetsEmpty](const float gain) -> bool {
+            connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+            connector.loadBankFromPresetFiles(bankPresets, 0);
+            return isEqual(blockParameterValue(0, 0, "gain"), gain)
+                && isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 0), "gain"), gain)
+                && checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1);
+        };
 
-        // check connections are the same as before saving the file
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 4), blockPairPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 4), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn2(0, 4), blockPortOut2(0, 1)), false);
-        assert_return(testNoPassthrough(), false);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        connector.setBlockParameter(0, 0, "gain", 0.3f);
+        assert_return(connector.saveCurrentPresetToFile(bankPresets[0].c_str()), false);
+
+        // first load compiles the program, second one replays it
+        assert_return(reloadAndCheckGain(0.3f), false);
+        assert_return(reloadAndCheckGain(0.3f), false);
+
+        // edited and saved
+        connector.setBlockParameter(0, 0, "gain", 0.8f);
+        assert_return(connector.saveCurrentPresetToFile(bankPresets[0].c_str()), false);
+        assert_return(reloadAndCheckGain(0.8f), false);
+
+        // edited without saving, reloading goes back to the file contents
+        connector.setBlockParameter(0, 0, "gain", 0.1f);
+        assert_return(reloadAndCheckGain(0.8f), false);
+        assert_return(reloadAndCheckGain(0.8f), false);
+
+        // edited outside of this process, keeping the same uuid
+        {
+            const std::filesystem::path path(bankPresets[0]);
+            nlohmann::json j;
+            {
+                std::ifstream f(path);
+                j = nlohmann::json::parse(f);
+            }
+
+            const std::function<void(nlohmann::json&)> setGain = [&setGain](nlohmann::json& jobj) {
+                if (jobj.is_object() && jobj.contains("symbol") && jobj["symbol"] == "gain" && jobj.contains("value"))
+                    jobj["value"] = 0.2;
+
+                for (nlohmann::json& jchild : jobj)
+                    if (jchild.is_structured())
+                        setGain(jchild);
+            };
+            setGain(j);
+
+            std::ofstream(path) << j.dump();
+            std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+        }
+        assert_return(reloadAndCheckGain(0.2f), false);
+        assert_return(reloadAndCheckGain(0.2f), false);
 
         // load empty bank
         connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        assert_return(testPassthrough(), false);
-
+        return true;
+    }
 
-        // ***** New setup: stereo between sidechaining blocks on both rows
+    // test the active preset is audible first, with the rest of the bank loaded during host updates
+    bool testBankLoadTimings()
+    {
+        mod_log_info("testBankLoadTimings()");
 
-        // branch to sidechain
-        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
-        assert_return(testNoPassthrough(), false);
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
+            PRESETFILEPATH "/testSingleMonoChain.json",
+            PRESETFILEPATH "/testSingleStereoChain.json",
+            PRESETFILEPATH "/testBatchedPresetLoad.json",
+        };
+        connector.loadBankFromPresetFiles(bankPresets, 0);
+
+        // other presets are still pending
+        const HostConnector::BankLoadTimings& timings = connector.getLastBankLoadTimings();
+        assert_return(timings.fullyLoaded == 0, false);
 
-        // add back on both rows
-        assert_return(connector.replaceBlock(0, 2, STEREOBLOCK), false);
-        assert_return(connector.replaceBlock(1, 2, STEREOBLOCK), false);
-        // row 0
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // the rest of the bank is loaded during host updates
+        runHostUpdates(500);
+        assert_return(timings.fullyLoaded != 0, false);
+        assert_return(timings.fullyLoaded >= timings.firstSound, false);
+
+        // check background loaded preset
+        assert_return(connector.switchPreset(2), false);
+        assert_return(isEqual(blockParameterValue(0, 1, "gain"), 0.3f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 1), "gain"), 0.3f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 1), "gain"), 0.3f), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 1)), false);
         assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
-        // row 1
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test connections use the right port names when instance ids go to blocks of other plugins
+    bool testPortNameCache()
+    {
+        mod_log_info("testPortNameCache()");
+
+        // load empty bank
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        // do not keep spare instances, so ids of removed blocks are free right away
+        connector.setInstancePoolBudget(0);
+
+        // chain: mono
+        assert_return(connector.replaceBlock(0, 0, MONOBLOCK), false);
+        const std::string blockId = connector.getBlockIdNoPair(0, 0);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+
+        // chain becomes: stereo, on the same instance id
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(connector.getBlockIdNoPair(0, 0) == blockId, false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 0), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // chain becomes: mono, on the same instance id again
+        assert_return(connector.replaceBlock(0, 0, MONOBLOCK), false);
+        assert_return(connector.getBlockIdNoPair(0, 0) == blockId, false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // spare instances keep their port names when reused
+        connector.setInstancePoolBudget(MAX_SPARE_PLUGIN_INSTANCES);
+
+        // chain becomes: empty - mono, using the spare instance of the removed block
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 1, MONOBLOCK), false);
+        assert_return(connector.getBlockIdNoPair(0, 1) == blockId, false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test a bank using the same plugins as the previous one keeps their instances, with the new values
+    bool testInstanceReuseAcrossBanks()
+    {
+        mod_log_info("testInstanceReuseAcrossBanks()");
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets1 = {
+            PRESETFILEPATH "/testBatchedPresetLoad.json",
+            {},
+            {},
+        };
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets2 = {
+            PRESETFILEPATH "/testInstanceReuseAcrossBanks.json",
+            {},
+            {},
+        };
+
+        // save a copy of the first bank preset with a different value
+        connector.loadBankFromPresetFiles(bankPresets1, 0);
+        connector.setBlockParameter(0, 1, "gain", 0.8f);
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testInstanceReuseAcrossBanks.json"), false);
+
+        // chain: stereo - dual params - dual params (disabled)
+        connector.loadBankFromPresetFiles(bankPresets1, 0);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 1), "gain"), 0.3f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 1), "gain"), 0.3f), false);
+        runHostUpdates(500);
+
+        // jack reports port changes asynchronously
+        QThread::msleep(200);
+        const uint numUnregistrationsBefore = numJackPortUnregistrations;
+
+        // change to a bank with the same plugins, no instances are removed
+        connector.loadBankFromPresetFiles(bankPresets2, 0);
+        QThread::msleep(200);
+        assert_return(numJackPortUnregistrations == numUnregistrationsBefore, false);
+
+        // reused instances have the values of the new bank
+        assert_return(isEqual(blockParameterValue(0, 1, "gain"), 0.8f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 1), "gain"), 0.8f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 1), "gain"), 0.8f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 2), "level"), 2.f), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdPairOnly(0, 2), "level"), 2.f), false);
+        assert_return(!connector.current.block(0, 2).enabled, false);
+
+        // check connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 1), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test spare instances are reused in their default state, and removed when over the pool budget
+    bool testInstancePool()
+    {
+        mod_log_info("testInstancePool()");
+
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        const std::string blockId = connector.getBlockIdNoPair(0, 0);
+        connector.setBlockParameter(0, 0, "gain", 0.9f);
+        connector.setBlockParameter(0, 0, "level", 9.f);
+        assert_return(isEqual(hostParameterValue(blockId, "gain"), 0.9f), false);
+
+        // jack reports port changes asynchronously
+        QThread::msleep(200);
+        uint numUnregistrations = numJackPortUnregistrations;
+
+        // removed block is kept as spare, and reused for the same plugin with none of its previous values
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        QThread::msleep(200);
+        assert_return(numJackPortUnregistrations == numUnregistrations, false);
+        assert_return(connector.getBlockIdNoPair(0, 0) == blockId, false);
+        assert_return(isEqual(blockParameterValue(0, 0, "gain"), 0.5f), false);
+        assert_return(isEqual(hostParameterValue(blockId, "gain"), 0.5f), false);
+        assert_return(isEqual(hostParameterValue(blockId, "level"), 5.f), false);
+
+        // no spares are kept without budget
+        connector.setInstancePoolBudget(0);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        QThread::msleep(200);
+        assert_return(numJackPortUnregistrations > numUnregistrations, false);
+        numUnregistrations = numJackPortUnregistrations;
+
+        // lowering the budget evicts existing spares
+        connector.setInstancePoolBudget(MAX_SPARE_PLUGIN_INSTANCES);
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        QThread::msleep(200);
+        assert_return(numJackPortUnregistrations == numUnregistrations, false);
+
+        connector.setInstancePoolBudget(0);
+        QThread::msleep(200);
+        assert_return(numJackPortUnregistrations > numUnregistrations, false);
+
+        connector.setInstancePoolBudget(MAX_SPARE_PLUGIN_INSTANCES);
+        return true;
+    }
+
+    // test building 2-row (sidechain) setup from left to right (and dismantling right to left)
+    bool testSideChainBuiltInOrder()
+    {
+        mod_log_info("testSideChainBuiltInOrder()");
+
+        // branch to sidechain
+        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(testNoPassthrough(), false);
+
+        // add a block on non-finished sidechain
+        assert_return(connector.replaceBlock(1, 2, MONOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
+        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // complete sidechain
+        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // save preset state to file
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder1.json"), false);
+
+        // remove sidein block (undo sidechain ending)
+        assert_return(connector.replaceBlock(0, 4, nullptr), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
+        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // replace sidechain block with a stereo one
+        assert_return(connector.replaceBlock(1, 2, STEREOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
         assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
         assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
@@ -1067,11 +1991,9 @@ class HostConnectorTests : public QObject
         assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
         // row 0 connections
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
         assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
         assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
         // row 1 connections
@@ -1083,18 +2005,12 @@ class HostConnectorTests : public QObject
         assert_return(testNoPassthrough(), false);
 
         // save preset state to file
-        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder4.json"), false);
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder2.json"), false);
 
-        // remove sidechain completion
+        // remove sidein block (undo sidechain ending)
         assert_return(connector.replaceBlock(0, 4, nullptr), false);
-        // row 0
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
-        // row 1
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
         assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
         assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
         assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
@@ -1102,9 +2018,15 @@ class HostConnectorTests : public QObject
         assert_return(checkNoConnections(blockPortOut2(1, 2)), false);
         assert_return(testNoPassthrough(), false);
 
-        // remove remaining blocks
+        // remove stereo block from sidechain
         assert_return(connector.replaceBlock(1, 2, nullptr), false);
-        assert_return(connector.replaceBlock(0, 2, nullptr), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(testNoPassthrough(), false);
+
+        // remove remaining block
         assert_return(connector.replaceBlock(0, 1, nullptr), false);
 
         assert_return(testPassthrough(), false);
@@ -1117,11 +2039,9 @@ class HostConnectorTests : public QObject
         // check connections are the same as before saving the file
         // row 0 connections
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
         assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
         assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
         // row 1 connections
@@ -1133,48 +2053,249 @@ class HostConnectorTests : public QObject
         assert_return(testNoPassthrough(), false);
 
         // load empty bank
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
         connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
         assert_return(testPassthrough(), false);
 
 
-        // ***** test loading all previously saved presets from file
-
-        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets1 = {
-            PRESETFILEPATH "/testSideChainBuiltInOrder1.json",
-            PRESETFILEPATH "/testSideChainBuiltInOrder2.json",
-            PRESETFILEPATH "/testSideChainBuiltInOrder3.json",
-        };
-        // load bank and first preset on it
-        connector.loadBankFromPresetFiles(bankPresets1, 0);
+        // ***** New setup: stereo between sidechaining blocks on row 0
 
-        // file 1: check connections are the same as before saving the file
-        // row 0 connections
+        // branch to sidechain
+        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
         assert_return(testNoPassthrough(), false);
 
-        // disable and re-enable processing
-        connector.enableAudioProcessing(false);
-        connector.enableAudioProcessing(true);
-
-        // file 1: check connections again
-        // row 0 connections
+        // add stereo block on row 0
+        assert_return(connector.replaceBlock(0, 2, STEREOBLOCK), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
+        // row 1
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
         assert_return(testNoPassthrough(), false);
 
-
-        // file 2: switch to preset
-        assert_return(connector.switchPreset(1), false);
+        // complete sidechain
+        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 4), blockPairPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 4), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn2(0, 4), blockPortOut2(0, 1)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // save preset state to file
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder3.json"), false);
+
+        // remove sidein block (undo sidechain ending)
+        assert_return(connector.replaceBlock(0, 4, nullptr), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(testNoPassthrough(), false);
+
+        // remove remaining stereo block
+        assert_return(connector.replaceBlock(0, 2, nullptr), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(testNoPassthrough(), false);
+
+        // remove remaining block
+        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+
+        assert_return(testPassthrough(), false);
+        
+        // switch to an empty preset and back
+        assert_return(connector.switchPreset(1), false);
+        assert_return(testPassthrough(), false);
+        assert_return(connector.switchPreset(0), false);
+
+        // check connections are the same as before saving the file
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 4), blockPairPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 4), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn2(0, 4), blockPortOut2(0, 1)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        assert_return(testPassthrough(), false);
+
+
+        // ***** New setup: stereo between sidechaining blocks on both rows
+
+        // branch to sidechain
+        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(blockPortOut2(0, 1)), false); // no sidechain
+        assert_return(testNoPassthrough(), false);
+
+        // add back on both rows
+        assert_return(connector.replaceBlock(0, 2, STEREOBLOCK), false);
+        assert_return(connector.replaceBlock(1, 2, STEREOBLOCK), false);
+        // row 0
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
+        // row 1
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
+        assert_return(checkNoConnections(blockPortOut2(1, 2)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // complete sidechain
+        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // save preset state to file
+        assert_return(connector.saveCurrentPresetToFile(PRESETFILEPATH "/testSideChainBuiltInOrder4.json"), false);
+
+        // remove sidechain completion
+        assert_return(connector.replaceBlock(0, 4, nullptr), false);
+        // row 0
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
+        // row 1
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkNoConnections(blockPortOut1(1, 2)), false);
+        assert_return(checkNoConnections(blockPortOut2(1, 2)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // remove remaining blocks
+        assert_return(connector.replaceBlock(1, 2, nullptr), false);
+        assert_return(connector.replaceBlock(0, 2, nullptr), false);
+        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+
+        assert_return(testPassthrough(), false);
+        
+        // switch to an empty preset and back
+        assert_return(connector.switchPreset(1), false);
+        assert_return(testPassthrough(), false);
+        assert_return(connector.switchPreset(0), false);
+
+        // check connections are the same as before saving the file
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        assert_return(testPassthrough(), false);
+
+
+        // ***** test loading all previously saved presets from file
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets1 = {
+            PRESETFILEPATH "/testSideChainBuiltInOrder1.json",
+            PRESETFILEPATH "/testSideChainBuiltInOrder2.json",
+            PRESETFILEPATH "/testSideChainBuiltInOrder3.json",
+        };
+        // load bank and first preset on it
+        connector.loadBankFromPresetFiles(bankPresets1, 0);
+
+        // file 1: check connections are the same as before saving the file
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // disable and re-enable processing
+        connector.enableAudioProcessing(false);
+        connector.enableAudioProcessing(true);
+
+        // file 1: check connections again
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 4)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn1(1, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+
+        // file 2: switch to preset
+        assert_return(connector.switchPreset(1), false);
         // file 2: check connections are the same as before saving the file
         // row 0 connections
         assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
@@ -1529,29 +2650,562 @@ class HostConnectorTests : public QObject
         assert_return(connector.replaceBlock(0, 4, nullptr), false);
         assert_return(connector.replaceBlock(0, 1, nullptr), false);
 
-        assert_return(testPassthrough(), false);
+        assert_return(testPassthrough(), false);
+
+        // switch to an empty preset and back
+        assert_return(connector.switchPreset(1), false);
+        assert_return(testPassthrough(), false);
+        assert_return(connector.switchPreset(0), false);
+
+        // check that connections returned to the saved state
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        // test pass-through
+        assert_return(testPassthrough(), false);
+
+        // test loading from file
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
+            PRESETFILEPATH "/testSideChainMoveStereoOnFirstRow1.json",
+            {},
+            {},
+        };
+        connector.loadBankFromPresetFiles(bankPresets, 0);
+
+        // file 1: check connections are the same as before saving the file
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // disable and re-enable processing
+        connector.enableAudioProcessing(false);
+        connector.enableAudioProcessing(true);
+
+        // check connections again
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test moving a stereo block around on both rows of a 2-row setup
+    bool testSideChainSwapBlockRows()
+    {
+        mod_log_info("testSideChainSwapBlockRows()");
+
+        // NOTE: swapBlockRow is called here for blocks at the end of the two rows,
+        // meaning that block is first moved to the end, row swapped and then moved to destination index
+
+        // create sidechain (these actions tested in testPluginLoad())
+        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
+        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
+        // add stereo block to end
+        assert_return(connector.replaceBlock(0, 5, STEREOBLOCK), false);
+        // connections of this starting point checked in testSideChainMoveStereoOnFirstRow()
+
+        // move stereo block in between sidechaining blocks on row 1
+        assert_return(connector.swapBlockRow(0, 5, 1, 5), false);
+        assert_return(connector.reorderBlock(1, 5, 2), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // move stereo block to beginning on row 0
+        assert_return(connector.reorderBlock(1, 2, 5), false);
+        assert_return(connector.swapBlockRow(1, 5, 0, 5), false);
+        assert_return(connector.reorderBlock(0, 5, 0), false);
+        // SIDEOUTBLOCK 1 becomes block 2
+        // SIDEINBLOCK 4 becomes block 5
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // move stereo block back to where it was on row 1
+        assert_return(connector.reorderBlock(0, 0, 5), false);
+        assert_return(connector.swapBlockRow(0, 5, 1, 5), false);
+        assert_return(connector.reorderBlock(1, 5, 2), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // move stereo block to row 0 between the sidechaining blocks
+        assert_return(connector.reorderBlock(1, 2, 5), false);
+        assert_return(connector.swapBlockRow(1, 5, 0, 5), false);
+        assert_return(connector.reorderBlock(0, 5, 3), false);
+        // row 0 connections
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 3), blockPortIn2(0, 3)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 3), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 3), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 3), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 3), blockPairPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
+        // row 1 connections
+        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 5), blockPairPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 5), blockPortOut2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPairPortIn2(0, 5), blockPortOut2(0, 1)), false);
+        assert_return(testNoPassthrough(), false);
+
+        // remove all blocks
+        assert_return(connector.replaceBlock(0, 5, nullptr), false);
+        assert_return(connector.replaceBlock(0, 3, nullptr), false);
+        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+
+        return true;
+    }
+
+    bool testSideChain()
+    {
+        mod_log_info("testSideChain()");
+
+        // NOTE: even though this test set is extensive, it doesn't include every possible scenario
+        // focus is on issues that have appeared earlier in development
+
+        // NOTE: many of the connection checks in between actions are the same within one test
+        // and between test functions but the steps to get there are different
+
+        assert_return(testSideChainBuiltInOrder(), false);
+        assert_return(testPassthrough(), false);
+
+        assert_return(testSideChainAddStereoInBetween(), false);
+        assert_return(testPassthrough(), false);
+
+        assert_return(testSideChainMoveStereoOnFirstRow(), false);
+        assert_return(testPassthrough(), false);
+
+        assert_return(testSideChainSwapBlockRows(), false);
+        assert_return(testPassthrough(), false);
+
+        return true;
+    }
+
+    // test adding and removing dual mono pairs through replace, reorder and remove
+    bool testConnectionGraphDualMono()
+    {
+        mod_log_info("testConnectionGraphDualMono()");
+
+        // chain: stereo - dual mono - dual mono
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 1, MONOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 2, MONOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 1), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // replace stereo block with a mono one, the following blocks lose their pairs
+        // chain becomes: mono - mono - mono
+        assert_return(connector.replaceBlock(0, 0, MONOBLOCK), false);
+        assert_return(connector.getBlockIdPairOnly(0, 1).empty(), false);
+        assert_return(connector.getBlockIdPairOnly(0, 2).empty(), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // replace first block with a stereo one again, the pairs come back
+        // chain becomes: stereo - dual mono - dual mono
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 1), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // move stereo block last, the mono blocks lose their pairs
+        // chain becomes: mono - mono - stereo
+        assert_return(connector.reorderBlock(0, 0, 2), false);
+        assert_return(connector.getBlockIdPairOnly(0, 0).empty(), false);
+        assert_return(connector.getBlockIdPairOnly(0, 1).empty(), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 2), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 2), blockPortOut1(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // move stereo block to the middle, the last block gets a pair
+        // chain becomes: mono - stereo - dual mono
+        assert_return(connector.reorderBlock(0, 2, 1), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), blockPortIn1(0, 1), blockPortIn2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPairPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPairPortOut1(0, 2), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // remove stereo block, the last block loses its pair
+        // chain becomes: mono - empty - mono
+        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+        assert_return(connector.getBlockIdPairOnly(0, 2).empty(), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 2), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // remove remaining blocks
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.replaceBlock(0, 2, nullptr), false);
+
+        return true;
+    }
+
+    // test that switching presets only changes the connections that differ between them
+    bool testConnectionGraphPresetSwitch()
+    {
+        mod_log_info("testConnectionGraphPresetSwitch()");
+
+        // both presets are empty, pass-through connections are shared between them
+        assert_return(testPassthrough(), false);
+
+        uint numDisconnectionsBefore = numJackDisconnections;
+        assert_return(connector.switchPreset(1), false);
+        assert_return(testPassthrough(), false);
+        // jack reports connection changes asynchronously
+        QThread::msleep(200);
+        assert_return(numJackDisconnections == numDisconnectionsBefore, false);
+
+        // add a block, pass-through connections are replaced
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1), false);
+        assert_return(testNoPassthrough(), false);
+
+        // switching to an empty preset removes all block connections
+        const std::string oldPortIn1 = blockPortIn1(0, 0);
+        const std::string oldPortOut1 = blockPortOut1(0, 0);
+        assert_return(connector.switchPreset(0), false);
+        assert_return(testPassthrough(), false);
+        assert_return(checkNoConnections(oldPortIn1), false);
+        assert_return(checkNoConnections(oldPortOut1), false);
+
+        // switching back brings them back
+        assert_return(connector.switchPreset(1), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 0), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // remove block and go back to the first preset, again without touching pass-through connections
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(testPassthrough(), false);
+
+        numDisconnectionsBefore = numJackDisconnections;
+        assert_return(connector.switchPreset(0), false);
+        assert_return(testPassthrough(), false);
+        QThread::msleep(200);
+        assert_return(numJackDisconnections == numDisconnectionsBefore, false);
+
+        return true;
+    }
+
+    bool testConnectionGraph()
+    {
+        mod_log_info("testConnectionGraph()");
+
+        assert_return(testConnectionGraphDualMono(), false);
+        assert_return(testPassthrough(), false);
+
+        assert_return(testConnectionGraphPresetSwitch(), false);
+        assert_return(testPassthrough(), false);
+
+        return true;
+    }
+
+    // test preparing a bank while another one plays, then switching to it
+    bool testPreparedBank()
+    {
+        mod_log_info("testPreparedBank()");
+
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
+
+        // start from the saved mono chain
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets1 = {
+            PRESETFILEPATH "/testSingleMonoChain.json",
+            {},
+            {},
+        };
+        connector.loadBankFromPresetFiles(bankPresets1, 0);
+
+        const std::string oldPortIn1 = blockPortIn1(0, 1);
+        const std::string oldPortOut1 = blockPortOut1(0, 5);
+        assert_return(checkOnlyConnection(oldPortIn1, JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(oldPortOut1, JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+
+        // prepare a bank starting with the saved stereo chain, current bank keeps playing as-is
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets2 = {
+            PRESETFILEPATH "/testSingleMonoChain.json",
+            PRESETFILEPATH "/testSingleStereoChain.json",
+            {},
+        };
+        assert_return(connector.prepareBankFromPresetFiles(bankPresets2), false);
+
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 4), blockPortIn1(0, 5)), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1, JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // switch to the prepared bank, starting with the stereo chain
+        connector.loadBankFromPresetFiles(bankPresets2, 1);
+
+        // check connections are the same as before saving the file
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnly2Connections(blockPortOut1(0, 0), blockPortIn1(0, 1), blockPortIn2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 1), blockPortOut1(0, 0)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 1), blockPortIn1(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 1), blockPortIn2(0, 2)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 3)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPairPortIn1(0, 3)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 3), blockPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 3), blockPairPortIn1(0, 4)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 4), blockPortIn1(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 4), blockPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 5), JACK_PLAYBACK_PORT_2), false);
+        assert_return(testNoPassthrough(), false);
+
+        // instances of the previous bank are silent, and removed during host updates
+        assert_return(checkNoConnections(oldPortIn1), false);
+        assert_return(checkNoConnections(oldPortOut1), false);
+
+        runHostUpdates(1000);
+        assert_return(!checkPortExists(oldPortIn1), false);
+        assert_return(!checkPortExists(oldPortOut1), false);
+
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
+
+        return true;
+    }
+
+    // test connections of the active preset going through a mixer tool, across preset switches
+    bool testPresetSwitchCrossfade()
+    {
+        mod_log_info("testPresetSwitchCrossfade()");
+
+        const std::string mixerInA1 = toolPort(1, "in_a_1");
+        const std::string mixerInA2 = toolPort(1, "in_a_2");
+        const std::string mixerInB1 = toolPort(1, "in_b_1");
+        const std::string mixerInB2 = toolPort(1, "in_b_2");
+        const std::string mixerOut1 = toolPort(1, "out1");
+        const std::string mixerOut2 = toolPort(1, "out2");
+
+        assert_return(connector.enableTool(1, MIXERBLOCK), false);
+        assert_return(connector.setPresetSwitchCrossfadeTool(1, "mix",
+                                                             "in_a_1", "in_a_2", "in_b_1", "in_b_2",
+                                                             "out1", "out2"), false);
+        connector.setPresetSwitchCrossfadeTime(400);
+
+        // empty preset goes into mixer inputs A, mixer goes to playback
+        assert_return(checkOnlyConnection(mixerInA1, JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(mixerInA2, JACK_CAPTURE_PORT_2), false);
+        assert_return(checkNoConnections(mixerInB1), false);
+        assert_return(checkNoConnections(mixerInB2), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut1, JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut2, JACK_PLAYBACK_PORT_2), false);
+
+        // add block, its outputs go into mixer inputs A
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), mixerInA1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), mixerInA2), false);
+        assert_return(checkNoConnections(mixerInB1), false);
+        assert_return(checkNoConnections(mixerInB2), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut1, JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut2, JACK_PLAYBACK_PORT_2), false);
+
+        // switch to empty preset, which goes into mixer inputs B
+        const std::string oldPortIn1 = blockPortIn1(0, 0);
+        const std::string oldPortIn2 = blockPortIn2(0, 0);
+        const std::string oldPortOut1 = blockPortOut1(0, 0);
+        const std::string oldPortOut2 = blockPortOut2(0, 0);
+        const std::string mixerId = format(MOD_HOST_EFFECT_PREFIX "%d", MAX_MOD_HOST_PLUGIN_INSTANCES + 1);
+        assert_return(isEqual(hostParameterValue(mixerId, "mix"), 0.f), false);
+
+        // switching does not wait for the crossfade, previous preset keeps playing into mixer inputs A
+        const std::chrono::steady_clock::time_point switchStart = std::chrono::steady_clock::now();
+        assert_return(connector.switchPreset(1), false);
+        assert_return(std::chrono::steady_clock::now() - switchStart < std::chrono::milliseconds(400), false);
+        assert_return(checkOnlyConnectionBothWays(oldPortOut1, mixerInA1), false);
+        assert_return(checkOnlyConnectionBothWays(oldPortOut2, mixerInA2), false);
+        assert_return(checkOnlyConnection(mixerInB1, JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(mixerInB2, JACK_CAPTURE_PORT_2), false);
+
+        // mixer moves towards inputs B during host updates
+        runHostUpdates(200);
+        const float mix = hostParameterValue(mixerId, "mix");
+        assert_return(mix > 0.f && mix < 1.f, false);
+        assert_return(checkOnlyConnectionBothWays(oldPortOut1, mixerInA1), false);
+
+        // previous preset is disconnected once the crossfade is over
+        runHostUpdates(400);
+        assert_return(isEqual(hostParameterValue(mixerId, "mix"), 1.f), false);
+        assert_return(checkNoConnections(oldPortIn1), false);
+        assert_return(checkNoConnections(oldPortIn2), false);
+        assert_return(checkNoConnections(oldPortOut1), false);
+        assert_return(checkNoConnections(oldPortOut2), false);
+        assert_return(checkNoConnections(mixerInA1), false);
+        assert_return(checkNoConnections(mixerInA2), false);
+        assert_return(checkOnlyConnection(mixerInB1, JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(mixerInB2, JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut1, JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut2, JACK_PLAYBACK_PORT_2), false);
+
+        // add block, its outputs go into mixer inputs B
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), mixerInB1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), mixerInB2), false);
+        assert_return(checkNoConnections(mixerInA1), false);
+        assert_return(checkNoConnections(mixerInA2), false);
 
-        // switch to an empty preset and back
+        // switch back, first preset goes into mixer inputs A again
+        // switching again during a crossfade finishes it right away
+        assert_return(connector.switchPreset(0), false);
         assert_return(connector.switchPreset(1), false);
-        assert_return(testPassthrough(), false);
+        assert_return(isEqual(hostParameterValue(mixerId, "mix"), 0.f), false);
         assert_return(connector.switchPreset(0), false);
-
-        // check that connections returned to the saved state
-        // row 0 connections
+        assert_return(isEqual(hostParameterValue(mixerId, "mix"), 1.f), false);
+        runHostUpdates(600);
+        assert_return(isEqual(hostParameterValue(mixerId, "mix"), 0.f), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
         assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
-        assert_return(testNoPassthrough(), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), mixerInA1), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), mixerInA2), false);
+        assert_return(checkNoConnections(mixerInB1), false);
+        assert_return(checkNoConnections(mixerInB2), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut1, JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnectionBothWays(mixerOut2, JACK_PLAYBACK_PORT_2), false);
+
+        // stop using the mixer, active preset goes directly to playback
+        assert_return(connector.setPresetSwitchCrossfadeTool(1, nullptr,
+                                                             nullptr, nullptr, nullptr, nullptr,
+                                                             nullptr, nullptr), false);
+        connector.setPresetSwitchCrossfadeTime(0);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 0), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 0), JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkNoConnections(mixerInA1), false);
+        assert_return(checkNoConnections(mixerInA2), false);
+        assert_return(checkNoConnections(mixerOut1), false);
+        assert_return(checkNoConnections(mixerOut2), false);
+        assert_return(connector.enableTool(1, nullptr), false);
 
-        // load empty bank
+        // remove blocks from both presets
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.switchPreset(1), false);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        assert_return(connector.switchPreset(0), false);
+
+        return true;
+    }
+
+    // test delay blocks of the previous preset going straight to playback for a while after a preset switch
+    bool testPresetSwitchSpillover()
+    {
+        mod_log_info("testPresetSwitchSpillover()");
+
+        // load empty bank, so no spare instances are taking up the budget for ringing blocks
         const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
             "1.json", // nonexisting
             "2.json", // nonexisting
@@ -1559,177 +3213,242 @@ class HostConnectorTests : public QObject
         };
         connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
-        // test pass-through
-        assert_return(testPassthrough(), false);
+        connector.setPresetSwitchSpilloverTime(500);
 
-        // test loading from file
-        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
-            PRESETFILEPATH "/testSideChainMoveStereoOnFirstRow1.json",
-            {},
-            {},
-        };
-        connector.loadBankFromPresetFiles(bankPresets, 0);
+        // chain: stereo - delay
+        assert_return(connector.replaceBlock(0, 0, STEREOBLOCK), false);
+        assert_return(connector.replaceBlock(0, 1, DELAYBLOCK), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPortIn2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 1), JACK_PLAYBACK_PORT_2), false);
 
-        // file 1: check connections are the same as before saving the file
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
-        assert_return(testNoPassthrough(), false);
+        const std::string stereoPortIn1 = blockPortIn1(0, 0);
+        const std::string stereoPortOut1 = blockPortOut1(0, 0);
+        const std::string delayPortIn1 = blockPortIn1(0, 1);
+        const std::string delayPortIn2 = blockPortIn2(0, 1);
+        const std::string delayPortOut1 = blockPortOut1(0, 1);
+        const std::string delayPortOut2 = blockPortOut2(0, 1);
 
-        // disable and re-enable processing
-        connector.enableAudioProcessing(false);
-        connector.enableAudioProcessing(true);
+        // switch to empty preset, delay block keeps ringing into playback without input
+        assert_return(connector.switchPreset(1), false);
+        assert_return(checkNoConnections(stereoPortIn1), false);
+        assert_return(checkNoConnections(stereoPortOut1), false);
+        assert_return(checkNoConnections(delayPortIn1), false);
+        assert_return(checkNoConnections(delayPortIn2), false);
+        assert_return(checkOnlyConnection(delayPortOut1, JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(delayPortOut2, JACK_PLAYBACK_PORT_2), false);
+        assert_return(checkOnly2Connections(JACK_PLAYBACK_PORT_1, JACK_CAPTURE_PORT_1, delayPortOut1.c_str()), false);
+        assert_return(checkOnly2Connections(JACK_PLAYBACK_PORT_2, JACK_CAPTURE_PORT_2, delayPortOut2.c_str()), false);
+
+        // delay block is cut once spillover time is over
+        runHostUpdates(1000);
+        assert_return(checkNoConnections(delayPortOut1), false);
+        assert_return(checkNoConnections(delayPortOut2), false);
+        assert_return(testPassthrough(), false);
 
-        // check connections again
-        // row 0 connections
+        // switch back, chain is the same as before
+        assert_return(connector.switchPreset(0), false);
         assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
         assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 1)), false);
+        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPortIn2(0, 1)), false);
+        assert_return(checkOnlyConnection(blockPortOut1(0, 1), JACK_PLAYBACK_PORT_1), false);
+        assert_return(checkOnlyConnection(blockPortOut2(0, 1), JACK_PLAYBACK_PORT_2), false);
         assert_return(testNoPassthrough(), false);
 
+        connector.setPresetSwitchSpilloverTime(0);
+
         // load empty bank
         connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
         return true;
     }
 
-    // test moving a stereo block around on both rows of a 2-row setup
-    bool testSideChainSwapBlockRows()
+    // test rapid preset switch requests are coalesced into a single switch
+    bool testPresetSwitchRequests()
     {
-        mod_log_info("testSideChainSwapBlockRows()");
-
-        // NOTE: swapBlockRow is called here for blocks at the end of the two rows,
-        // meaning that block is first moved to the end, row swapped and then moved to destination index
+        mod_log_info("testPresetSwitchRequests()");
 
-        // create sidechain (these actions tested in testPluginLoad())
-        assert_return(connector.replaceBlock(0, 1, SIDEOUTBLOCK), false);
-        assert_return(connector.replaceBlock(0, 4, SIDEINBLOCK), false);
-        // add stereo block to end
-        assert_return(connector.replaceBlock(0, 5, STEREOBLOCK), false);
-        // connections of this starting point checked in testSideChainMoveStereoOnFirstRow()
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresets = {
+            PRESETFILEPATH "/testBatchedPresetLoad.json",
+            PRESETFILEPATH "/testSingleStereoChain.json",
+            PRESETFILEPATH "/testInstanceReuseAcrossBanks.json",
+        };
 
-        // move stereo block in between sidechaining blocks on row 1
-        assert_return(connector.swapBlockRow(0, 5, 1, 5), false);
-        assert_return(connector.reorderBlock(1, 5, 2), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
-        assert_return(testNoPassthrough(), false);
+        const std::array<std::string, NUM_PRESETS_PER_BANK> bankPresetsEmpty = {
+            "1.json", // nonexisting
+            "2.json", // nonexisting
+            "3.json", // nonexisting
+        };
 
-        // move stereo block to beginning on row 0
-        assert_return(connector.reorderBlock(1, 2, 5), false);
-        assert_return(connector.swapBlockRow(1, 5, 0, 5), false);
-        assert_return(connector.reorderBlock(0, 5, 0), false);
-        // SIDEOUTBLOCK 1 becomes block 2
-        // SIDEINBLOCK 4 becomes block 5
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 0), JACK_CAPTURE_PORT_2), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 0), blockPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 0), blockPairPortIn1(0, 2)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 2), blockPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut1(0, 2), blockPairPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 2), blockPortIn2(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPairPortOut2(0, 2), blockPairPortIn2(0, 5)), false);
-        assert_return(testNoPassthrough(), false);
+        connector.loadBankFromPresetFiles(bankPresets, 0);
+        runHostUpdates(1000);
 
-        // move stereo block back to where it was on row 1
-        assert_return(connector.reorderBlock(0, 0, 5), false);
-        assert_return(connector.swapBlockRow(0, 5, 1, 5), false);
-        assert_return(connector.reorderBlock(1, 5, 2), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 4), blockPairPortIn1(0, 4)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn1(0, 4), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 4), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 4), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn1(1, 2), blockPortIn2(1, 2)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(1, 2), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(1, 2), blockPortIn2(0, 4)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(1, 2), blockPairPortIn2(0, 4)), false);
-        assert_return(testNoPassthrough(), false);
+        // reference cost of a single switch, in jack disconnections
+        QThread::msleep(200);
+        uint numDisconnectionsBefore = numJackDisconnections;
+        assert_return(connector.switchPreset(1), false);
+        QThread::msleep(200);
+        const uint numDisconnectionsSingleSwitch = numJackDisconnections - numDisconnectionsBefore;
+        assert_return(numDisconnectionsSingleSwitch != 0, false);
 
-        // move stereo block to row 0 between the sidechaining blocks
-        assert_return(connector.reorderBlock(1, 2, 5), false);
-        assert_return(connector.swapBlockRow(1, 5, 0, 5), false);
-        assert_return(connector.reorderBlock(0, 5, 3), false);
-        // row 0 connections
-        assert_return(checkOnlyConnection(blockPortIn1(0, 1), JACK_CAPTURE_PORT_1), false);
-        assert_return(checkOnly2Connections(blockPortOut1(0, 1), blockPortIn1(0, 3), blockPortIn2(0, 3)), false);
-        assert_return(checkOnlyConnection(blockPortIn1(0, 3), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 3), blockPortOut1(0, 1)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut1(0, 3), blockPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnectionBothWays(blockPortOut2(0, 3), blockPairPortIn1(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortOut1(0, 5), JACK_PLAYBACK_PORT_1), false);
-        assert_return(checkOnlyConnection(blockPairPortOut1(0, 5), JACK_PLAYBACK_PORT_2), false);
-        // row 1 connections
-        assert_return(checkOnly2Connections(blockPortOut2(0, 1), blockPortIn2(0, 5), blockPairPortIn2(0, 5)), false);
-        assert_return(checkOnlyConnection(blockPortIn2(0, 5), blockPortOut2(0, 1)), false);
-        assert_return(checkOnlyConnection(blockPairPortIn2(0, 5), blockPortOut2(0, 1)), false);
-        assert_return(testNoPassthrough(), false);
+        assert_return(connector.switchPreset(0), false);
+        runHostUpdates(1000);
+
+        // scrolling through 5 presets before the next poll does a single switch to the last one,
+        // the presets scrolled over are never switched to
+        QThread::msleep(200);
+        numDisconnectionsBefore = numJackDisconnections;
+        connector.requestSwitchPreset(1);
+        connector.requestSwitchPreset(2);
+        connector.requestSwitchPreset(1);
+        connector.requestSwitchPreset(2);
+        connector.requestSwitchPreset(1);
+        connector.pollHostUpdates(nullptr);
+        QThread::msleep(200);
+        assert_return(connector.current.preset == 1, false);
+        assert_return(numJackDisconnections - numDisconnectionsBefore <= numDisconnectionsSingleSwitch, false);
+
+        // nothing left to do on the next poll
+        numDisconnectionsBefore = numJackDisconnections;
+        connector.pollHostUpdates(nullptr);
+        QThread::msleep(200);
+        assert_return(connector.current.preset == 1, false);
+        assert_return(numJackDisconnections == numDisconnectionsBefore, false);
+
+        // a direct switch drops pending requests
+        connector.requestSwitchPreset(2);
+        assert_return(connector.switchPreset(0), false);
+        connector.pollHostUpdates(nullptr);
+        assert_return(connector.current.preset == 0, false);
 
-        // remove all blocks
-        assert_return(connector.replaceBlock(0, 5, nullptr), false);
-        assert_return(connector.replaceBlock(0, 3, nullptr), false);
-        assert_return(connector.replaceBlock(0, 1, nullptr), false);
+        // load empty bank
+        connector.loadBankFromPresetFiles(bankPresetsEmpty, 0);
 
         return true;
     }
 
-    bool testSideChain()
+    bool testSkippedHostMessages()
     {
-        mod_log_info("testSideChain()");
+        mod_log_info("testSkippedHostMessages()");
 
-        // NOTE: even though this test set is extensive, it doesn't include every possible scenario
-        // focus is on issues that have appeared earlier in development
+        Host& host = connector._host;
 
-        // NOTE: many of the connection checks in between actions are the same within one test
-        // and between test functions but the steps to get there are different
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        const int16_t instance = hostInstanceNumber(connector.getBlockIdNoPair(0, 0));
 
-        assert_return(testSideChainBuiltInOrder(), false);
-        assert_return(testPassthrough(), false);
+        // repeated messages are skipped
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.2f), false);
+        assert_return(hostParamSetSkipped(instance, "gain", 0.2f), false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.3f), false);
 
-        assert_return(testSideChainAddStereoInBetween(), false);
-        assert_return(testPassthrough(), false);
+        Host::SkippedMessages skipped = connector.getSkippedHostMessages();
+        assert_return(host.bypass(instance, true), false);
+        assert_return(host.bypass(instance, true), false);
+        assert_return(connector.getSkippedHostMessages().bypass == skipped.bypass + 1, false);
+        assert_return(host.bypass(instance, false), false);
+        assert_return(connector.getSkippedHostMessages().bypass == skipped.bypass + 1, false);
 
-        assert_return(testSideChainMoveStereoOnFirstRow(), false);
-        assert_return(testPassthrough(), false);
+        assert_return(host.activate(instance, false), false);
+        assert_return(host.activate(instance, false), false);
+        assert_return(connector.getSkippedHostMessages().activate == skipped.activate + 1, false);
+        assert_return(host.activate(instance, true), false);
+        assert_return(connector.getSkippedHostMessages().activate == skipped.activate + 1, false);
 
-        assert_return(testSideChainSwapBlockRows(), false);
-        assert_return(testPassthrough(), false);
+        // values are kept after a non-blocking scope where all messages succeed
+        {
+            const Host::NonBlockingScope hnbs(host);
+            host.param_set(instance, "gain", 0.4f);
+        }
+        assert_return(hostParamSetSkipped(instance, "gain", 0.4f), false);
+
+        // but not if any of them failed, as we cannot know which one it was
+        {
+            const Host::NonBlockingScope hnbs(host);
+            host.param_set(instance, "gain", 0.6f);
+            host.param_set(instance, "nonexisting", 1.f);
+        }
+        assert_return(! host.connection_lost(), false);
+        skipped = connector.getSkippedHostMessages();
+        assert_return(host.bypass(instance, false), false);
+        assert_return(connector.getSkippedHostMessages().bypass == skipped.bypass, false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(hostParamSetSkipped(instance, "gain", 0.6f), false);
+
+        // presets and states change values in ways we cannot follow
+        host.preset_load(instance, PARAMSBLOCK "#nonexisting");
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(hostParamSetSkipped(instance, "gain", 0.6f), false);
+
+        host.state_load(PRESETFILEPATH "/nonexisting-state");
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(hostParamSetSkipped(instance, "gain", 0.6f), false);
+
+        // mapped parameters can be changed by mod-host on its own, so are never skipped
+        assert_return(host.midi_map(instance, "gain", 0, 1, 0.f, 1.f), false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(host.midi_unmap(instance, "gain"), false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(hostParamSetSkipped(instance, "gain", 0.6f), false);
+
+        // mapping is assumed even if mod-host rejects it, which is always the safe choice
+        assert_return(! hostParamSetSkipped(instance, "level", 6.f), false);
+        assert_return(hostParamSetSkipped(instance, "level", 6.f), false);
+        host.cc_map(instance, "level", 0, 0, "Level", 6.f, 0.f, 10.f, 0, 0, "", 0, nullptr);
+        assert_return(! hostParamSetSkipped(instance, "level", 6.f), false);
+        assert_return(! hostParamSetSkipped(instance, "level", 6.f), false);
+
+        host.hmi_map(instance, "gain", 0, 0, 0, 0, 0, "Gain", 0.f, 1.f, 0);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+        assert_return(! hostParamSetSkipped(instance, "gain", 0.6f), false);
+
+        // keep no spare with mapped parameters around for other tests
+        connector.setInstancePoolBudget(0);
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
+        connector.setInstancePoolBudget(MAX_SPARE_PLUGIN_INSTANCES);
+
+        return true;
+    }
+
+    bool testHostReconnect()
+    {
+        mod_log_info("testHostReconnect()");
+
+        assert_return(connector.replaceBlock(0, 0, PARAMSBLOCK), false);
+        connector.setBlockParameter(0, 0, "gain", 0.7f);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 0), "gain"), 0.7f), false);
+
+        // mod-host kept its instances, nothing gets loaded again but lost values are sent again
+        {
+            const std::string blockId = connector.getBlockIdNoPair(0, 0);
+            connector._host.param_set(hostInstanceNumber(blockId), "gain", 0.1f);
+
+            QThread::msleep(200);
+            const uint numUnregistrations = numJackPortUnregistrations;
+
+            connector.ok = false;
+            assert_return(reconnectHost(), false);
+            QThread::msleep(200);
+            assert_return(numJackPortUnregistrations == numUnregistrations, false);
+            assert_return(connector.getBlockIdNoPair(0, 0) == blockId, false);
+            assert_return(isEqual(hostParameterValue(blockId, "gain"), 0.7f), false);
+            assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+            assert_return(testNoPassthrough(), false);
+        }
+
+        // mod-host restarted, known state of its instances must not be used for the new one
+        hostProcess.restart();
+        hostParameterValue(connector.getBlockIdNoPair(0, 0), "gain");
+        assert_return(connector._host.connection_lost(), false);
+        assert_return(reconnectHost(), false);
+        assert_return(! connector._host.connection_lost(), false);
+        assert_return(isEqual(hostParameterValue(connector.getBlockIdNoPair(0, 0), "gain"), 0.7f), false);
+        assert_return(checkOnlyConnection(blockPortIn1(0, 0), JACK_CAPTURE_PORT_1), false);
+        assert_return(testNoPassthrough(), false);
+
+        assert_return(connector.replaceBlock(0, 0, nullptr), false);
 
         return true;
     }
@@ -1776,6 +3495,22 @@ class HostConnectorTests : public QObject
         return checkOnly2Connections(port_to_check, port_1_connected_to.c_str(), port_2_connected_to.c_str());
     }
 
+    bool checkPortExists(std::string port_to_check)
+    {
+        return jack_port_by_name(client, port_to_check.c_str()) != nullptr;
+    }
+
+    // run host updates for some time, so deferred work gets done
+    void runHostUpdates(uint time_ms)
+    {
+        for (uint i = 0; i < time_ms / 50; ++i)
+        {
+            QThread::msleep(50);
+            connector.pollHostUpdates(nullptr);
+            connector.requestHostUpdates();
+        }
+    }
+
     std::string blockPortIn1(uint8_t row, uint8_t block) { return connector.getBlockIdNoPair(row, block) + ":in1"; }
 
     std::string blockPortIn2(uint8_t row, uint8_t block) { return connector.getBlockIdNoPair(row, block) + ":in2"; }
@@ -1792,6 +3527,53 @@ class HostConnectorTests : public QObject
 
     std::string blockPairPortOut2(uint8_t row, uint8_t block) { return connector.getBlockIdPairOnly(row, block) + ":out2"; }
 
+    std::string toolPort(uint8_t toolIndex, const char* symbol)
+    {
+        return format(MOD_HOST_EFFECT_PREFIX "%d:%s", MAX_MOD_HOST_PLUGIN_INSTANCES + toolIndex, symbol);
+    }
+
+    // mod-host instance number of a block, blockId being an instance name like "effect_0"
+    int16_t hostInstanceNumber(const std::string& blockId)
+    {
+        return static_cast<int16_t>(std::atoi(blockId.c_str() + MOD_HOST_EFFECT_PREFIX_LEN));
+    }
+
+    // send a parameter change directly to mod-host, returning true if it was skipped as already set
+    bool hostParamSetSkipped(const int16_t instance, const char* symbol, const float value)
+    {
+        const uint32_t skipped = connector.getSkippedHostMessages().param_set;
+        connector._host.param_set(instance, symbol, value);
+        return connector.getSkippedHostMessages().param_set != skipped;
+    }
+
+    // reconnect to mod-host the same way as on startup, retrying while it is not yet ready
+    bool reconnectHost()
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            if (connector.reconnect())
+                return true;
+
+            QThread::msleep(500);
+        }
+
+        return false;
+    }
+
+    // current value of a block parameter, or -1 if the block does not have it
+    float blockParameterValue(uint8_t row, uint8_t block, const char* symbol)
+    {
+        const HostConnector::Block& blockdata = connector.current.block(row, block);
+        const uint8_t paramIndex = blockdata.parameterIndexForSymbol(symbol);
+        return paramIndex != UINT8_MAX ? blockdata.parameters[paramIndex].value : -1.f;
+    }
+
+    // current value of a block parameter as reported by mod-host, blockId being an instance name like "effect_0"
+    float hostParameterValue(const std::string& blockId, const char* symbol)
+    {
+        return connector._host.param_get(hostInstanceNumber(blockId), symbol);
+    }
+
 private slots:
     void reconnect()
     {
@@ -1848,6 +3630,8 @@ int main(int argc, char* argv[])
     // open and activate jack client
     jack_client_t* const client = jack_client_open("tests", JackNullOption, nullptr);
     assert_return(client != nullptr, 1);
+    assert_return(jack_set_port_connect_callback(client, q_jack_port_connect_callback, nullptr) == 0, 1);
+    assert_return(jack_set_port_registration_callback(client, q_jack_port_registration_callback, nullptr) == 0, 1);
     assert_return(jack_activate(client) == 0, 1);
 
     // start mod-host
@@ -80,6 +80,27 @@ bool path_contains(const std::string& path, const std::string& dir)
         std::strncmp(path.c_str(), dir.c_str(), dir.length()) == 0;
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// write a file through a temporary one that is synced to disk and then renamed over the original
+
+bool safeFileSave(const std::string& filename, const std::string& contents)
+{
+    if (FILE* const fd = std::fopen((filename + ".tmp").c_str(), "w"))
+    {
+        std::fwrite(contents.c_str(), 1, contents.length(), fd);
+        std::fflush(fd);
+       #ifndef _WIN32
+        fsync(fileno(fd));
+        // syncfs(fileno(fd));
+       #endif
+        std::fclose(fd);
+        std::rename((filename + ".tmp").c_str(), filename.c_str());
+        return true;
+    }
+
+    return false;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // utility function that formats a std::string via `vsnprintf`
 
@@ -132,6 +132,12 @@ std::string homedir();
 
 bool path_contains(const std::string& path, const std::string& dir);
 
+// --------------------------------------------------------------------------------------------------------------------
+// write a file through a temporary one that is synced to disk and then renamed over the original,
+// so that readers never see a partially written file
+
+bool safeFileSave(const std::string& filename, const std::string& contents);
+
 // --------------------------------------------------------------------------------------------------------------------
 // utility function that formats a std::string via `vsnprintf`
 
@@ -0,0 +1,3 @@
+#define TESTBLOCK_URN "urn:mod-connector:testmixer"
+
+#include "testblock.c"
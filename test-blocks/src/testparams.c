@@ -0,0 +1,3 @@
+#define TESTBLOCK_URN "urn:mod-connector:testparams"
+
+#include "testblock.c"